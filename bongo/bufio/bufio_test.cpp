@@ -1539,6 +1539,129 @@ TEST_CASE("Bufio Writer size", "[bufio]") {
   CHECK(writer{b, 1234}.size() == 1234);
 }
 
+// Records the ranges it is asked to read ahead.
+class readahead_reader {
+  bytes::reader r_;
+
+ public:
+  std::vector<std::pair<int64_t, long>> calls;
+
+  readahead_reader(std::span<uint8_t const> b)
+      : r_{b} {}
+
+  auto read(std::span<uint8_t> p) -> std::pair<long, std::error_code> { return r_.read(p); }
+  auto seek(int64_t offset, long whence) -> std::pair<int64_t, std::error_code> { return r_.seek(offset, whence); }
+
+  auto readahead(int64_t offset, long count) -> std::error_code {
+    calls.emplace_back(offset, count);
+    return nil;
+  }
+};
+
+TEST_CASE("Bufio Reader readahead", "[bufio]") {
+  auto data = std::vector<uint8_t>(10000, 'x');
+  auto r = readahead_reader{data};
+  r.seek(100, io::seek_start);
+  auto b = reader{r, 1000};
+  b.set_readahead(4000);
+  REQUIRE(r.calls.size() == 1);
+  CHECK(r.calls[0] == std::pair<int64_t, long>{100, 4000});
+
+  // Once half of the window is consumed, only the range past the previous
+  // window is requested
+  auto p = std::vector<uint8_t>(500);
+  for (int i = 0; i < 4; ++i) {
+    b.read(p);
+  }
+  CHECK(r.calls.size() == 1);
+  b.read(p);
+  REQUIRE(r.calls.size() == 2);
+  CHECK(r.calls[1] == std::pair<int64_t, long>{4100, 3000});
+  b.read(p);
+
+  // Large reads bypass the buffer but are counted
+  auto big = std::vector<uint8_t>(3000);
+  b.read(big);
+  REQUIRE(r.calls.size() == 3);
+  CHECK(r.calls[2] == std::pair<int64_t, long>{7100, 3000});
+
+  // Disabled
+  b.set_readahead(0);
+  auto [n, err] = b.read(big);
+  CHECK(n == 3000);
+  CHECK(r.calls.size() == 3);
+
+  // Readers that cannot read ahead are unaffected
+  auto r1 = bytes::reader{data};
+  auto b1 = reader{r1};
+  b1.set_readahead(4000);
+  CHECK(b1.read(p).first == 500);
+}
+
+// Counts calls to the underlying writer.
+class writev_counter {
+  bytes::buffer& buf_;
+
+ public:
+  int writes = 0;
+  int writevs = 0;
+
+  writev_counter(bytes::buffer& buf)
+      : buf_{buf} {}
+
+  auto write(std::span<uint8_t const> p) -> std::pair<long, std::error_code> {
+    ++writes;
+    return buf_.write(p);
+  }
+
+  auto writev(std::span<std::span<uint8_t const> const> v) -> std::pair<long, std::error_code> {
+    ++writevs;
+    return buf_.writev(v);
+  }
+};
+
+TEST_CASE("Bufio Writer writev", "[bufio]") {
+  auto header = bytes::to_bytes("0123456789"sv);
+  auto body = bytes::to_bytes("abcdefghij"sv);
+  auto v = std::array{header, body};
+
+  // Fits in the buffer
+  auto dst = bytes::buffer{};
+  auto c = writev_counter{dst};
+  auto w = writer{c, 32};
+  auto [n, err] = w.writev(v);
+  CHECK(n == 20);
+  CHECK(err == nil);
+  CHECK(w.buffered() == 20);
+  CHECK(c.writes + c.writevs == 0);
+
+  // Buffered data and payload go out in one call
+  std::tie(n, err) = w.writev(v);
+  CHECK(n == 20);
+  CHECK(err == nil);
+  CHECK(w.buffered() == 0);
+  CHECK(c.writes == 0);
+  CHECK(c.writevs == 1);
+  CHECK(dst.str() == "0123456789abcdefghij0123456789abcdefghij");
+
+  // Writers without writev
+  auto dst1 = bytes::buffer{};
+  auto ow = only_writer{dst1};
+  auto w1 = writer{ow, 16};
+  std::tie(n, err) = w1.writev(v);
+  CHECK(n == 20);
+  CHECK(err == nil);
+  CHECK(w1.flush() == nil);
+  CHECK(dst1.str() == "0123456789abcdefghij");
+
+  // Errors are sticky
+  auto ew = error_write_test{0, 1, io::error::closed_pipe};
+  auto w2 = writer{ew, 4};
+  std::tie(n, err) = w2.writev(v);
+  CHECK(err == io::error::closed_pipe);
+  CHECK(w2.writev(v).second == io::error::closed_pipe);
+}
+
 class eof_reader {
   std::vector<uint8_t> data_;
   std::span<uint8_t> buf_;
@@ -3,6 +3,8 @@
 #pragma once
 
 #include <algorithm>
+#include <concepts>
+#include <cstdint>
 #include <memory>
 #include <span>
 #include <system_error>
@@ -17,6 +19,13 @@
 
 namespace bongo::bufio {
 
+// Satisfied by seekable readers that can be asked to start reading a byte
+// range ahead of use, such as os::file.
+template <typename T>
+concept ReadAheader = io::Seeker<T> && requires (T r, int64_t offset, long count) {
+  { r.readahead(offset, count) } -> std::same_as<std::error_code>;
+};
+
 template <typename T> requires io::ReaderFunc<T>
 class reader {
   std::vector<uint8_t> buf_;
@@ -24,6 +33,9 @@ class reader {
   long r_, w_;
   std::error_code err_;
   long last_byte_, last_rune_size_;
+  long readahead_;  // readahead window, or zero
+  int64_t offset_;  // offset of the underlying reader
+  int64_t ahead_;   // end of the range last read ahead
 
   static constexpr long min_read_buffer_size = 16;
   static constexpr long max_consecutive_empty_reads = 100;
@@ -54,6 +66,12 @@ class reader {
   auto read_bytes(uint8_t delim) -> std::pair<std::vector<uint8_t>, std::error_code>;
   auto read_string(uint8_t delim) -> std::pair<std::string, std::error_code>;
 
+  // Asks a ReadAheader to read window bytes past its current offset, and
+  // to keep reading ahead as the reader consumes the first half of each
+  // window. This overlaps reads from a cold page cache with processing.
+  // Has no effect for other readers or if window is zero.
+  auto set_readahead(long window) -> void;
+
   template <typename U> requires io::WriterFunc<U> || io::WriterToFunc<T, U> || io::ReaderFromFunc<U, T>
   auto write_to(U& wr) -> std::pair<int64_t, std::error_code>;
 
@@ -61,6 +79,7 @@ class reader {
   auto to_span() -> std::span<uint8_t>;
   auto read_err() -> std::error_code;
   auto fill() -> void;
+  auto advance(long n) -> void;
   auto collect_fragments(uint8_t delim) -> std::tuple<std::vector<std::vector<uint8_t>>, std::span<uint8_t>, long, std::error_code>;
 
   template <typename U> requires io::WriterFunc<U>
@@ -79,6 +98,25 @@ auto reader<T>::reset(T& rd, long size) -> void {
   err_ = nil;
   last_byte_ = -1;
   last_rune_size_ = -1;
+  readahead_ = 0;
+  offset_ = ahead_ = 0;
+}
+
+template <typename T>
+auto reader<T>::set_readahead(long window) -> void {
+  if constexpr (ReadAheader<T>) {
+    readahead_ = 0;
+    if (window <= 0) {
+      return;
+    }
+    auto [off, err] = rd_->seek(0, io::seek_current);
+    if (err != nil) {
+      return;
+    }
+    readahead_ = window;
+    offset_ = ahead_ = off;
+    advance(0);
+  }
 }
 
 template <typename T>
@@ -162,6 +200,7 @@ auto reader<T>::read(std::span<uint8_t> p) -> std::pair<long, std::error_code> {
       if (n < 0) {
         throw std::system_error{error::negative_read};
       }
+      advance(n);
       if (n > 0) {
         last_byte_ = static_cast<long>(p[n-1]);
         last_rune_size_ = -1;
@@ -173,6 +212,7 @@ auto reader<T>::read(std::span<uint8_t> p) -> std::pair<long, std::error_code> {
     if (n < 0) {
       throw std::system_error{error::negative_read};
     }
+    advance(n);
     if (n == 0) {
       return {0, read_err()};
     }
@@ -425,6 +465,7 @@ auto reader<T>::fill() -> void {
     if (n < 0) {
       throw std::system_error{error::negative_read};
     }
+    advance(n);
     w_ += n;
     if (err != nil) {
       err_ = err;
@@ -437,6 +478,23 @@ auto reader<T>::fill() -> void {
   err_ = io::error::no_progress;
 }
 
+template <typename T>
+auto reader<T>::advance(long n) -> void {
+  if constexpr (ReadAheader<T>) {
+    if (readahead_ == 0) {
+      return;
+    }
+    offset_ += n;
+    if (ahead_ - offset_ < readahead_/2) {
+      // Only request the part of the window not already read ahead.
+      // Errors are ignored, this is only a hint
+      auto start = std::max(ahead_, offset_);
+      rd_->readahead(start, static_cast<long>(offset_ + readahead_ - start));
+      ahead_ = offset_ + readahead_;
+    }
+  }
+}
+
 template <typename T>
 auto reader<T>::collect_fragments(uint8_t delim) -> std::tuple<std::vector<std::vector<uint8_t>>, std::span<uint8_t>, long, std::error_code> {
   std::vector<std::vector<uint8_t>> full_buffers;
@@ -7,6 +7,7 @@
 #include <string_view>
 #include <system_error>
 #include <utility>
+#include <vector>
 
 #include <bongo/bufio/error.h>
 #include <bongo/io.h>
@@ -43,6 +44,7 @@ class writer {
   auto write_byte(uint8_t c) -> std::error_code;
   auto write_rune(rune c) -> std::pair<long, std::error_code>;
   auto write_string(std::string_view s) -> std::pair<long, std::error_code>;
+  auto writev(std::span<std::span<uint8_t const> const> v) -> std::pair<long, std::error_code>;
 
   template <typename U> requires io::ReaderFunc<U>
   auto read_from(U& r) -> std::pair<int64_t, std::error_code>;
@@ -117,6 +119,53 @@ auto writer<T>::write(std::span<uint8_t const> p) -> std::pair<long, std::error_
   return {nn, nil};
 }
 
+// Writes the buffers in order. Data that does not fit in the buffer is
+// written together with the buffered data in a single writev call when the
+// underlying writer implements io::WriterV, instead of flushing first.
+template <typename T>
+auto writer<T>::writev(std::span<std::span<uint8_t const> const> v) -> std::pair<long, std::error_code> {
+  if (err_ != nil) {
+    return {0, err_};
+  }
+  long total = 0;
+  for (auto p : v) {
+    total += p.size();
+  }
+  if constexpr (io::WriterV<T>) {
+    if (total > available()) {
+      auto iov = std::vector<std::span<uint8_t const>>{};
+      iov.reserve(v.size() + 1);
+      iov.emplace_back(buf_.data(), static_cast<size_t>(n_));
+      iov.insert(iov.end(), v.begin(), v.end());
+      auto [n, err] = wr_->writev(iov);
+      if (n < n_ + total && err == nil) {
+        err = io::error::short_write;
+      }
+      if (n < n_) {
+        if (n > 0) {
+          std::copy(std::next(buf_.begin(), n), std::next(buf_.begin(), n_), buf_.begin());
+        }
+        n_ -= n;
+        err_ = err;
+        return {0, err};
+      }
+      n -= n_;
+      n_ = 0;
+      err_ = err;
+      return {n, err};
+    }
+  }
+  long nn = 0;
+  for (auto p : v) {
+    auto [n, err] = write(p);
+    nn += n;
+    if (err != nil) {
+      return {nn, err};
+    }
+  }
+  return {nn, nil};
+}
+
 template <typename T>
 auto writer<T>::write_byte(uint8_t c) -> std::error_code {
   if (err_ != nil) {
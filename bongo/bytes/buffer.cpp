@@ -200,6 +200,21 @@ std::pair<long, std::error_code> buffer::write_rune(rune r) {
   return {n, nil};
 }
 
+std::pair<long, std::error_code> buffer::writev(std::span<std::span<uint8_t const> const> v) {
+  last_read_ = read_op::invalid;
+  long n = 0;
+  for (auto p : v) {
+    n += p.size();
+  }
+  auto m = grow(n);
+  for (auto p : v) {
+    std::copy(p.begin(), p.end(), buf_+m);
+    m += p.size();
+  }
+  size_ += n;
+  return {n, nil};
+}
+
 std::pair<long, std::error_code> buffer::read(std::span<uint8_t> p) noexcept {
   last_read_ = read_op::invalid;
   if (empty()) {
@@ -219,6 +234,33 @@ std::pair<long, std::error_code> buffer::read(std::span<uint8_t> p) noexcept {
   return {n, nil};
 }
 
+std::pair<long, std::error_code> buffer::readv(std::span<std::span<uint8_t> const> v) noexcept {
+  last_read_ = read_op::invalid;
+  long total = 0;
+  for (auto p : v) {
+    total += p.size();
+  }
+  if (empty()) {
+    reset();
+    if (total == 0) {
+      return {0, nil};
+    }
+    return {0, io::eof};
+  }
+  long n = 0;
+  for (auto p : v) {
+    auto m = std::min(size_, static_cast<long>(p.size()));
+    std::copy(begin(), std::next(begin(), m), p.begin());
+    off_ += m;
+    size_ -= m;
+    n += m;
+  }
+  if (n > 0) {
+    last_read_ = read_op::read;
+  }
+  return {n, nil};
+}
+
 std::pair<uint8_t, std::error_code> buffer::read_byte() noexcept {
   if (empty()) {
     reset();
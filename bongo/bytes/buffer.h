@@ -65,7 +65,9 @@ class buffer {
   auto write_string(std::string_view s) -> std::pair<long, std::error_code>;
   auto write_byte(uint8_t b) noexcept -> std::error_code;
   auto write_rune(rune r) -> std::pair<long, std::error_code>;
+  auto writev(std::span<std::span<uint8_t const> const> v) -> std::pair<long, std::error_code>;
   auto read(std::span<uint8_t> p) noexcept -> std::pair<long, std::error_code>;
+  auto readv(std::span<std::span<uint8_t> const> v) noexcept -> std::pair<long, std::error_code>;
   auto read_byte() noexcept -> std::pair<uint8_t, std::error_code>;
   auto read_rune() noexcept -> std::tuple<rune, long, std::error_code>;
   auto unread_byte() noexcept -> std::error_code;
@@ -3,9 +3,12 @@
 #include <catch2/catch.hpp>
 
 #include <algorithm>
+#include <array>
 #include <random>
 #include <string>
 #include <string_view>
+#include <tuple>
+#include <vector>
 
 #include "bongo/bytes.h"
 #include "bongo/unicode/utf8.h"
@@ -408,6 +411,33 @@ TEST_CASE("Buffer read empty at EOF", "[bytes]") {
   CHECK(n == 0);
 }
 
+TEST_CASE("Buffer readv and writev", "[bytes]") {
+  auto b = buffer{};
+  auto header = std::string_view{"head:"};
+  auto body = std::string_view{"body"};
+  auto v = std::array{bytes::to_bytes(header), std::span<uint8_t const>{}, bytes::to_bytes(body)};
+  auto [n, err] = b.writev(v);
+  CHECK(n == 9);
+  CHECK(err == nil);
+  CHECK(b.str() == "head:body");
+
+  auto b1 = std::vector<uint8_t>(3);
+  auto b2 = std::vector<uint8_t>(4);
+  auto r = std::array{std::span{b1}, std::span{b2}};
+  std::tie(n, err) = b.readv(r);
+  CHECK(n == 7);
+  CHECK(err == nil);
+  CHECK(bytes::to_string(b1) == "hea");
+  CHECK(bytes::to_string(b2) == "d:bo");
+  std::tie(n, err) = b.readv(r);
+  CHECK(n == 2);
+  CHECK(err == nil);
+  CHECK(bytes::to_string(b1, 2) == "dy");
+  std::tie(n, err) = b.readv(r);
+  CHECK(n == 0);
+  CHECK(err == io::eof);
+}
+
 TEST_CASE("Buffer unread byte", "[bytes]") {
   auto b = buffer{};
 
@@ -46,11 +46,11 @@ std::pair<int64_t, std::error_code> reader::write_to(Writer& w) {
   }
   auto s = std::span{std::next(s_.begin(), i_), s_.end()};
   auto [m, err] = io::write(w, s);
-  if (static_cast<size_t>(m) > s_.size()) {
+  if (static_cast<size_t>(m) > s.size()) {
     throw std::runtime_error{"bytes::reader::write_to: invalid write_string count"};
   }
   i_ += m;
-  if (static_cast<size_t>(m) != s_.size() && err == nil) {
+  if (static_cast<size_t>(m) != s.size() && err == nil) {
     err = io::error::short_write;
   }
   return {m, err};
@@ -80,6 +80,17 @@ TEST_CASE("Byte reader write_to", "[bytes]") {
   }
 }
 
+TEST_CASE("Byte reader write_to after read", "[bytes]") {
+  auto r = reader{to_bytes("0123456789"sv)};
+  auto p = std::vector<uint8_t>(3);
+  r.read(p);
+  auto b = bytes::buffer{};
+  auto [n, err] = r.write_to(b);
+  CHECK(n == 7);
+  CHECK(err == nil);
+  CHECK(b.str() == "3456789");
+}
+
 TEST_CASE("Byte reader size/total_size", "[bytes]") {
   auto r = reader{to_bytes("abc"sv)};
   auto w = io::discard{};
@@ -57,7 +57,14 @@ void cancel_context::cancel(bool remove, std::error_code err) {
 }
 
 void cancel_context::add(context* child) {
-  std::lock_guard lock{mutex_};
+  std::unique_lock lock{mutex_};
+  if (err_ != nil) {
+    // Parent has already been canceled
+    auto err = err_;
+    lock.unlock();
+    child->cancel(false, err);
+    return;
+  }
   children_.insert(child);
 }
 
@@ -98,6 +105,27 @@ void value_context::remove(context* child) {
   parent_->remove(child);
 }
 
+after_func_context::~after_func_context() {
+  parent_->remove(this);
+}
+
+void after_func_context::start() {
+  parent_->add(this);
+}
+
+bool after_func_context::stop() {
+  // Removing this context from the parent synchronizes with a concurrent
+  // cancelation, after which fn_ has either run to completion or never will.
+  parent_->remove(this);
+  return !done_.exchange(true);
+}
+
+void after_func_context::cancel(bool, std::error_code) {
+  if (!done_.exchange(true)) {
+    fn_();
+  }
+}
+
 context_type background() {
   static context_type ctx = std::make_shared<context>();
   return ctx;
@@ -113,6 +141,12 @@ cancelable_context with_cancel(context_type parent) {
   return std::make_pair(ctx, [ctx]() { ctx->cancel(); });
 }
 
+std::function<bool()> after_func(context_type ctx, std::function<void()> fn) {
+  auto a = std::make_shared<after_func_context>(std::move(ctx), std::move(fn));
+  a->start();
+  return [a]() { return a->stop(); };
+}
+
 context_type with_value(context_type parent, std::string value, std::any key) {
   return std::make_shared<value_context>(std::move(parent), std::move(value), std::move(key));
 }
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <any>
+#include <atomic>
 #include <chrono>
 #include <exception>
 #include <functional>
@@ -91,6 +92,22 @@ class value_context : public context {
   void remove(context* child) override;
 };
 
+class after_func_context : public context {
+  context_type parent_;
+  std::function<void()> fn_;
+  std::atomic_bool done_ = false;
+
+ public:
+  after_func_context(context_type parent, std::function<void()> fn)
+      : parent_{std::move(parent)}
+      , fn_{std::move(fn)} {}
+  ~after_func_context();
+
+  void start();
+  bool stop();
+  void cancel(bool remove, std::error_code err) override;
+};
+
 /**
  * Background is an empty top-level context.
  *
@@ -119,6 +136,22 @@ cancelable_context with_cancel(context_type parent);
  */
 context_type with_value(context_type parent, std::string value, std::any key);
 
+/**
+ * Arrange to call \p fn once \p ctx is done.
+ *
+ * The function is called on the thread that cancels \p ctx, while the
+ * context tree is locked, so it should be short and must not call back into
+ * \p ctx. If \p ctx is already done \p fn is called immediately.
+ *
+ * The returned stop function disassociates \p fn from \p ctx. It returns
+ * true if the call was stopped and false if \p fn has already run (or is
+ * not going to run). Once stop returns \p fn is guaranteed to have
+ * completed. Destroying every copy of the stop function also stops the call.
+ *
+ * - https://pkg.go.dev/context#AfterFunc
+ */
+std::function<bool()> after_func(context_type ctx, std::function<void()> fn);
+
 /**
  * Deadline contexts automatically cancel after the specified duration.
  *
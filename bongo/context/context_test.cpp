@@ -340,4 +340,81 @@ TEST_CASE("Child does not cancel parent", "[context]") {
   check(ctx);
 }
 
+TEST_CASE("Canceled parent cancels new child", "[context]") {
+  auto [parent, cancel] = with_cancel(background());
+  cancel();
+  auto child = std::get<0>(with_cancel(parent));
+  std::optional<std::monostate> v;
+  switch (select({
+    recv_select_case(child->done(), v),
+    default_select_case(),
+  })) {
+  case 0:
+    break;
+  default:
+    FAIL_CHECK("child of canceled parent should not block");
+  }
+  REQUIRE(child->err() == error::canceled);
+}
+
+TEST_CASE("After func", "[context]") {
+  SECTION("Called on cancel") {
+    auto [ctx, cancel] = with_cancel(background());
+    auto calls = 0;
+    auto stop = after_func(ctx, [&]() { ++calls; });
+    CHECK(calls == 0);
+    cancel();
+    CHECK(calls == 1);
+    cancel();
+    CHECK(calls == 1);
+    CHECK(stop() == false);
+  }
+  SECTION("Called through a value context") {
+    auto [parent, cancel] = with_cancel(background());
+    auto ctx = with_value(parent, "key"s, "value"s);
+    auto calls = 0;
+    auto stop = after_func(ctx, [&]() { ++calls; });
+    cancel();
+    CHECK(calls == 1);
+    CHECK(stop() == false);
+  }
+  SECTION("Already canceled") {
+    auto [ctx, cancel] = with_cancel(background());
+    cancel();
+    auto calls = 0;
+    auto stop = after_func(ctx, [&]() { ++calls; });
+    CHECK(calls == 1);
+    CHECK(stop() == false);
+  }
+  SECTION("Stopped") {
+    auto [ctx, cancel] = with_cancel(background());
+    auto calls = 0;
+    auto stop = after_func(ctx, [&]() { ++calls; });
+    CHECK(stop() == true);
+    CHECK(stop() == false);
+    cancel();
+    CHECK(calls == 0);
+  }
+  SECTION("Stop function destroyed") {
+    auto [ctx, cancel] = with_cancel(background());
+    auto calls = 0;
+    {
+      auto stop = after_func(ctx, [&]() { ++calls; });
+    }
+    cancel();
+    CHECK(calls == 0);
+  }
+  SECTION("Timeout") {
+    auto [ctx, cancel] = with_timeout(background(), 1ms);
+    auto c = chan<bool>{1};
+    auto stop = after_func(ctx, [&c]() { c << true; });
+    bool called;
+    called << c;
+    CHECK(called == true);
+    CHECK(ctx->err() == error::deadline_exceeded);
+    CHECK(stop() == false);
+    cancel();
+  }
+}
+
 }  // namespace bongo::context
@@ -15,6 +15,12 @@ struct error_category : std::error_category {
       return "use of closed file";
     case error::net_closing:
       return "use of closed network connection";
+    case error::no_deadline:
+      return "file type does not support deadline";
+    case error::deadline_exceeded:
+      return "i/o timeout";
+    case error::not_pollable:
+      return "not pollable";
     default:
       return "unrecognized error";
     }
@@ -9,6 +9,9 @@ namespace bongo::detail::poll {
 enum class error {
   file_closing = 10,
   net_closing,
+  no_deadline,
+  deadline_exceeded,
+  not_pollable,
 };
 
 std::error_code make_error_code(error e);
@@ -2,17 +2,40 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <semaphore>
 #include <stdexcept>
 
+#include <bongo/runtime/sema.h>
+
 namespace bongo::detail::poll {
 
+// Contention counters of an fd_mutex. They are only updated on contended
+// paths, so an uncontended descriptor pays nothing for them.
+struct fd_mutex_stats {
+  uint64_t cas_retries = 0;     // failed compare-and-swaps of the state
+  uint64_t spin_acquires = 0;   // read or write locks taken after spinning
+  uint64_t sema_waits = 0;      // times a locker blocked on a semaphore
+  std::chrono::nanoseconds wait_time{0};  // total time spent blocked
+};
+
 class fd_mutex {
   std::atomic<uint64_t> state_ = 0;
   std::binary_semaphore rsema_{0};
   std::binary_semaphore wsema_{0};
 
+  // Running estimate of the spin iterations needed to take the read or
+  // write lock, as in glibc's adaptive mutexes.
+  std::atomic<int> spins_ = 0;
+
+  std::atomic<uint64_t> cas_retries_ = 0;
+  std::atomic<uint64_t> spin_acquires_ = 0;
+  std::atomic<uint64_t> sema_waits_ = 0;
+  std::atomic<int64_t> wait_ns_ = 0;
+
  public:
   fd_mutex() = default;
   bool incref();
@@ -20,8 +43,16 @@ class fd_mutex {
   bool decref();
   bool rwlock(bool read);
   bool rwunlock(bool read);
+  fd_mutex_stats stats() const noexcept;
+
+ private:
+  bool spin(uint64_t mutex_bit);
+  void cas_failed() noexcept { cas_retries_.fetch_add(1, std::memory_order_relaxed); }
 };
 
+// Upper bound on spin iterations before a locker blocks on the semaphore.
+constexpr static int mutex_max_spins = 100;
+
 constexpr static uint64_t mutex_closed   = 1llu << 0;
 constexpr static uint64_t mutex_rlock    = 1llu << 1;
 constexpr static uint64_t mutex_wlock    = 1llu << 2;
@@ -50,6 +81,7 @@ inline bool fd_mutex::incref() {
     if (state_.compare_exchange_strong(old, next)) {
       return true;
     }
+    cas_failed();
   }
 }
 
@@ -75,6 +107,7 @@ inline bool fd_mutex::incref_and_close() {
       }
       return true;
     }
+    cas_failed();
   }
 }
 
@@ -88,6 +121,7 @@ inline bool fd_mutex::decref() {
     if (state_.compare_exchange_strong(old, next)) {
       return (next&(mutex_closed|mutex_ref_mask)) == mutex_closed;
     }
+    cas_failed();
   }
 }
 
@@ -105,11 +139,20 @@ inline bool fd_mutex::rwlock(bool read) {
     mutex_mask = mutex_wmask;
     mutex_sema = &wsema_;
   }
+  auto spun = false;
+  auto spin_won = false;
   for (;;) {
     auto old = state_.load();
     if ((old&mutex_closed) != 0) {
       return false;
     }
+    if ((old&mutex_bit) != 0 && !spun) {
+      // The lock is usually held only for a single system call, so wait
+      // briefly for it to be released before queueing on the semaphore.
+      spun = true;
+      spin_won = spin(mutex_bit);
+      continue;
+    }
     uint64_t next = 0;
     if ((old&mutex_bit) == 0) {
       next = (old | mutex_bit) + mutex_ref;
@@ -124,9 +167,19 @@ inline bool fd_mutex::rwlock(bool read) {
     }
     if (state_.compare_exchange_strong(old, next)) {
       if ((old&mutex_bit) == 0) {
+        if (spin_won) {
+          spin_acquires_.fetch_add(1, std::memory_order_relaxed);
+        }
         return true;
       }
+      spin_won = false;
+      sema_waits_.fetch_add(1, std::memory_order_relaxed);
+      auto start = std::chrono::steady_clock::now();
       mutex_sema->acquire();
+      auto waited = std::chrono::steady_clock::now() - start;
+      wait_ns_.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count(), std::memory_order_relaxed);
+    } else {
+      cas_failed();
     }
   }
 }
@@ -160,7 +213,38 @@ inline bool fd_mutex::rwunlock(bool read) {
       }
       return (next&(mutex_closed|mutex_ref_mask)) == mutex_closed;
     }
+    cas_failed();
+  }
+}
+
+// Spins until the lock bit is released or the descriptor is closed. Returns
+// false if the spin budget ran out, or if spinning is pointless because
+// there is only one CPU. The budget adapts to how long the lock is usually
+// held.
+inline bool fd_mutex::spin(uint64_t mutex_bit) {
+  if (!runtime::can_spin(0)) {
+    return false;
+  }
+  auto estimate = spins_.load(std::memory_order_relaxed);
+  auto limit = std::min(estimate*2 + 10, mutex_max_spins);
+  auto n = 0;
+  for (; n < limit; ++n) {
+    runtime::procyield(1);
+    if ((state_.load(std::memory_order_relaxed)&(mutex_bit|mutex_closed)) != mutex_bit) {
+      break;
+    }
   }
+  spins_.store(estimate + (n - estimate)/8, std::memory_order_relaxed);
+  return n < limit;
+}
+
+inline fd_mutex_stats fd_mutex::stats() const noexcept {
+  return fd_mutex_stats{
+    .cas_retries = cas_retries_.load(std::memory_order_relaxed),
+    .spin_acquires = spin_acquires_.load(std::memory_order_relaxed),
+    .sema_waits = sema_waits_.load(std::memory_order_relaxed),
+    .wait_time = std::chrono::nanoseconds{wait_ns_.load(std::memory_order_relaxed)},
+  };
 }
 
 }  // namespace bongo::detail::poll
@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <random>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -216,4 +217,94 @@ TEST_CASE("FD mutex stress", "[detail/poll]") {
   REQUIRE(mu.decref() == true);
 }
 
+TEST_CASE("FD mutex stats", "[detail/poll]") {
+  auto mu = fd_mutex{};
+  auto s = mu.stats();
+  CHECK(s.cas_retries == 0);
+  CHECK(s.sema_waits == 0);
+
+  // An uncontended lock counts nothing.
+  mu.rwlock(false);
+  mu.rwunlock(false);
+  CHECK(mu.stats().sema_waits == 0);
+
+  // A waiter that cannot spin through a long hold blocks and records the
+  // time it waited.
+  REQUIRE(mu.rwlock(false));
+  auto t = std::thread{[&]() {
+    REQUIRE(mu.rwlock(false));
+    mu.rwunlock(false);
+  }};
+  std::this_thread::sleep_for(20ms);
+  mu.rwunlock(false);
+  t.join();
+  s = mu.stats();
+  CHECK(s.sema_waits == 1);
+  CHECK(s.wait_time >= 10ms);
+  CHECK(s.spin_acquires == 0);
+}
+
+TEST_CASE("FD mutex stats under contention", "[detail/poll]") {
+  // Each holder sleeps with the write lock held, longer than a waiter
+  // spins, so the other threads have to block.
+  constexpr int P = 4;
+  constexpr int N = 50;
+  auto mu = fd_mutex{};
+  long count = 0;
+  std::vector<std::thread> threads;
+  for (auto p = 0; p < P; ++p) {
+    threads.emplace_back([&]() {
+      for (auto i = 0; i < N; ++i) {
+        mu.rwlock(false);
+        ++count;
+        std::this_thread::sleep_for(100us);
+        mu.rwunlock(false);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  CHECK(count == P * N);
+  auto s = mu.stats();
+  CHECK(s.sema_waits > 0);
+  CHECK(s.sema_waits + s.spin_acquires <= static_cast<uint64_t>(P * N));
+  CHECK(s.wait_time > 0ns);
+
+  // Counters only grow, and an uncontended lock adds nothing.
+  mu.rwlock(false);
+  mu.rwunlock(false);
+  auto s1 = mu.stats();
+  CHECK(s1.sema_waits == s.sema_waits);
+  CHECK(s1.spin_acquires == s.spin_acquires);
+  CHECK(s1.wait_time == s.wait_time);
+}
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+TEST_CASE("FD mutex benchmarks", "[!benchmark]") {
+  // Every thread takes and releases the write lock, as concurrent writers
+  // to a single socket do.
+  constexpr int N = 1000;
+  for (auto P : {2, 4, 8, 16, 32}) {
+    auto mu = fd_mutex{};
+    BENCHMARK("Write lock, " + std::to_string(P) + " threads") {
+      std::vector<std::thread> threads;
+      for (auto p = 0; p < P; ++p) {
+        threads.emplace_back([&]() {
+          for (auto i = 0; i < N; ++i) {
+            mu.rwlock(false);
+            mu.rwunlock(false);
+          }
+        });
+      }
+      for (auto& t : threads) {
+        t.join();
+      }
+    };
+  }
+}
+
+#endif  // defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
 }  // namespace bongo::detail::poll
@@ -0,0 +1,123 @@
+// Copyright The Go Authors.
+
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include "bongo/bongo.h"
+#include "bongo/detail/poll/error.h"
+#include "bongo/detail/poll/fd_poll_runtime.h"
+#include "bongo/detail/poll/fd_unix.h"
+#include "bongo/runtime/nanotime.h"
+#include "bongo/runtime/netpoll.h"
+
+namespace bongo::detail::poll {
+namespace {
+
+std::error_code convert_err(int res, bool is_file) {
+  switch (res) {
+  case runtime::poll_no_error:
+    return nil;
+  case runtime::poll_err_closing:
+    return error_closing(is_file);
+  case runtime::poll_err_timeout:
+    return error::deadline_exceeded;
+  case runtime::poll_err_not_pollable:
+    return error::not_pollable;
+  default:
+    throw std::logic_error{"unreachable: " + std::to_string(res)};
+  }
+}
+
+}  // namespace
+
+int64_t runtime_nano(std::chrono::system_clock::time_point t) {
+  if (t == std::chrono::system_clock::time_point{}) {
+    return 0;
+  }
+  auto d = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      t - std::chrono::system_clock::now()).count();
+  if (d <= 0) {
+    return -1;
+  }
+  return runtime::nanotime() + d;
+}
+
+std::error_code poll_desc::init(int sysfd) {
+  auto [ctx, errno_] = runtime::poll_open(static_cast<uintptr_t>(sysfd));
+  if (errno_ != 0) {
+    return std::error_code{errno_, std::system_category()};
+  }
+  runtime_ctx_ = ctx;
+  return nil;
+}
+
+void poll_desc::close() {
+  if (runtime_ctx_ == nullptr) {
+    return;
+  }
+  runtime::poll_close(runtime_ctx_);
+  runtime_ctx_ = nullptr;
+}
+
+void poll_desc::evict() {
+  if (runtime_ctx_ == nullptr) {
+    return;
+  }
+  runtime::poll_unblock(runtime_ctx_);
+}
+
+std::error_code poll_desc::prepare(int mode, bool is_file) {
+  if (runtime_ctx_ == nullptr) {
+    return nil;
+  }
+  return convert_err(runtime::poll_reset(runtime_ctx_, mode), is_file);
+}
+
+std::error_code poll_desc::wait(int mode, bool is_file) {
+  if (runtime_ctx_ == nullptr) {
+    return error::not_pollable;
+  }
+  return convert_err(runtime::poll_wait(runtime_ctx_, mode), is_file);
+}
+
+void poll_desc::set_deadline(int64_t d, int mode) {
+  if (runtime_ctx_ != nullptr) {
+    runtime::poll_set_deadline(runtime_ctx_, d, mode);
+  }
+}
+
+std::error_code fd::set_deadline(std::chrono::system_clock::time_point t) {
+  return set_deadline_impl(t, 'r'+'w');
+}
+
+std::error_code fd::set_read_deadline(std::chrono::system_clock::time_point t) {
+  return set_deadline_impl(t, 'r');
+}
+
+std::error_code fd::set_write_deadline(std::chrono::system_clock::time_point t) {
+  return set_deadline_impl(t, 'w');
+}
+
+std::error_code fd::set_deadline_impl(std::chrono::system_clock::time_point t, int mode) {
+  if (auto err = incref(); err) {
+    return err;
+  }
+  auto _ = runtime::defer([this]() { decref(); });
+  if (!pd_.pollable()) {
+    return error::no_deadline;
+  }
+  auto d = runtime_nano(t);
+  if (mode == 'r' || mode == 'r'+'w') {
+    read_deadline_.store(d);
+  }
+  if (mode == 'w' || mode == 'r'+'w') {
+    write_deadline_.store(d);
+  }
+  pd_.set_deadline(d, mode);
+  return nil;
+}
+
+}  // namespace bongo::detail::poll
@@ -0,0 +1,38 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <system_error>
+
+#include <bongo/runtime/netpoll.h>
+
+namespace bongo::detail::poll {
+
+// Converts a deadline on the system clock into runtime nanotime. A default
+// constructed time point means no deadline.
+int64_t runtime_nano(std::chrono::system_clock::time_point t);
+
+class poll_desc {
+  runtime::poll_desc* runtime_ctx_ = nullptr;
+
+ public:
+  poll_desc() = default;
+  poll_desc(poll_desc const& other) = delete;
+  poll_desc& operator=(poll_desc const& other) = delete;
+
+  std::error_code init(int sysfd);
+  void close();
+  void evict();
+  std::error_code prepare(int mode, bool is_file);
+  std::error_code prepare_read(bool is_file) { return prepare('r', is_file); }
+  std::error_code prepare_write(bool is_file) { return prepare('w', is_file); }
+  std::error_code wait(int mode, bool is_file);
+  std::error_code wait_read(bool is_file) { return wait('r', is_file); }
+  std::error_code wait_write(bool is_file) { return wait('w', is_file); }
+  void set_deadline(int64_t d, int mode);
+  bool pollable() const noexcept { return runtime_ctx_ != nullptr; }
+};
+
+}  // namespace bongo::detail::poll
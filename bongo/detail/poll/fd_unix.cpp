@@ -1,20 +1,27 @@
 // Copyright The Go Authors.
 
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <chrono>
 #include <memory>
+#include <span>
 #include <string_view>
 #include <system_error>
+#include <utility>
+#include <vector>
 
 #include "bongo/bongo.h"
+#include "bongo/context.h"
 #include "bongo/detail/poll/error.h"
 #include "bongo/detail/poll/fd_mutex.h"
+#include "bongo/detail/poll/fd_poll_runtime.h"
 #include "bongo/detail/poll/fd_unix.h"
 #include "bongo/detail/poll/hook_unix.h"
+#include "bongo/io/error.h"
+#include "bongo/runtime/uring.h"
 #include "bongo/syscall.h"
 
-#if defined(__linux__)
-#include "bongo/runtime/netpoll_epoll.h"
-#endif
-
 namespace bongo::detail::poll {
 namespace {
 
@@ -28,6 +35,40 @@ std::error_code ignoring_interrupted(Fn fn) {
   }
 }
 
+template <typename Fn>
+std::pair<long, std::error_code> ignoring_eintr_io(Fn fn) {
+  for (;;) {
+    auto [n, err] = fn();
+    if (err != std::errc::interrupted) {
+      return {n, err};
+    }
+  }
+}
+
+// Maximum size of a single read or write on a stream. Linux returns EINVAL
+// for sizes larger than this on some file systems.
+constexpr static long max_rw = 1 << 30;
+
+// Maximum number of buffers passed to a single readv or writev. This is
+// IOV_MAX on Linux.
+constexpr static size_t max_iovecs = 1024;
+
+// Positional I/O goes through io_uring when it is enabled, see
+// runtime/uring.h.
+std::pair<long, std::error_code> sys_pread(int fd, std::span<uint8_t> p, int64_t off) {
+  if (runtime::uring_enabled()) {
+    return runtime::uring_pread(fd, p, off);
+  }
+  return syscall::pread(fd, p, off);
+}
+
+std::pair<long, std::error_code> sys_pwrite(int fd, std::span<uint8_t const> p, int64_t off) {
+  if (runtime::uring_enabled()) {
+    return runtime::uring_pwrite(fd, p, off);
+  }
+  return syscall::pwrite(fd, p, off);
+}
+
 }  // namespace
 
 std::error_code fd::init(std::string_view net, bool pollable) {
@@ -38,24 +79,19 @@ std::error_code fd::init(std::string_view net, bool pollable) {
     is_blocking_ = true;
     return nil;
   }
-#if 0
-  auto err = pd_.init(fd_);
+  auto err = pd_.init(sysfd);
   if (err) {
     // If the runtime poller could not be initialized assume blocking mode.
     is_blocking_ = true;
   }
   return err;
-#endif
-  return nil;
 }
 
 std::error_code fd::close() {
   if (!fdmu_.incref_and_close()) {
     return error_closing(is_file_);
   }
-#if 0
   pd_.evict();
-#endif
   auto err = decref();
   if (is_blocking_) {
     csema_.acquire();
@@ -64,9 +100,7 @@ std::error_code fd::close() {
 }
 
 std::error_code fd::destroy() {
-#if 0
   pd_.close();
-#endif
   auto err = close_func(sysfd);
   sysfd = -1;
   csema_.release();
@@ -83,6 +117,504 @@ std::error_code fd::fstat(struct ::stat* s) {
   });
 }
 
+std::error_code fd::fsync() {
+  if (auto err = incref(); err) {
+    return err;
+  }
+  auto _ = runtime::defer([this]() { decref(); });
+  return ignoring_interrupted([&]() {
+    return syscall::fsync(sysfd);
+  });
+}
+
+std::error_code fd::ftruncate(int64_t size) {
+  if (auto err = incref(); err) {
+    return err;
+  }
+  auto _ = runtime::defer([this]() { decref(); });
+  return ignoring_interrupted([&]() {
+    return syscall::ftruncate(sysfd, size);
+  });
+}
+
+std::error_code fd::fadvise(int64_t offset, int64_t len, int advice) {
+  if (auto err = incref(); err) {
+    return err;
+  }
+  auto _ = runtime::defer([this]() { decref(); });
+  return syscall::fadvise(sysfd, offset, len, advice);
+}
+
+std::error_code fd::readahead(int64_t offset, long count) {
+  if (auto err = incref(); err) {
+    return err;
+  }
+  auto _ = runtime::defer([this]() { decref(); });
+  return syscall::readahead(sysfd, offset, count);
+}
+
+std::error_code fd::shutdown(int how) {
+  if (auto err = incref(); err) {
+    return err;
+  }
+  auto _ = runtime::defer([this]() { decref(); });
+  return syscall::shutdown(sysfd, how);
+}
+
+std::error_code fd::setsockopt_int(int level, int opt, int value) {
+  if (auto err = incref(); err) {
+    return err;
+  }
+  auto _ = runtime::defer([this]() { decref(); });
+  return syscall::setsockopt_int(sysfd, level, opt, value);
+}
+
+std::pair<long, std::error_code> fd::read(std::span<uint8_t> p) {
+  if (auto err = read_lock(); err) {
+    return {0, err};
+  }
+  auto _ = runtime::defer([this]() { read_unlock(); });
+  return read_locked(p);
+}
+
+std::pair<long, std::error_code> fd::read_locked(std::span<uint8_t> p) {
+  if (p.size() == 0) {
+    // If the caller wanted a zero byte read, return immediately without
+    // trying to read.
+    return {0, nil};
+  }
+  if (auto err = pd_.prepare_read(is_file_); err) {
+    return {0, err};
+  }
+  if (is_stream && p.size() > max_rw) {
+    p = p.subspan(0, max_rw);
+  }
+  for (;;) {
+    auto [n, err] = ignoring_eintr_io([&]() {
+      return syscall::read(sysfd, p);
+    });
+    if (err) {
+      n = 0;
+      if (err == std::errc::resource_unavailable_try_again && pd_.pollable()) {
+        if (err = pd_.wait_read(is_file_); !err) {
+          continue;
+        }
+      }
+    }
+    return {n, eof_error(n, err)};
+  }
+}
+
+std::pair<long, std::error_code> fd::write(std::span<uint8_t const> p) {
+  if (auto err = write_lock(); err) {
+    return {0, err};
+  }
+  auto _ = runtime::defer([this]() { write_unlock(); });
+  return write_locked(p);
+}
+
+std::pair<long, std::error_code> fd::write_locked(std::span<uint8_t const> p) {
+  if (auto err = pd_.prepare_write(is_file_); err) {
+    return {0, err};
+  }
+  long nn = 0;
+  for (;;) {
+    auto max = static_cast<long>(p.size());
+    if (is_stream && max-nn > max_rw) {
+      max = nn + max_rw;
+    }
+    auto [n, err] = ignoring_eintr_io([&]() {
+      return syscall::write(sysfd, p.subspan(nn, max-nn));
+    });
+    if (n > 0) {
+      nn += n;
+    }
+    if (nn == static_cast<long>(p.size())) {
+      return {nn, err};
+    }
+    if (err == std::errc::resource_unavailable_try_again && pd_.pollable()) {
+      if (err = pd_.wait_write(is_file_); !err) {
+        continue;
+      }
+    }
+    if (err) {
+      return {nn, err};
+    }
+    if (n == 0) {
+      return {nn, io::error::unexpected_eof};
+    }
+  }
+}
+
+std::pair<long, std::error_code> fd::pread(std::span<uint8_t> p, int64_t off) {
+  // Call incref, not read_lock, because since pread specifies the offset it
+  // is independent from other reads.
+  if (auto err = incref(); err) {
+    return {0, err};
+  }
+  auto _ = runtime::defer([this]() { decref(); });
+  if (is_stream && p.size() > max_rw) {
+    p = p.subspan(0, max_rw);
+  }
+  auto [n, err] = ignoring_eintr_io([&]() {
+    return sys_pread(sysfd, p, off);
+  });
+  if (err) {
+    n = 0;
+  }
+  return {n, eof_error(n, err)};
+}
+
+std::pair<long, std::error_code> fd::pwrite(std::span<uint8_t const> p, int64_t off) {
+  // Call incref, not write_lock, because since pwrite specifies the offset
+  // it is independent from other writes.
+  if (auto err = incref(); err) {
+    return {0, err};
+  }
+  auto _ = runtime::defer([this]() { decref(); });
+  long nn = 0;
+  for (;;) {
+    auto max = static_cast<long>(p.size());
+    if (is_stream && max-nn > max_rw) {
+      max = nn + max_rw;
+    }
+    auto [n, err] = ignoring_eintr_io([&]() {
+      return sys_pwrite(sysfd, p.subspan(nn, max-nn), off+nn);
+    });
+    if (n > 0) {
+      nn += n;
+    }
+    if (nn == static_cast<long>(p.size())) {
+      return {nn, err};
+    }
+    if (err) {
+      return {nn, err};
+    }
+    if (n == 0) {
+      return {nn, io::error::unexpected_eof};
+    }
+  }
+}
+
+std::pair<int64_t, std::error_code> fd::seek(int64_t offset, int whence) {
+  if (auto err = incref(); err) {
+    return {0, err};
+  }
+  auto _ = runtime::defer([this]() { decref(); });
+  return syscall::seek(sysfd, offset, whence);
+}
+
+std::pair<long, std::error_code> fd::readv(std::span<std::span<uint8_t> const> v) {
+  if (auto err = read_lock(); err) {
+    return {0, err};
+  }
+  auto _ = runtime::defer([this]() { read_unlock(); });
+  read_iovecs_.clear();
+  long total = 0;
+  for (auto chunk : v) {
+    if (chunk.size() == 0) {
+      continue;
+    }
+    if (is_stream && total + static_cast<long>(chunk.size()) > max_rw) {
+      chunk = chunk.subspan(0, static_cast<size_t>(max_rw - total));
+    }
+    read_iovecs_.push_back({chunk.data(), chunk.size()});
+    total += static_cast<long>(chunk.size());
+    if (read_iovecs_.size() == max_iovecs || total == max_rw) {
+      break;
+    }
+  }
+  if (read_iovecs_.empty()) {
+    return {0, nil};
+  }
+  if (auto err = pd_.prepare_read(is_file_); err) {
+    return {0, err};
+  }
+  for (;;) {
+    auto [n, err] = ignoring_eintr_io([&]() {
+      return syscall::readv(sysfd, read_iovecs_);
+    });
+    if (err) {
+      n = 0;
+      if (err == std::errc::resource_unavailable_try_again && pd_.pollable()) {
+        if (err = pd_.wait_read(is_file_); !err) {
+          continue;
+        }
+      }
+    }
+    return {n, eof_error(n, err)};
+  }
+}
+
+std::pair<long, std::error_code> fd::writev(std::span<std::span<uint8_t const> const> v) {
+  if (auto err = write_lock(); err) {
+    return {0, err};
+  }
+  auto _ = runtime::defer([this]() { write_unlock(); });
+  if (auto err = pd_.prepare_write(is_file_); err) {
+    return {0, err};
+  }
+  // Index and offset of the first unwritten byte.
+  size_t i = 0;
+  size_t off = 0;
+  long n = 0;
+  std::error_code err;
+  for (;;) {
+    write_iovecs_.clear();
+    for (auto j = i; j < v.size(); ++j) {
+      auto chunk = j == i ? v[j].subspan(off) : v[j];
+      if (chunk.size() == 0) {
+        continue;
+      }
+      if (is_stream && chunk.size() > max_rw) {
+        // Continue chunk on next writev.
+        write_iovecs_.push_back({const_cast<uint8_t*>(chunk.data()), static_cast<size_t>(max_rw)});
+        break;
+      }
+      write_iovecs_.push_back({const_cast<uint8_t*>(chunk.data()), chunk.size()});
+      if (write_iovecs_.size() == max_iovecs) {
+        break;
+      }
+    }
+    if (write_iovecs_.empty()) {
+      break;
+    }
+    long wrote;
+    std::tie(wrote, err) = syscall::writev(sysfd, write_iovecs_);
+    if (wrote < 0) {
+      wrote = 0;
+    }
+    n += wrote;
+    // Consume the written bytes.
+    for (auto left = static_cast<size_t>(wrote); left > 0 && i < v.size(); ) {
+      auto rem = v[i].size() - off;
+      if (left < rem) {
+        off += left;
+        break;
+      }
+      left -= rem;
+      ++i;
+      off = 0;
+    }
+    if (err) {
+      if (err == std::errc::interrupted) {
+        continue;
+      }
+      if (err == std::errc::resource_unavailable_try_again && pd_.pollable()) {
+        if (err = pd_.wait_write(is_file_); !err) {
+          continue;
+        }
+      }
+      break;
+    }
+    if (wrote == 0) {
+      err = io::error::unexpected_eof;
+      break;
+    }
+  }
+  return {n, err};
+}
+
+std::pair<long, std::error_code> fd::read_msg(struct ::msghdr* msg, int flags) {
+  if (auto err = read_lock(); err) {
+    return {0, err};
+  }
+  auto _ = runtime::defer([this]() { read_unlock(); });
+  if (auto err = pd_.prepare_read(is_file_); err) {
+    return {0, err};
+  }
+  for (;;) {
+    auto [n, err] = ignoring_eintr_io([&]() {
+      return syscall::recvmsg(sysfd, msg, flags);
+    });
+    if (err) {
+      n = 0;
+      if (err == std::errc::resource_unavailable_try_again && pd_.pollable()) {
+        if (err = pd_.wait_read(is_file_); !err) {
+          continue;
+        }
+      }
+    }
+    return {n, err};
+  }
+}
+
+std::pair<long, std::error_code> fd::write_msg(struct ::msghdr const* msg, int flags) {
+  if (auto err = write_lock(); err) {
+    return {0, err};
+  }
+  auto _ = runtime::defer([this]() { write_unlock(); });
+  if (auto err = pd_.prepare_write(is_file_); err) {
+    return {0, err};
+  }
+  for (;;) {
+    auto [n, err] = ignoring_eintr_io([&]() {
+      return syscall::sendmsg(sysfd, msg, flags);
+    });
+    if (err) {
+      n = 0;
+      if (err == std::errc::resource_unavailable_try_again && pd_.pollable()) {
+        if (err = pd_.wait_write(is_file_); !err) {
+          continue;
+        }
+      }
+    }
+    return {n, err};
+  }
+}
+
+std::pair<long, std::error_code> fd::read_mmsg(std::span<struct ::mmsghdr> msgs) {
+  if (auto err = read_lock(); err) {
+    return {0, err};
+  }
+  auto _ = runtime::defer([this]() { read_unlock(); });
+  if (msgs.empty()) {
+    return {0, nil};
+  }
+  if (auto err = pd_.prepare_read(is_file_); err) {
+    return {0, err};
+  }
+  for (;;) {
+    auto [n, err] = ignoring_eintr_io([&]() {
+      return syscall::recvmmsg(sysfd, msgs, 0);
+    });
+    if (err) {
+      n = 0;
+      if (err == std::errc::resource_unavailable_try_again && pd_.pollable()) {
+        if (err = pd_.wait_read(is_file_); !err) {
+          continue;
+        }
+      }
+    }
+    return {n, err};
+  }
+}
+
+std::pair<long, std::error_code> fd::write_mmsg(std::span<struct ::mmsghdr> msgs) {
+  if (auto err = write_lock(); err) {
+    return {0, err};
+  }
+  auto _ = runtime::defer([this]() { write_unlock(); });
+  if (auto err = pd_.prepare_write(is_file_); err) {
+    return {0, err};
+  }
+  long nn = 0;
+  while (nn < static_cast<long>(msgs.size())) {
+    auto [n, err] = ignoring_eintr_io([&]() {
+      return syscall::sendmmsg(sysfd, msgs.subspan(nn), 0);
+    });
+    if (n > 0) {
+      nn += n;
+    }
+    if (err == std::errc::resource_unavailable_try_again && pd_.pollable()) {
+      if (err = pd_.wait_write(is_file_); !err) {
+        continue;
+      }
+    }
+    if (err) {
+      return {nn, err};
+    }
+  }
+  return {nn, nil};
+}
+
+std::pair<int, std::error_code> fd::accept(struct ::sockaddr_storage* rsa) {
+  if (auto err = read_lock(); err) {
+    return {-1, err};
+  }
+  auto _ = runtime::defer([this]() { read_unlock(); });
+  if (auto err = pd_.prepare_read(is_file_); err) {
+    return {-1, err};
+  }
+  for (;;) {
+    auto [s, err] = syscall::accept4(sysfd, rsa, SOCK_NONBLOCK|SOCK_CLOEXEC);
+    if (!err) {
+      return {s, nil};
+    }
+    if (err == std::errc::interrupted) {
+      continue;
+    }
+    if (err == std::errc::resource_unavailable_try_again && pd_.pollable()) {
+      if (err = pd_.wait_read(is_file_); !err) {
+        continue;
+      }
+    }
+    if (err == std::errc::connection_aborted) {
+      // This means that a socket on the listen queue was closed before we
+      // accepted it; it's a silly error, so try again.
+      continue;
+    }
+    return {-1, err};
+  }
+}
+
+std::pair<long, std::error_code> fd::read(context::context_type const& ctx, std::span<uint8_t> p) {
+  return with_context(ctx, 'r', [&]() { return read_locked(p); });
+}
+
+std::pair<long, std::error_code> fd::write(context::context_type const& ctx, std::span<uint8_t const> p) {
+  return with_context(ctx, 'w', [&]() { return write_locked(p); });
+}
+
+std::error_code fd::wait_write() {
+  return pd_.wait_write(is_file_);
+}
+
+std::error_code fd::wait_write(context::context_type const& ctx) {
+  return with_context(ctx, 'w', [&]() { return std::pair<long, std::error_code>{0, wait_write()}; }).second;
+}
+
+template <typename Fn>
+std::pair<long, std::error_code> fd::with_context(context::context_type const& ctx, int mode, Fn fn) {
+  if (auto err = ctx->err(); err) {
+    return {0, err};
+  }
+  // The deadline override applies to the whole descriptor, so it is only
+  // installed while holding the lock for mode. This keeps operations queued
+  // behind this one from replacing or clearing its deadline.
+  if (auto err = mode == 'r' ? read_lock() : write_lock(); err) {
+    return {0, err};
+  }
+  auto _ = runtime::defer([this, mode]() {
+    mode == 'r' ? read_unlock() : write_unlock();
+  });
+  if (auto err = ctx->err(); err) {
+    // Canceled while waiting for the lock.
+    return {0, err};
+  }
+  if (ctx->done() == nullptr || !pd_.pollable()) {
+    // The context can never be canceled or the operation cannot be
+    // interrupted.
+    return fn();
+  }
+
+  auto& user = mode == 'r' ? read_deadline_ : write_deadline_;
+  auto deadline = ctx->deadline();
+  auto d = user.load();
+  if (deadline) {
+    if (auto cd = runtime_nano(*deadline); d == 0 || cd < d) {
+      d = cd;
+    }
+  }
+  pd_.set_deadline(d, mode);
+  auto stop = context::after_func(ctx, [this, mode]() {
+    pd_.set_deadline(-1, mode);
+  });
+
+  auto [n, err] = fn();
+
+  stop();
+  pd_.set_deadline(user.load(), mode);
+  if (err == error::deadline_exceeded) {
+    if (auto cerr = ctx->err(); cerr) {
+      err = cerr;
+    } else if (deadline && *deadline <= std::chrono::system_clock::now()) {
+      err = context::error::deadline_exceeded;
+    }
+  }
+  return {n, err};
+}
+
 std::error_code fd::incref() {
   if (!fdmu_.incref()) {
     return error_closing(is_file_);
@@ -97,4 +629,37 @@ std::error_code fd::decref() {
   return nil;
 }
 
+std::error_code fd::read_lock() {
+  if (!fdmu_.rwlock(true)) {
+    return error_closing(is_file_);
+  }
+  return nil;
+}
+
+void fd::read_unlock() {
+  if (fdmu_.rwunlock(true)) {
+    destroy();
+  }
+}
+
+std::error_code fd::write_lock() {
+  if (!fdmu_.rwlock(false)) {
+    return error_closing(is_file_);
+  }
+  return nil;
+}
+
+void fd::write_unlock() {
+  if (fdmu_.rwunlock(false)) {
+    destroy();
+  }
+}
+
+std::error_code fd::eof_error(long n, std::error_code err) const {
+  if (n == 0 && err == nil && zero_read_is_eof) {
+    return io::eof;
+  }
+  return err;
+}
+
 }  // namespace bongo::detail::poll
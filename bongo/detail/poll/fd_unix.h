@@ -2,11 +2,23 @@
 
 #pragma once
 
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <semaphore>
+#include <span>
 #include <string_view>
 #include <system_error>
+#include <utility>
+#include <vector>
 
+#include <bongo/bongo.h>
+#include <bongo/context/context.h>
 #include <bongo/detail/poll/fd_mutex.h>
+#include <bongo/detail/poll/fd_poll_runtime.h>
 #include <bongo/syscall.h>
 
 namespace bongo::detail::poll {
@@ -15,6 +27,14 @@ class fd {
   // Lock sysfd and serialize access to read and write.
   fd_mutex fdmu_;
 
+  // I/O poller.
+  poll_desc pd_;
+
+  // Deadlines set by the user, in runtime nanotime. These are restored after
+  // a context-aware operation overrides the poller deadline.
+  std::atomic<int64_t> read_deadline_ = 0;
+  std::atomic<int64_t> write_deadline_ = 0;
+
   // Whether this is a file rather than a network socket.
   bool is_file_ = false;
 
@@ -24,6 +44,11 @@ class fd {
   // True if this file has been set to blocking mode.
   bool is_blocking_ = false;
 
+  // Caches of iovecs used by readv and writev, protected by the read and
+  // write locks.
+  std::vector<struct ::iovec> read_iovecs_;
+  std::vector<struct ::iovec> write_iovecs_;
+
  public:
   // System file descriptor.
   int sysfd;
@@ -52,10 +77,132 @@ class fd {
   std::error_code close();
   std::error_code destroy();
   std::error_code fstat(struct ::stat* s);
+  std::error_code fsync();
+  std::error_code ftruncate(int64_t size);
+  std::error_code fadvise(int64_t offset, int64_t len, int advice);
+  std::error_code readahead(int64_t offset, long count);
+
+  // Wrappers around shutdown(2) and setsockopt(2) that hold a reference so
+  // a concurrent close cannot release sysfd during the call.
+  std::error_code shutdown(int how);
+  std::error_code setsockopt_int(int level, int opt, int value);
+
+  std::pair<long, std::error_code> read(std::span<uint8_t> p);
+  std::pair<long, std::error_code> write(std::span<uint8_t const> p);
+  std::pair<long, std::error_code> pread(std::span<uint8_t> p, int64_t off);
+  std::pair<long, std::error_code> pwrite(std::span<uint8_t const> p, int64_t off);
+  std::pair<int64_t, std::error_code> seek(int64_t offset, int whence);
+
+  // Scatter and gather variants of read and write. Empty buffers are
+  // skipped. Like write, writev returns only once every buffer is written or
+  // an error occurs.
+  std::pair<long, std::error_code> readv(std::span<std::span<uint8_t> const> v);
+  std::pair<long, std::error_code> writev(std::span<std::span<uint8_t const> const> v);
+
+  // Receive and send a single message on a socket, as with recvmsg(2) and
+  // sendmsg(2).
+  std::pair<long, std::error_code> read_msg(struct ::msghdr* msg, int flags);
+  std::pair<long, std::error_code> write_msg(struct ::msghdr const* msg, int flags);
+
+  // Receive and send multiple messages with a single system call. These
+  // return the number of messages transferred. read_mmsg returns as soon as
+  // at least one message is available. write_mmsg returns once every
+  // message is sent or an error occurs.
+  std::pair<long, std::error_code> read_mmsg(std::span<struct ::mmsghdr> msgs);
+  std::pair<long, std::error_code> write_mmsg(std::span<struct ::mmsghdr> msgs);
+
+  // Accepts a connection on a listening socket. The returned descriptor is
+  // non-blocking and close-on-exec. If rsa is not null it receives the
+  // address of the peer.
+  std::pair<int, std::error_code> accept(struct ::sockaddr_storage* rsa = nullptr);
+
+  // Context-aware variants of read and write. The operation is abandoned
+  // when ctx is done by expiring the poller deadline for the duration of the
+  // call. Descriptors in blocking mode cannot be interrupted, in that case
+  // ctx is only checked before the operation starts.
+  std::pair<long, std::error_code> read(context::context_type const& ctx, std::span<uint8_t> p);
+  std::pair<long, std::error_code> write(context::context_type const& ctx, std::span<uint8_t const> p);
+
+  // Waits until the descriptor is writable. This is used to wait for a
+  // non-blocking connect to complete.
+  std::error_code wait_write();
+  std::error_code wait_write(context::context_type const& ctx);
+
+  std::error_code set_deadline(std::chrono::system_clock::time_point t);
+  std::error_code set_read_deadline(std::chrono::system_clock::time_point t);
+  std::error_code set_write_deadline(std::chrono::system_clock::time_point t);
+
+  // Contention counters of the lock serializing reads and writes.
+  fd_mutex_stats mutex_stats() const noexcept { return fdmu_.stats(); }
+
+  // Calls f with sysfd while holding the read or write lock. If f returns
+  // false the operation would block, and f is called again once the poller
+  // reports the descriptor ready.
+  //
+  // - https://golang.org/pkg/syscall/#RawConn
+  template <typename Fn>
+  std::error_code raw_read(Fn f);
+  template <typename Fn>
+  std::error_code raw_write(Fn f);
+
+  // Whether the descriptor is registered with the poller, so that
+  // raw_read and raw_write can wait for readiness.
+  bool pollable() const noexcept { return pd_.pollable(); }
 
  private:
   std::error_code incref();
   std::error_code decref();
+  std::error_code read_lock();
+  void read_unlock();
+  std::error_code write_lock();
+  void write_unlock();
+  std::error_code eof_error(long n, std::error_code err) const;
+  std::error_code set_deadline_impl(std::chrono::system_clock::time_point t, int mode);
+
+  // Bodies of read and write, called with the read or write lock held.
+  std::pair<long, std::error_code> read_locked(std::span<uint8_t> p);
+  std::pair<long, std::error_code> write_locked(std::span<uint8_t const> p);
+
+  template <typename Fn>
+  std::pair<long, std::error_code> with_context(context::context_type const& ctx, int mode, Fn fn);
 };
 
+template <typename Fn>
+std::error_code fd::raw_read(Fn f) {
+  if (auto err = read_lock(); err) {
+    return err;
+  }
+  auto _ = runtime::defer([this]() { read_unlock(); });
+  if (auto err = pd_.prepare_read(is_file_); err) {
+    return err;
+  }
+  for (;;) {
+    if (f(sysfd)) {
+      return nil;
+    }
+    if (auto err = pd_.wait_read(is_file_); err) {
+      return err;
+    }
+  }
+}
+
+template <typename Fn>
+std::error_code fd::raw_write(Fn f) {
+  if (auto err = write_lock(); err) {
+    return err;
+  }
+  auto _ = runtime::defer([this]() { write_unlock(); });
+  if (auto err = pd_.prepare_write(is_file_); err) {
+    return err;
+  }
+  for (;;) {
+    if (f(sysfd)) {
+      return nil;
+    }
+    if (auto err = pd_.wait_write(is_file_); err) {
+      return err;
+    }
+  }
+}
+
 }  // namespace bongo::detail::poll
@@ -0,0 +1,345 @@
+// Copyright The Go Authors.
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "bongo/bongo.h"
+#include "bongo/bytes.h"
+#include "bongo/context.h"
+#include "bongo/detail/poll/error.h"
+#include "bongo/detail/poll/fd_unix.h"
+#include "bongo/io.h"
+#include "bongo/runtime/defer.h"
+#include "bongo/runtime/uring.h"
+
+using namespace std::chrono_literals;
+
+namespace bongo::detail::poll {
+namespace {
+
+std::pair<std::unique_ptr<fd>, std::unique_ptr<fd>> new_pipe() {
+  int p[2];
+  REQUIRE(::pipe2(p, O_CLOEXEC|O_NONBLOCK) == 0);
+  auto r = std::make_unique<fd>(p[0], true, true);
+  auto w = std::make_unique<fd>(p[1], true, true);
+  REQUIRE(r->init("file", true) == nil);
+  REQUIRE(w->init("file", true) == nil);
+  return {std::move(r), std::move(w)};
+}
+
+// Returns an unlinked temporary file.
+fd temp_file() {
+  char name[] = "/tmp/bongo-fd-XXXXXX";
+  auto sysfd = ::mkstemp(name);
+  REQUIRE(sysfd != -1);
+  ::unlink(name);
+  return fd{sysfd};
+}
+
+}  // namespace
+
+TEST_CASE("Writev", "[detail/poll]") {
+  auto [r, w] = new_pipe();
+  // Larger than the pipe buffer so the writer has to park.
+  auto body = std::vector<uint8_t>(1 << 20, 'x');
+  auto header = bytes::to_bytes(std::string_view{"header"});
+  auto v = std::vector<std::span<uint8_t const>>{header, {}, body};
+  auto got = std::vector<uint8_t>{};
+  auto t = std::thread{[&r = r, &got]() {
+    auto buf = std::vector<uint8_t>(64 * 1024);
+    for (;;) {
+      auto [n, err] = r->read(buf);
+      got.insert(got.end(), buf.begin(), buf.begin() + n);
+      if (err) {
+        CHECK(err == io::eof);
+        return;
+      }
+    }
+  }};
+  auto [n, err] = w->writev(v);
+  CHECK(n == static_cast<long>(header.size() + body.size()));
+  CHECK(err == nil);
+  w->close();
+  t.join();
+  REQUIRE(got.size() == header.size() + body.size());
+  CHECK(std::equal(header.begin(), header.end(), got.begin()));
+  CHECK(std::equal(body.begin(), body.end(), got.begin() + header.size()));
+}
+
+TEST_CASE("Readv", "[detail/poll]") {
+  auto [r, w] = new_pipe();
+  auto a = std::vector<uint8_t>(5);
+  auto b = std::vector<uint8_t>(64);
+  auto v = std::vector<std::span<uint8_t>>{a, {}, b};
+  auto t = std::thread{[&w = w]() {
+    // The reader parks until data is available
+    std::this_thread::sleep_for(10ms);
+    w->write(bytes::to_bytes(std::string_view{"hello world"}));
+  }};
+  auto [n, err] = r->readv(v);
+  t.join();
+  CHECK(n == 11);
+  CHECK(err == nil);
+  CHECK(std::string_view{reinterpret_cast<char*>(a.data()), 5} == "hello");
+  CHECK(std::string_view{reinterpret_cast<char*>(b.data()), 6} == " world");
+}
+
+TEST_CASE("Pread and pwrite", "[detail/poll]") {
+  auto f = temp_file();
+  REQUIRE(f.init("file", false) == nil);
+  auto [n, err] = f.pwrite(bytes::to_bytes(std::string_view{"0123456789"}), 0);
+  CHECK(n == 10);
+  CHECK(err == nil);
+  std::tie(n, err) = f.pwrite(bytes::to_bytes(std::string_view{"ab"}), 4);
+  CHECK(n == 2);
+  CHECK(err == nil);
+  auto buf = std::vector<uint8_t>(4);
+  std::tie(n, err) = f.pread(buf, 3);
+  CHECK(n == 4);
+  CHECK(err == nil);
+  CHECK(std::string_view{reinterpret_cast<char*>(buf.data()), 4} == "3ab6");
+  std::tie(n, err) = f.pread(buf, 10);
+  CHECK(n == 0);
+  CHECK(err == nil);
+}
+
+TEST_CASE("Pread and pwrite with io_uring", "[detail/poll]") {
+  auto enabled = runtime::uring_enabled();
+  auto _ = runtime::defer([enabled]() { runtime::set_uring_enabled(enabled); });
+  runtime::set_uring_enabled(true);
+  if (!runtime::uring_enabled()) {
+    // Not supported by this kernel
+    return;
+  }
+  auto f = temp_file();
+  REQUIRE(f.init("file", false) == nil);
+  auto [n, err] = f.pwrite(bytes::to_bytes(std::string_view{"0123456789"}), 0);
+  CHECK(n == 10);
+  CHECK(err == nil);
+  auto buf = std::vector<uint8_t>(4);
+  std::tie(n, err) = f.pread(buf, 3);
+  CHECK(n == 4);
+  CHECK(err == nil);
+  CHECK(std::string_view{reinterpret_cast<char*>(buf.data()), 4} == "3456");
+
+  // Reads into a registered buffer
+  auto fixed = std::vector<uint8_t>(4096);
+  auto bufs = std::vector<std::span<uint8_t>>{fixed};
+  REQUIRE(runtime::uring_register_buffers(bufs) == nil);
+  std::tie(n, err) = f.pread(std::span{fixed}.subspan(100, 3), 7);
+  CHECK(n == 3);
+  CHECK(err == nil);
+  CHECK(std::string_view{reinterpret_cast<char*>(fixed.data() + 100), 3} == "789");
+  REQUIRE(runtime::uring_unregister_buffers() == nil);
+
+  // Errors are reported like the system call
+  auto bad = fd{-1};
+  std::tie(n, err) = bad.pread(buf, 0);
+  CHECK(n == 0);
+  CHECK(err == std::errc::bad_file_descriptor);
+}
+
+TEST_CASE("Accept", "[detail/poll]") {
+  auto s = ::socket(AF_UNIX, SOCK_STREAM|SOCK_NONBLOCK|SOCK_CLOEXEC, 0);
+  REQUIRE(s != -1);
+  // Bind to an address in the abstract namespace
+  auto addr = sockaddr_un{};
+  addr.sun_family = AF_UNIX;
+  REQUIRE(::bind(s, reinterpret_cast<sockaddr*>(&addr), sizeof(sa_family_t)) == 0);
+  auto len = static_cast<socklen_t>(sizeof addr);
+  REQUIRE(::getsockname(s, reinterpret_cast<sockaddr*>(&addr), &len) == 0);
+  REQUIRE(::listen(s, 1) == 0);
+  auto ln = fd{s, true, true};
+  REQUIRE(ln.init("unix", true) == nil);
+
+  auto t = std::thread{[addr, len]() {
+    // The listener parks until a connection arrives
+    std::this_thread::sleep_for(10ms);
+    auto c = ::socket(AF_UNIX, SOCK_STREAM|SOCK_CLOEXEC, 0);
+    CHECK(::connect(c, reinterpret_cast<sockaddr const*>(&addr), len) == 0);
+    ::close(c);
+  }};
+  auto rsa = sockaddr_storage{};
+  auto [ns, err] = ln.accept(&rsa);
+  t.join();
+  REQUIRE(err == nil);
+  CHECK(ns != -1);
+  CHECK(rsa.ss_family == AF_UNIX);
+  CHECK((::fcntl(ns, F_GETFL) & O_NONBLOCK) != 0);
+  ::close(ns);
+
+  // Closing the listener unblocks a pending accept
+  auto t1 = std::thread{[&ln]() {
+    std::this_thread::sleep_for(10ms);
+    ln.close();
+  }};
+  std::tie(ns, err) = ln.accept();
+  t1.join();
+  CHECK(ns == -1);
+  CHECK(err == error::net_closing);
+}
+
+TEST_CASE("Shutdown and setsockopt", "[detail/poll]") {
+  int p[2];
+  REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM|SOCK_NONBLOCK|SOCK_CLOEXEC, 0, p) == 0);
+  auto a = fd{p[0], true, true};
+  auto b = fd{p[1], true, true};
+  REQUIRE(a.init("unix", true) == nil);
+  REQUIRE(b.init("unix", true) == nil);
+  CHECK(a.setsockopt_int(SOL_SOCKET, SO_SNDBUF, 8192) == nil);
+  CHECK(a.shutdown(SHUT_WR) == nil);
+  auto buf = std::vector<uint8_t>(1);
+  auto [n, err] = b.read(buf);
+  CHECK(n == 0);
+  CHECK(err == io::eof);
+
+  // Both fail once the descriptor is closed
+  a.close();
+  CHECK(a.shutdown(SHUT_RD) == error::net_closing);
+  CHECK(a.setsockopt_int(SOL_SOCKET, SO_SNDBUF, 8192) == error::net_closing);
+}
+
+TEST_CASE("Concurrent context reads", "[detail/poll]") {
+  auto [r, w] = new_pipe();
+  auto [ctx1, cancel1] = context::with_cancel(context::background());
+  auto [ctx2, cancel2] = context::with_cancel(context::background());
+  auto _ = runtime::defer([&cancel1 = cancel1]() { cancel1(); });
+
+  // The first read parks in the poller holding the read lock
+  auto buf1 = std::vector<uint8_t>(16);
+  auto n1 = long{0};
+  auto err1 = std::error_code{};
+  auto t1 = std::thread{[&, &ctx1 = ctx1]() {
+    std::tie(n1, err1) = r->read(ctx1, buf1);
+  }};
+  std::this_thread::sleep_for(10ms);
+
+  // The second read queues behind it
+  auto buf2 = std::vector<uint8_t>(16);
+  auto n2 = long{0};
+  auto err2 = std::error_code{};
+  auto t2 = std::thread{[&, &ctx2 = ctx2]() {
+    std::tie(n2, err2) = r->read(ctx2, buf2);
+  }};
+  std::this_thread::sleep_for(10ms);
+
+  // Canceling the queued read does not disturb the first one
+  cancel2();
+  std::this_thread::sleep_for(10ms);
+  w->write(bytes::to_bytes(std::string_view{"hello"}));
+  t1.join();
+  t2.join();
+  CHECK(n1 == 5);
+  CHECK(err1 == nil);
+  CHECK(std::string_view{reinterpret_cast<char*>(buf1.data()), 5} == "hello");
+  CHECK(n2 == 0);
+  CHECK(err2 == context::error::canceled);
+
+  // The poller deadline is restored once both reads are done
+  w->write(bytes::to_bytes(std::string_view{"world"}));
+  auto [n, err] = r->read(buf1);
+  CHECK(n == 5);
+  CHECK(err == nil);
+}
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+constexpr long random_read_file_size = 256 << 20;
+
+// Reads 4 KiB blocks at random offsets of a 256 MiB file from nthreads
+// threads. If cold is true the file is dropped from the page cache before
+// each sample. A sample is a single run at this size, so every read goes to
+// the device.
+void benchmark_random_reads(Catch::Benchmark::Chronometer& meter, fd& f, size_t nthreads, bool fixed, bool cold) {
+  constexpr long file_size = random_read_file_size;
+  constexpr long block = 4096;
+  constexpr long nreads = 256;
+  auto bufs = std::vector<std::vector<uint8_t>>(nthreads, std::vector<uint8_t>(block));
+  if (fixed) {
+    auto spans = std::vector<std::span<uint8_t>>(bufs.begin(), bufs.end());
+    REQUIRE(runtime::uring_register_buffers(spans) == nil);
+  }
+  if (cold) {
+    REQUIRE(f.fadvise(0, 0, POSIX_FADV_DONTNEED) == nil);
+  }
+  meter.measure([&]() {
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < nthreads; ++i) {
+      threads.emplace_back([&, i]() {
+        auto rng = std::minstd_rand{static_cast<unsigned>(i)};
+        auto dist = std::uniform_int_distribution<long>{0, file_size / block - 1};
+        for (long j = 0; j < nreads; ++j) {
+          auto [n, err] = f.pread(bufs[i], dist(rng) * block);
+          if (n != block || err) {
+            FAIL("short read");
+          }
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+  });
+  if (fixed) {
+    runtime::uring_unregister_buffers();
+  }
+}
+
+TEST_CASE("Pread benchmarks", "[!benchmark]") {
+  auto f = temp_file();
+  REQUIRE(f.init("file", false) == nil);
+  // Write real data so reads are served from allocated extents rather
+  // than holes.
+  auto chunk = std::vector<uint8_t>(1 << 20, 'x');
+  for (long off = 0; off < random_read_file_size; off += chunk.size()) {
+    auto [n, err] = f.pwrite(chunk, off);
+    REQUIRE(n == static_cast<long>(chunk.size()));
+    REQUIRE(err == nil);
+  }
+  REQUIRE(f.fsync() == nil);
+  auto enabled = runtime::uring_enabled();
+  auto _ = runtime::defer([enabled]() { runtime::set_uring_enabled(enabled); });
+
+  for (bool cold : {false, true}) {
+    auto cache = std::string{cold ? ", cold" : ""};
+    for (size_t nthreads : {1, 8}) {
+      auto threads = std::to_string(nthreads) + " threads" + cache;
+      runtime::set_uring_enabled(false);
+      BENCHMARK_ADVANCED("Random 4 KiB pread (" + threads + ")")(Catch::Benchmark::Chronometer meter) {
+        benchmark_random_reads(meter, f, nthreads, false, cold);
+      };
+      runtime::set_uring_enabled(true);
+      if (!runtime::uring_enabled()) {
+        continue;
+      }
+      BENCHMARK_ADVANCED("Random 4 KiB io_uring (" + threads + ")")(Catch::Benchmark::Chronometer meter) {
+        benchmark_random_reads(meter, f, nthreads, false, cold);
+      };
+      BENCHMARK_ADVANCED("Random 4 KiB io_uring fixed (" + threads + ")")(Catch::Benchmark::Chronometer meter) {
+        benchmark_random_reads(meter, f, nthreads, true, cold);
+      };
+    }
+  }
+}
+
+#endif  // defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+}  // namespace bongo::detail::poll
@@ -0,0 +1,266 @@
+// Copyright The Go Authors.
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <system_error>
+#include <tuple>
+
+#include "bongo/bongo.h"
+#include "bongo/detail/poll/fd_unix.h"
+#include "bongo/detail/poll/zero_copy_linux.h"
+#include "bongo/sync/pool.h"
+#include "bongo/syscall.h"
+
+namespace bongo::detail::poll {
+namespace {
+
+// Maximum number of bytes copied by a single copy_file_range call.
+constexpr static int64_t max_copy_file_range_round = 1 << 30;
+
+// Maximum number of bytes sent by a single sendfile call.
+constexpr static int64_t max_sendfile_size = 4 << 20;
+
+// Maximum number of bytes moved through the pipe by one splice call, and the
+// size the pipe buffer is grown to.
+constexpr static int64_t max_splice_size = 1 << 20;
+
+bool is_again(std::error_code err) {
+  return err == std::errc::resource_unavailable_try_again;
+}
+
+// A pipe used as the intermediate buffer of splice.
+struct splice_pipe {
+  int rfd = -1;
+  int wfd = -1;
+  // Bytes buffered in the pipe. A pipe with data left in it is not reused.
+  long data = 0;
+
+  ~splice_pipe() {
+    if (rfd >= 0) {
+      ::close(rfd);
+      ::close(wfd);
+    }
+  }
+};
+
+sync::pool<splice_pipe> splice_pipe_pool;
+
+std::pair<std::unique_ptr<splice_pipe>, std::error_code> get_pipe() {
+  if (auto p = splice_pipe_pool.get(); p) {
+    return {std::move(p), nil};
+  }
+  int fds[2];
+  if (auto err = syscall::pipe2(fds, O_CLOEXEC|O_NONBLOCK); err) {
+    return {nullptr, err};
+  }
+  auto p = std::make_unique<splice_pipe>();
+  p->rfd = fds[0];
+  p->wfd = fds[1];
+  // Growing the pipe is an optimization, ignore errors.
+  ::fcntl(p->wfd, F_SETPIPE_SZ, static_cast<int>(max_splice_size));
+  return {std::move(p), nil};
+}
+
+void put_pipe(std::unique_ptr<splice_pipe> p) {
+  if (p->data == 0) {
+    splice_pipe_pool.put(std::move(p));
+  }
+}
+
+// Moves up to max bytes from src into the pipe. Waits for src to become
+// readable if it is empty.
+std::pair<long, std::error_code> splice_drain(int pipefd, fd& src, long max) {
+  auto flags = src.pollable() ? SPLICE_F_NONBLOCK : 0u;
+  long n = 0;
+  std::error_code err;
+  auto err1 = src.raw_read([&](int sysfd) {
+    for (;;) {
+      std::tie(n, err) = syscall::splice(sysfd, pipefd, max, flags);
+      if (err == std::errc::interrupted) {
+        continue;
+      }
+      return !is_again(err);
+    }
+  });
+  if (err1) {
+    return {0, err1};
+  }
+  return {n < 0 ? 0 : n, err};
+}
+
+// Moves in_pipe bytes from the pipe into dst, waiting for dst to become
+// writable as needed.
+std::pair<long, std::error_code> splice_pump(fd& dst, int pipefd, long in_pipe) {
+  auto flags = dst.pollable() ? SPLICE_F_NONBLOCK : 0u;
+  long written = 0;
+  std::error_code err;
+  auto err1 = dst.raw_write([&](int sysfd) {
+    while (in_pipe > 0) {
+      auto [n, e] = syscall::splice(pipefd, sysfd, in_pipe, flags);
+      if (e == std::errc::interrupted) {
+        continue;
+      }
+      // n == 0 without an error cannot happen here since the pipe holds
+      // in_pipe bytes.
+      if (n > 0) {
+        in_pipe -= n;
+        written += n;
+        continue;
+      }
+      if (is_again(e)) {
+        return false;
+      }
+      err = e;
+      break;
+    }
+    return true;
+  });
+  return {written, err1 ? err1 : err};
+}
+
+}  // namespace
+
+std::tuple<int64_t, bool, std::error_code> copy_file_range(fd& dst, fd& src, int64_t remain) {
+  int64_t written = 0;
+  auto handled = true;
+  std::error_code err;
+  std::error_code err2;
+  auto err1 = dst.raw_write([&](int wfd) {
+    err2 = src.raw_read([&](int rfd) {
+      while (remain > 0) {
+        auto [n, e] = syscall::copy_file_range(rfd, wfd, std::min(remain, max_copy_file_range_round));
+        if (e == std::errc::interrupted) {
+          continue;
+        }
+        if (e == std::errc::function_not_supported ||
+            e == std::errc::cross_device_link ||
+            e == std::errc::bad_file_descriptor ||
+            e == std::errc::invalid_argument ||
+            e == std::errc::io_error ||
+            e == std::errc::operation_not_supported ||
+            e == std::errc::operation_not_permitted) {
+          // The kernel lacks copy_file_range, or cannot use it for these
+          // descriptors: they are not regular files open for reading and
+          // writing, are on different file systems, or the file system
+          // does not support it. These are checked before anything is
+          // copied.
+          if (written == 0) {
+            handled = false;
+          } else {
+            err = e;
+          }
+          return true;
+        }
+        if (e) {
+          err = e;
+          return true;
+        }
+        if (n == 0) {
+          // Some file systems, such as procfs, report size zero and copy
+          // nothing. Fall back to read and write unless this is the end of
+          // a file already partly copied.
+          handled = written != 0;
+          return true;
+        }
+        remain -= n;
+        written += n;
+      }
+      return true;
+    });
+    return true;
+  });
+  if (err1 || err2) {
+    return {written, true, err1 ? err1 : err2};
+  }
+  return {written, handled, err};
+}
+
+std::tuple<int64_t, bool, std::error_code> send_file(fd& dst, fd& src, int64_t remain) {
+  int64_t written = 0;
+  std::error_code err;
+  std::error_code err2;
+  auto err1 = src.raw_read([&](int rfd) {
+    err2 = dst.raw_write([&](int wfd) {
+      while (remain > 0) {
+        auto [n, e] = syscall::sendfile(wfd, rfd, std::min(remain, max_sendfile_size));
+        if (n > 0) {
+          written += n;
+          remain -= n;
+          continue;
+        }
+        if (e == std::errc::interrupted) {
+          continue;
+        }
+        if (is_again(e)) {
+          return false;
+        }
+        // Either end of file or an error. ENOSYS and EINVAL mean sendfile
+        // is not supported for these descriptors.
+        if (e) {
+          err = e;
+        }
+        break;
+      }
+      return true;
+    });
+    return true;
+  });
+  if (err1 || err2) {
+    return {written, true, err1 ? err1 : err2};
+  }
+  auto handled = written != 0 ||
+      (err != std::errc::function_not_supported && err != std::errc::invalid_argument);
+  return {written, handled, err};
+}
+
+std::tuple<int64_t, bool, std::error_code> splice(fd& dst, fd& src, int64_t remain) {
+  auto [p, err] = get_pipe();
+  if (err) {
+    return {0, false, err};
+  }
+  int64_t written = 0;
+  auto handled = false;
+  while (!err && remain > 0) {
+    long in_pipe;
+    std::tie(in_pipe, err) = splice_drain(p->wfd, src, std::min(remain, max_splice_size));
+    // The operation is considered handled if splice returns no error, or
+    // an error other than EINVAL.
+    handled = handled || err != std::errc::invalid_argument;
+    if (err || in_pipe == 0) {
+      break;
+    }
+    p->data += in_pipe;
+    long n;
+    std::tie(n, err) = splice_pump(dst, p->rfd, in_pipe);
+    if (n > 0) {
+      written += n;
+      remain -= n;
+      p->data -= n;
+    }
+  }
+  put_pipe(std::move(p));
+  if (err) {
+    return {written, handled, err};
+  }
+  return {written, true, nil};
+}
+
+std::tuple<int64_t, bool, std::error_code> zero_copy(fd& dst, fd& src, int64_t remain) {
+  // None of these support destinations opened with O_APPEND.
+  if (auto flags = ::fcntl(dst.sysfd, F_GETFL); flags == -1 || (flags&O_APPEND) != 0) {
+    return {0, false, nil};
+  }
+  if (auto [n, handled, err] = copy_file_range(dst, src, remain); handled) {
+    return {n, handled, err};
+  }
+  if (auto [n, handled, err] = send_file(dst, src, remain); handled) {
+    return {n, handled, err};
+  }
+  return splice(dst, src, remain);
+}
+
+}  // namespace bongo::detail::poll
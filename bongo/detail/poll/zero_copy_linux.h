@@ -0,0 +1,73 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <system_error>
+#include <tuple>
+
+#include <bongo/bongo.h>
+#include <bongo/detail/poll/fd_unix.h>
+#include <bongo/io/io.h>
+
+namespace bongo::detail::poll {
+
+// Satisfied by types backed by a poll::fd, such as os::file and net::conn.
+template <typename T>
+concept PollFD = requires (T& t) {
+  { t.poll_fd() } -> std::same_as<fd*>;
+};
+
+// Each function below copies up to remain bytes from src to dst in the
+// kernel, using and advancing the file offsets of both. It reports whether
+// the copy was handled; if not, nothing was copied and the caller should
+// fall back to a userspace copy.
+
+// Copies between regular files with copy_file_range(2).
+//
+// - https://github.com/golang/go/blob/master/src/internal/poll/copy_file_range_linux.go
+std::tuple<int64_t, bool, std::error_code> copy_file_range(fd& dst, fd& src, int64_t remain);
+
+// Copies from a regular file to any descriptor with sendfile(2).
+//
+// - https://github.com/golang/go/blob/master/src/internal/poll/sendfile_linux.go
+std::tuple<int64_t, bool, std::error_code> send_file(fd& dst, fd& src, int64_t remain);
+
+// Copies through a pooled pipe with splice(2). Works for any pair of
+// descriptors the kernel can splice, such as sockets, pipes and files.
+//
+// - https://github.com/golang/go/blob/master/src/internal/poll/splice_linux.go
+std::tuple<int64_t, bool, std::error_code> splice(fd& dst, fd& src, int64_t remain);
+
+// Tries copy_file_range, send_file and splice in turn. Destinations opened
+// with O_APPEND are not handled.
+std::tuple<int64_t, bool, std::error_code> zero_copy(fd& dst, fd& src, int64_t remain);
+
+template <typename T>
+struct is_limited_poll_fd : std::false_type {};
+
+template <PollFD T>
+struct is_limited_poll_fd<io::limited_reader<T>> : std::true_type {};
+
+// Copies from src to dst in the kernel if both are backed by a poll::fd.
+// The source may also be an io::limited_reader over one, whose limit is
+// honored and updated.
+template <typename D, typename S>
+std::tuple<int64_t, bool, std::error_code> zero_copy(D& dst, S& src) {
+  if constexpr (PollFD<D> && PollFD<S>) {
+    return zero_copy(*dst.poll_fd(), *src.poll_fd(), std::numeric_limits<int64_t>::max());
+  } else if constexpr (PollFD<D> && is_limited_poll_fd<S>::value) {
+    if (src.n <= 0) {
+      return {0, true, nil};
+    }
+    auto [n, handled, err] = zero_copy(*dst.poll_fd(), *src.r.poll_fd(), src.n);
+    src.n -= n;
+    return {n, handled, err};
+  } else {
+    return {0, false, nil};
+  }
+}
+
+}  // namespace bongo::detail::poll
@@ -0,0 +1,155 @@
+// Copyright The Go Authors.
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "bongo/bongo.h"
+#include "bongo/detail/poll/fd_unix.h"
+#include "bongo/detail/poll/zero_copy_linux.h"
+#include "bongo/io.h"
+
+namespace bongo::detail::poll {
+namespace {
+
+constexpr static int64_t unlimited = std::numeric_limits<int64_t>::max();
+
+std::pair<std::unique_ptr<fd>, std::unique_ptr<fd>> new_pipe() {
+  int p[2];
+  REQUIRE(::pipe2(p, O_CLOEXEC|O_NONBLOCK) == 0);
+  auto r = std::make_unique<fd>(p[0], true, true);
+  auto w = std::make_unique<fd>(p[1], true, true);
+  REQUIRE(r->init("file", true) == nil);
+  REQUIRE(w->init("file", true) == nil);
+  return {std::move(r), std::move(w)};
+}
+
+// Returns an unlinked temporary file opened with the given extra flags.
+std::unique_ptr<fd> temp_file(int flags = 0) {
+  char name[] = "/tmp/bongo-zero-copy-XXXXXX";
+  auto sysfd = ::mkostemp(name, O_CLOEXEC | flags);
+  REQUIRE(sysfd != -1);
+  ::unlink(name);
+  auto f = std::make_unique<fd>(sysfd, true, true);
+  REQUIRE(f->init("file", false) == nil);
+  return f;
+}
+
+std::vector<uint8_t> pattern(size_t n) {
+  auto b = std::vector<uint8_t>(n);
+  for (size_t i = 0; i < n; ++i) {
+    b[i] = static_cast<uint8_t>(i * 7 + i / 251);
+  }
+  return b;
+}
+
+std::vector<uint8_t> contents(fd& f, size_t n) {
+  auto b = std::vector<uint8_t>(n);
+  auto [m, err] = f.pread(b, 0);
+  REQUIRE(err == nil);
+  REQUIRE(m == static_cast<long>(n));
+  return b;
+}
+
+// Reads r until EOF on another thread.
+std::thread drain(fd& r, std::vector<uint8_t>& got) {
+  return std::thread{[&r, &got]() {
+    auto buf = std::vector<uint8_t>(64 * 1024);
+    for (;;) {
+      auto [n, err] = r.read(buf);
+      got.insert(got.end(), buf.begin(), buf.begin() + n);
+      if (err) {
+        return;
+      }
+    }
+  }};
+}
+
+}  // namespace
+
+TEST_CASE("Copy file range", "[detail/poll]") {
+  auto data = pattern(3 << 20);
+  auto src = temp_file();
+  auto dst = temp_file();
+  REQUIRE(src->pwrite(data, 0).second == nil);
+
+  // Copies from the current offset of src
+  REQUIRE(src->seek(1000, SEEK_SET).second == nil);
+  auto [n, handled, err] = copy_file_range(*dst, *src, unlimited);
+  CHECK(handled);
+  CHECK(err == nil);
+  CHECK(n == static_cast<int64_t>(data.size()) - 1000);
+  CHECK(contents(*dst, n) == std::vector<uint8_t>(data.begin() + 1000, data.end()));
+  CHECK(src->seek(0, SEEK_CUR).first == static_cast<int64_t>(data.size()));
+
+  // Only regular files are handled
+  auto [r, w] = new_pipe();
+  std::tie(n, handled, err) = copy_file_range(*w, *src, unlimited);
+  CHECK(!handled);
+  CHECK(n == 0);
+}
+
+TEST_CASE("Send file", "[detail/poll]") {
+  // Larger than the pipe buffer so the writer has to park.
+  auto data = pattern(1 << 20);
+  auto src = temp_file();
+  REQUIRE(src->pwrite(data, 0).second == nil);
+  auto [r, w] = new_pipe();
+  auto got = std::vector<uint8_t>{};
+  auto t = drain(*r, got);
+  auto [n, handled, err] = send_file(*w, *src, unlimited);
+  w->close();
+  t.join();
+  CHECK(handled);
+  CHECK(err == nil);
+  CHECK(n == static_cast<int64_t>(data.size()));
+  CHECK(got == data);
+
+  // The source must support mmap-like operations, a pipe does not.
+  auto dst = temp_file();
+  std::tie(n, handled, err) = send_file(*dst, *r, unlimited);
+  CHECK(!handled);
+}
+
+TEST_CASE("Splice", "[detail/poll]") {
+  auto data = pattern(2 << 20);
+  auto [r, w] = new_pipe();
+  auto t = std::thread{[&w = w, &data]() {
+    w->write(data);
+    w->close();
+  }};
+  auto dst = temp_file();
+
+  // The limit is honored
+  auto [n, handled, err] = splice(*dst, *r, 1000);
+  CHECK(handled);
+  CHECK(err == nil);
+  CHECK(n == 1000);
+
+  std::tie(n, handled, err) = splice(*dst, *r, unlimited);
+  t.join();
+  CHECK(handled);
+  CHECK(err == nil);
+  CHECK(n == static_cast<int64_t>(data.size()) - 1000);
+  CHECK(contents(*dst, data.size()) == data);
+}
+
+TEST_CASE("Zero copy to append mode file", "[detail/poll]") {
+  auto src = temp_file();
+  auto dst = temp_file(O_APPEND);
+  REQUIRE(src->pwrite(pattern(100), 0).second == nil);
+  auto [n, handled, err] = zero_copy(*dst, *src, unlimited);
+  CHECK(!handled);
+  CHECK(n == 0);
+}
+
+}  // namespace bongo::detail::poll
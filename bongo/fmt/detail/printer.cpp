@@ -1,12 +1,44 @@
 // Copyright The Go Authors.
 
+#include <memory>
 #include <system_error>
 #include <span>
 #include <utility>
 
 #include <bongo/fmt/detail/printer.h>
+#include <bongo/sync/pool.h>
 
 namespace bongo::fmt::detail {
+namespace {
+
+auto printer_pool() -> sync::pool<printer>& {
+  static auto pp = sync::pool<printer>{[]() { return std::make_unique<printer>(); }};
+  return pp;
+}
+
+}  // namespace
+
+auto printer_free::operator()(printer* p) const -> void {
+  p->free();
+}
+
+auto new_printer() -> printer_ptr {
+  return printer_ptr{printer_pool().get().release()};
+}
+
+auto printer::free() -> void {
+  // Proper usage of a pool requires each entry to have approximately the
+  // same memory cost. To obtain this property when the stored type
+  // contains a variably-sized buffer, we add a hard limit on the maximum
+  // buffer to place back in the pool. If the buffer is larger than the
+  // limit, we drop the buffer and recycle just the printer.
+  if (buf_.capacity() > 64<<10) {
+    buf_ = bytes::buffer{};
+  }
+  buf_.reset();
+  fmt_.clear_flags();
+  printer_pool().put(std::unique_ptr<printer>{this});
+}
 
 auto printer::width() const -> std::pair<long, bool> {
   return {fmt_.wid, fmt_.flags.wid_present};
@@ -4,6 +4,7 @@
 
 #include <complex>
 #include <iterator>
+#include <memory>
 #include <span>
 #include <stdexcept>
 #include <string>
@@ -36,6 +37,18 @@ constexpr static std::string_view bad_width_string = "%!(BADWIDTH)";
 constexpr static std::string_view bad_prec_string = "%!(BADPREC)";
 constexpr static std::string_view no_verb_string = "%!(NOVERB)";
 
+class printer;
+
+// Returns a printer to the cache instead of destroying it.
+struct printer_free {
+  auto operator()(printer* p) const -> void;
+};
+
+using printer_ptr = std::unique_ptr<printer, printer_free>;
+
+// Allocates a new printer or grabs a cached one.
+auto new_printer() -> printer_ptr;
+
 class printer {
   bytes::buffer buf_;
   fmt fmt_;
@@ -63,6 +76,9 @@ class printer {
   auto bytes() -> std::span<uint8_t> { return buf_.bytes();}
   auto str() const -> std::string_view { return buf_.str(); }
 
+  // Saves used printers in a cache to avoid an allocation per call.
+  auto free() -> void;
+
  private:
   template <typename T>
   auto print_arg(T&& arg, rune verb) -> void;
@@ -807,4 +807,42 @@ TEST_CASE("Reorder tests", "[fmt]") {
   CHECK(sprintf("%.2147483648d", 42) == "%!(NOVERB)%!(EXTRA int=42)");
 }
 
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+TEST_CASE("Fmt benchmarks", "[!benchmark]") {
+  BENCHMARK("Sprintf padding") {
+    return sprintf("%16f", 1.0);
+  };
+
+  BENCHMARK("Sprintf empty") {
+    return sprintf("");
+  };
+
+  BENCHMARK("Sprintf string") {
+    return sprintf("%s", "hello");
+  };
+
+  BENCHMARK("Sprintf int") {
+    return sprintf("%d", 5);
+  };
+
+  BENCHMARK("Sprintf int int") {
+    return sprintf("%d %d", 5, 6);
+  };
+
+  BENCHMARK("Sprintf prefixed int") {
+    return sprintf("This is some meaningless prefix text that needs to be scanned %d", 6);
+  };
+
+  BENCHMARK("Sprint int") {
+    return sprint(5);
+  };
+
+  BENCHMARK("Many args") {
+    return sprintf("%2d/%2d/%2d %d:%d:%d %s %s\n", 3, 4, 5, 11, 12, 13, "hello", "world");
+  };
+}
+
+#endif  // defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
 }  // namespace bongo::fmt
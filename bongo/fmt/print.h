@@ -19,9 +19,9 @@ namespace bongo::fmt {
 template <typename T, typename... Args> requires io::Writer<T>
 auto fprintf(T& w, std::string_view format, Args&&... args) -> std::pair<long, std::error_code> {
   using io::write;
-  auto p = detail::printer{};
-  p.do_printf(format, std::forward<Args>(args)...);
-  return write(w, p.bytes());
+  auto p = detail::new_printer();
+  p->do_printf(format, std::forward<Args>(args)...);
+  return write(w, p->bytes());
 }
 
 // fprintf formats according to a format specifier and writes to standard
@@ -36,9 +36,9 @@ auto printf(std::string_view format, Args&&... args) -> std::pair<long, std::err
 // string.
 template <typename... Args>
 auto sprintf(std::string_view fmt, Args&&... args) -> std::string {
-  auto p = detail::printer{};
-  p.do_printf(fmt, std::forward<Args>(args)...);
-  return std::string{p.str()};
+  auto p = detail::new_printer();
+  p->do_printf(fmt, std::forward<Args>(args)...);
+  return std::string{p->str()};
 }
 
 // fprint formats using the default formats for its operands and writes to w.
@@ -47,9 +47,9 @@ auto sprintf(std::string_view fmt, Args&&... args) -> std::string {
 template <typename T, typename... Args> requires io::Writer<T>
 auto fprint(T& w, Args&&... args) -> std::pair<long, std::error_code> {
   using io::write;
-  auto p = detail::printer{};
-  p.do_print(std::forward<Args>(args)...);
-  return write(w, p.bytes());
+  auto p = detail::new_printer();
+  p->do_print(std::forward<Args>(args)...);
+  return write(w, p->bytes());
 }
 
 // fprint formats using the default formats for its operands and writes to
@@ -66,9 +66,9 @@ auto print(Args&&... args) -> std::pair<long, std::error_code> {
 template <typename... Args>
 auto sprint(Args&&... args) -> std::string {
   if constexpr (sizeof... (args) > 0) {
-    auto p = detail::printer{};
-    p.do_print(std::forward<Args>(args)...);
-    return std::string{p.str()};
+    auto p = detail::new_printer();
+    p->do_print(std::forward<Args>(args)...);
+    return std::string{p->str()};
   }
   return std::string{};
 }
@@ -79,9 +79,9 @@ auto sprint(Args&&... args) -> std::string {
 template <typename T, typename... Args> requires io::Writer<T>
 auto fprintln(T& w, Args&&... args) -> std::pair<long, std::error_code> {
   using io::write;
-  auto p = detail::printer{};
-  p.do_println(std::forward<Args>(args)...);
-  return write(w, p.bytes());
+  auto p = detail::new_printer();
+  p->do_println(std::forward<Args>(args)...);
+  return write(w, p->bytes());
 }
 
 // println formats using the default formats for its operands and writes to
@@ -99,9 +99,9 @@ auto println(Args&&... args) -> std::pair<long, std::error_code> {
 template <typename... Args>
 auto sprintln(Args&&... args) -> std::string {
   if constexpr (sizeof... (args) > 0) {
-    auto p = detail::printer{};
-    p.do_println(std::forward<Args>(args)...);
-    return std::string{p.str()};
+    auto p = detail::new_printer();
+    p->do_println(std::forward<Args>(args)...);
+    return std::string{p->str()};
   }
   return std::string{"\n"};
 }
@@ -2,4 +2,5 @@
 
 #pragma once
 
+#include <bongo/io/fs/error.h>
 #include <bongo/io/fs/fs.h>
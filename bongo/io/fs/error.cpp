@@ -0,0 +1,32 @@
+// Copyright The Go Authors.
+
+#include <system_error>
+
+#include "bongo/io/fs/error.h"
+
+namespace bongo::io::fs {
+namespace {
+
+struct error_category : std::error_category {
+  const char* name() const noexcept { return "io/fs"; }
+  std::string message(int e) const {
+    switch (static_cast<error>(e)) {
+    case error::skip_dir:
+      return "skip this directory";
+    case error::skip_all:
+      return "skip everything and stop the walk";
+    default:
+      return "unrecognized error";
+    }
+  }
+};
+
+const error_category error_category{};
+
+}  // namespace
+
+std::error_code make_error_code(error e) {
+  return {static_cast<int>(e), error_category};
+}
+
+}  // namespace bongo::io::fs
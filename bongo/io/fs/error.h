@@ -0,0 +1,30 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <system_error>
+
+namespace bongo::io::fs {
+
+enum class error {
+  skip_dir = 1,
+  skip_all,
+};
+
+std::error_code make_error_code(error e);
+
+// Returned by a walk function to skip the directory named in the call, or
+// the remaining entries of the containing directory if the entry is a file.
+constexpr error skip_dir = error::skip_dir;
+
+// Returned by a walk function to skip all remaining files and directories.
+constexpr error skip_all = error::skip_all;
+
+}  // namespace bongo::io::fs
+
+namespace std {
+
+template <>
+struct is_error_code_enum<bongo::io::fs::error> : true_type {};
+
+}  // namespace std
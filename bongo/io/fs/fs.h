@@ -31,7 +31,7 @@ class file_mode {
   constexpr file_mode(uint32_t m)
       : m_{m} {}
 
-  operator uint32_t() { return m_; }
+  constexpr operator uint32_t() const noexcept { return m_; }
   constexpr file_mode operator|(file_mode const& other) const noexcept { return m_ | other.m_; }
   constexpr file_mode operator&(file_mode const& other) const noexcept { return m_ & other.m_; }
 
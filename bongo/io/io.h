@@ -225,6 +225,71 @@ concept WriterAtFunc = requires (T w, std::span<uint8_t const> p, int64_t off) {
   { write_at(w, p, off) } -> std::same_as<std::pair<long, std::error_code>>;
 };
 
+// ReaderV is the interface that wraps the vectored readv method. Like read,
+// it returns the number of bytes read, filling the buffers in order, and
+// may return fewer bytes than requested. The fallback reads into the first
+// non-empty buffer.
+template <typename T>
+concept ReaderV = requires (T r, std::span<std::span<uint8_t> const> v) {
+  { r.readv(v) } -> std::same_as<std::pair<long, std::error_code>>;
+};
+
+template <typename T> requires ReaderV<T> || ReaderFunc<T>
+std::pair<long, std::error_code> readv(T& r, std::span<std::span<uint8_t> const> v) {
+  if constexpr (ReaderV<T>) {
+    return r.readv(v);
+  } else {
+    for (auto p : v) {
+      if (!p.empty()) {
+        return read(r, p);
+      }
+    }
+    return read(r, std::span<uint8_t>{});
+  }
+}
+
+template <typename T>
+concept ReaderVFunc = requires (T r, std::span<std::span<uint8_t> const> v) {
+  { readv(r, v) } -> std::same_as<std::pair<long, std::error_code>>;
+};
+
+// WriterV is the interface that wraps the vectored writev method. It writes
+// the buffers in order as one sequence, and like write returns an error if
+// fewer bytes than their total are written. The fallback writes each
+// buffer in turn.
+template <typename T>
+concept WriterV = requires (T w, std::span<std::span<uint8_t const> const> v) {
+  { w.writev(v) } -> std::same_as<std::pair<long, std::error_code>>;
+};
+
+template <typename T> requires WriterV<T> || WriterFunc<T>
+std::pair<long, std::error_code> writev(T& w, std::span<std::span<uint8_t const> const> v) {
+  if constexpr (WriterV<T>) {
+    return w.writev(v);
+  } else {
+    long nn = 0;
+    for (auto p : v) {
+      if (p.empty()) {
+        continue;
+      }
+      auto [n, err] = write(w, p);
+      nn += n;
+      if (err != nil) {
+        return {nn, err};
+      }
+      if (n != static_cast<long>(p.size())) {
+        return {nn, error::short_write};
+      }
+    }
+    return {nn, nil};
+  }
+}
+
+template <typename T>
+concept WriterVFunc = requires (T w, std::span<std::span<uint8_t const> const> v) {
+  { writev(w, v) } -> std::same_as<std::pair<long, std::error_code>>;
+};
+
 // ByteReader is the interface that wraps the read_byte method.
 template <typename T>
 concept ByteReader = requires (T r) {
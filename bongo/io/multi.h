@@ -40,6 +40,25 @@ class multi_reader {
     }
     return {0, eof};
   }
+
+  std::pair<long, std::error_code> readv(std::span<std::span<uint8_t> const> v) {
+    using io::readv;
+    for (size_t i = 0; i < sizeof...(Ts);) {
+      auto [n, err] = detail::visit_at([&](auto& r) {
+        return readv(r, v);
+      }, readers_, i);
+      if (err == eof) {
+        ++i;
+      }
+      if (n > 0 || err != eof) {
+        if (err == eof && i < sizeof...(Ts)) {
+          err = nil;
+        }
+        return {n, err};
+      }
+    }
+    return {0, eof};
+  }
 };
 
 template <Writer... Ts>
@@ -66,6 +85,26 @@ class multi_writer {
     return {static_cast<long>(p.size()), nil};
   }
 
+  std::pair<long, std::error_code> writev(std::span<std::span<uint8_t const> const> v) {
+    using io::writev;
+    long total = 0;
+    for (auto p : v) {
+      total += p.size();
+    }
+    for (size_t i = 0; i < sizeof...(Ts); ++i) {
+      auto [n, err] = detail::visit_at([&](auto& w) {
+        return writev(w, v);
+      }, writers_, i);
+      if (err != nil) {
+        return {n, err};
+      }
+      if (n != total) {
+        return {n, error::short_write};
+      }
+    }
+    return {total, nil};
+  }
+
   std::pair<long, std::error_code> write_string(std::string_view s) {
     using io::write_string;
     for (size_t i = 0; i < sizeof...(Ts); ++i) {
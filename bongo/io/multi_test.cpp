@@ -1,8 +1,11 @@
 // Copyright The Go Authors.
 
+#include <array>
+#include <span>
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <tuple>
 #include <vector>
 
 #include <catch2/catch.hpp>
@@ -56,6 +59,32 @@ TEST_CASE("Multi reader", "[io]") {
   });
 }
 
+TEST_CASE("Multi reader readv", "[io]") {
+  // Readers without readv fill the first buffer only
+  auto r1 = bytes::buffer{};
+  r1.write_string("foo ");
+  auto r2 = strings::reader{""};
+  auto r3 = strings::reader{"bar"};
+  auto mr = multi_reader{r1, r2, r3};
+  auto b1 = std::vector<uint8_t>(2);
+  auto b2 = std::vector<uint8_t>(3);
+  auto v = std::array{std::span{b1}, std::span{b2}};
+  auto [n, err] = mr.readv(v);
+  CHECK(n == 4);
+  CHECK(err == nil);
+  CHECK(std::string{bytes::to_string(b1)}.append(bytes::to_string(b2, 2)) == "foo ");
+  std::tie(n, err) = mr.readv(v);
+  CHECK(n == 2);
+  CHECK(err == nil);
+  CHECK(bytes::to_string(b1) == "ba");
+  std::tie(n, err) = mr.readv(v);
+  CHECK(n == 1);
+  CHECK(err == nil);
+  std::tie(n, err) = mr.readv(v);
+  CHECK(n == 0);
+  CHECK(err == eof);
+}
+
 TEST_CASE("Multi reader as writer", "[io]") {
   // TODO
 }
@@ -85,4 +114,18 @@ TEST_CASE("Multi writer string", "[io]") {
   // TODO
 }
 
+TEST_CASE("Multi writer writev", "[io]") {
+  auto b1 = bytes::buffer{};
+  auto b2 = bytes::buffer{};
+  auto sha1 = sha1::hash{};
+  auto mw = multi_writer{b1, sha1, b2};
+  auto v = std::array{bytes::to_bytes(std::string_view{"My input "}), bytes::to_bytes(std::string_view{"text."})};
+  auto [n, err] = writev(mw, v);
+  CHECK(n == 14);
+  CHECK(err == nil);
+  CHECK(b1.str() == "My input text.");
+  CHECK(b2.str() == "My input text.");
+  CHECK(fmt::sprintf("%x", sha1.sum()) == "01cb303fa8c30a64123067c5aa6284ba7ec2d31b");
+}
+
 }  // namespace bongo::io
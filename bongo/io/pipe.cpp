@@ -1,50 +1,78 @@
 // Copyright The Go Authors.
 
 #include <algorithm>
-#include <memory>
+#include <functional>
 #include <mutex>
-#include <optional>
 #include <span>
 #include <system_error>
-#include <thread>
 #include <utility>
-#include <variant>
-#include <vector>
 
 #include "bongo/bongo.h"
+#include "bongo/context.h"
 #include "bongo/io/detail/once_error.h"
 #include "bongo/io/io.h"
 #include "bongo/io/pipe.h"
+#include "bongo/runtime/defer.h"
 
 namespace bongo::io {
 
 std::pair<long, std::error_code> pipe::read(std::span<uint8_t> b) {
-  std::optional<std::monostate> d;
-  switch (select(
-    recv_select_case(done_, d),
-    default_select_case()
-  )) {
-  case 0:
-    return {0, read_close_error()};
-  default:
-    break;
+  return read(nullptr, b);
+}
+
+std::pair<long, std::error_code> pipe::read(context::context_type const& ctx, std::span<uint8_t> b) {
+  {
+    auto lock = std::lock_guard{mutex_};
+    if (done_) {
+      return {0, read_close_error()};
+    }
+  }
+  if (ctx != nullptr) {
+    if (auto err = ctx->err(); err) {
+      return {0, err};
+    }
   }
 
-  long nr = 0;
-  std::optional<std::vector<uint8_t>> bw;
-  switch (select(
-    recv_select_case(wr_chan_, bw),
-    recv_select_case(done_, d)
-  )) {
-  case 0:
-    nr = static_cast<long>(std::min(bw->size(), b.size()));
-    std::copy_n(bw->begin(), nr, b.begin());
-    rd_chan_ << nr;
-    return {nr, nil};
-  case 1:
-  default:
+  // Set by the watch, guarded by mutex_. The watch is stopped after the lock
+  // is released.
+  auto canceled = false;
+  auto stop = watch(ctx, canceled);
+  auto _ = runtime::defer([&stop]() {
+    if (stop) {
+      stop();
+    }
+  });
+  auto lock = std::unique_lock{mutex_};
+  // Wait for other readers to finish
+  rd_cond_.wait(lock, [&]() { return !rd_waiting_ || done_ || canceled; });
+  if (done_) {
+    return {0, read_close_error()};
+  }
+  if (canceled) {
+    lock.unlock();
+    return {0, ctx->err()};
+  }
+  rd_buf_ = b;
+  rd_waiting_ = true;
+  rd_n_ = -1;
+  wr_cond_.notify_one();
+  rd_cond_.wait(lock, [&]() { return rd_n_ >= 0 || done_ || canceled; });
+  auto n = rd_n_;
+  rd_buf_ = {};
+  rd_waiting_ = false;
+  rd_n_ = -1;
+  rd_cond_.notify_all();
+  if (n >= 0) {
+    // Data copied by a writer is returned even if the pipe was closed
+    return {n, nil};
+  }
+  if (done_) {
     return {0, read_close_error()};
   }
+  // The context is not consulted while holding mutex_, since canceling it
+  // runs the watch, which takes mutex_.
+  lock.unlock();
+  return {0, ctx->err()};
 }
 
 std::error_code pipe::close_read(std::error_code err) {
@@ -52,39 +80,55 @@ std::error_code pipe::close_read(std::error_code err) {
     err = error::closed_pipe;
   }
   rd_err_.store(err);
-  std::call_once(once_, [this]() { done_.close(); });
+  auto lock = std::lock_guard{mutex_};
+  done_ = true;
+  rd_cond_.notify_all();
+  wr_cond_.notify_all();
   return nil;
 }
 
 std::pair<long, std::error_code> pipe::write(std::span<uint8_t const> b) {
-  auto lock = std::unique_lock<std::mutex>{wr_mutex_, std::defer_lock};
-  std::optional<std::monostate> d;
-  switch (select(
-    recv_select_case(done_, d),
-    default_select_case()
-  )) {
-  case 0:
-    return {0, write_close_error()};
-  default:
-    lock.lock();
-    break;
+  return write(nullptr, b);
+}
+
+std::pair<long, std::error_code> pipe::write(context::context_type const& ctx, std::span<uint8_t const> b) {
+  {
+    auto lock = std::lock_guard{mutex_};
+    if (done_) {
+      return {0, write_close_error()};
+    }
+  }
+  if (ctx != nullptr) {
+    if (auto err = ctx->err(); err) {
+      return {0, err};
+    }
   }
 
+  auto wr_lock = std::lock_guard{wr_mutex_};
+  auto canceled = false;
+  auto stop = watch(ctx, canceled);
+  auto _ = runtime::defer([&stop]() {
+    if (stop) {
+      stop();
+    }
+  });
+  auto lock = std::unique_lock{mutex_};
   long n = 0;
   for (auto once = true; once || b.size() > 0; once = false) {
-    long nw;
-    switch (select(
-      send_select_case(wr_chan_, std::vector<uint8_t>{b.begin(), b.end()}),
-      recv_select_case(done_, d)
-    )) {
-    case 0:
-      nw << rd_chan_;
-      b = b.subspan(nw);
-      n += nw;
-      break;
-    case 1:
+    wr_cond_.wait(lock, [&]() { return (rd_waiting_ && rd_n_ < 0) || done_ || canceled; });
+    if (done_) {
       return {n, write_close_error()};
     }
+    if (canceled) {
+      lock.unlock();
+      return {n, ctx->err()};
+    }
+    auto nw = std::min(b.size(), rd_buf_.size());
+    std::copy_n(b.begin(), nw, rd_buf_.begin());
+    rd_n_ = static_cast<long>(nw);
+    rd_cond_.notify_all();
+    b = b.subspan(nw);
+    n += nw;
   }
   return {n, nil};
 }
@@ -94,10 +138,30 @@ std::error_code pipe::close_write(std::error_code err) {
     err = io::eof;
   }
   wr_err_.store(err);
-  std::call_once(once_, [this]() { done_.close(); });
+  auto lock = std::lock_guard{mutex_};
+  done_ = true;
+  rd_cond_.notify_all();
+  wr_cond_.notify_all();
   return nil;
 }
 
+// Sets canceled and wakes the waiters when ctx is done. canceled is guarded
+// by mutex_, so waiters test it instead of calling into ctx, whose mutex is
+// held while this callback runs. Returns a function that stops the watch,
+// which must not be called with mutex_ held. Once it returns the callback
+// has either completed or will never run.
+std::function<bool()> pipe::watch(context::context_type const& ctx, bool& canceled) {
+  if (ctx == nullptr || ctx->done() == nullptr) {
+    return nullptr;
+  }
+  return context::after_func(ctx, [this, &canceled]() {
+    auto lock = std::lock_guard{mutex_};
+    canceled = true;
+    rd_cond_.notify_all();
+    wr_cond_.notify_all();
+  });
+}
+
 std::error_code pipe::read_close_error() {
   auto rd_err = rd_err_.load();
   if (auto wr_err = wr_err_.load(); rd_err == nil && wr_err != nil) {
@@ -2,28 +2,33 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <functional>
 #include <memory>
 #include <mutex>
-#include <optional>
 #include <span>
 #include <system_error>
-#include <thread>
 #include <utility>
-#include <variant>
-#include <vector>
 
 #include <bongo/bongo.h>
+#include <bongo/context/context.h>
 #include <bongo/io/detail/once_error.h>
 #include <bongo/io/io.h>
 
 namespace bongo::io {
 
+// The shared state of a pipe. A reader publishes its buffer and waits, and
+// a writer copies its data directly into the published buffer, so data is
+// copied once and nothing is allocated per write.
 class pipe {
-  std::mutex wr_mutex_;
-  chan<std::vector<uint8_t>> wr_chan_;
-  chan<long> rd_chan_;
-  std::once_flag once_;
-  chan<std::monostate> done_;
+  std::mutex wr_mutex_;  // serializes writers
+  std::mutex mutex_;     // guards the fields below
+  std::condition_variable rd_cond_;  // data was copied, a reader left or the pipe closed
+  std::condition_variable wr_cond_;  // a reader published a buffer or the pipe closed
+  std::span<uint8_t> rd_buf_;        // buffer of the waiting reader
+  bool rd_waiting_ = false;          // a reader published rd_buf_
+  long rd_n_ = -1;                   // bytes copied into rd_buf_, or -1
+  bool done_ = false;
   detail::once_error rd_err_;
   detail::once_error wr_err_;
 
@@ -31,11 +36,14 @@ class pipe {
   pipe() = default;
 
   std::pair<long, std::error_code> read(std::span<uint8_t> b);
+  std::pair<long, std::error_code> read(context::context_type const& ctx, std::span<uint8_t> b);
   std::error_code close_read(std::error_code err);
   std::pair<long, std::error_code> write(std::span<uint8_t const> b);
+  std::pair<long, std::error_code> write(context::context_type const& ctx, std::span<uint8_t const> b);
   std::error_code close_write(std::error_code err);
 
  private:
+  std::function<bool()> watch(context::context_type const& ctx, bool& canceled);
   std::error_code read_close_error();
   std::error_code write_close_error();
 };
@@ -52,6 +60,11 @@ class pipe_reader {
     return p_->read(data);
   }
 
+  // Read data, giving up with the context error once ctx is done.
+  std::pair<long, std::error_code> read(context::context_type const& ctx, std::span<uint8_t> data) {
+    return p_->read(ctx, data);
+  }
+
   std::error_code close() {
     return close_with_error(nil);
   }
@@ -73,6 +86,12 @@ class pipe_writer {
     return p_->write(data);
   }
 
+  // Write data, giving up with the context error once ctx is done. Data
+  // already consumed by a reader is reported in the returned count.
+  std::pair<long, std::error_code> write(context::context_type const& ctx, std::span<uint8_t const> data) {
+    return p_->write(ctx, data);
+  }
+
   std::error_code close() {
     return close_with_error(nil);
   }
@@ -9,6 +9,7 @@
 
 #include "bongo/bongo.h"
 #include "bongo/bytes.h"
+#include "bongo/context.h"
 #include "bongo/io.h"
 #include "bongo/strings.h"
 
@@ -417,4 +418,153 @@ TEST_CASE("Pipe: concurrent", "[io]") {
   }
 }
 
+TEST_CASE("Pipe: context canceled during read", "[io]") {
+  pipe_reader r;
+  pipe_writer w;
+  std::tie(r, w) = make_pipe();
+  auto [ctx, cancel] = context::with_cancel(context::background());
+  auto t = std::thread{[&]() {
+    std::this_thread::sleep_for(1ms);
+    cancel();
+  }};
+  auto buf = std::vector<uint8_t>(64);
+  auto [n, err] = r.read(ctx, buf);
+  CHECK(n == 0);
+  CHECK(err == context::error::canceled);
+  t.join();
+
+  // The pipe is still usable after the context is canceled
+  t = std::thread{[&]() {
+    write_string(w, "hello");
+  }};
+  std::tie(n, err) = r.read(context::background(), buf);
+  CHECK(err == nil);
+  CHECK(bytes::to_string(buf, n) == "hello");
+  t.join();
+}
+
+TEST_CASE("Pipe: context canceled while another reader waits", "[io]") {
+  pipe_reader r;
+  pipe_writer w;
+  std::tie(r, w) = make_pipe();
+  auto buf1 = std::vector<uint8_t>(64);
+  auto c = chan<pipe_return>{};
+  auto t1 = std::thread{[&]() {
+    auto [n, err] = r.read(buf1);
+    c << pipe_return{n, err};
+  }};
+  std::this_thread::sleep_for(1ms);
+
+  auto [ctx, cancel] = context::with_timeout(context::background(), 1ms);
+  auto buf2 = std::vector<uint8_t>(64);
+  auto [n, err] = r.read(ctx, buf2);
+  CHECK(n == 0);
+  CHECK(err == context::error::deadline_exceeded);
+  cancel();
+
+  std::tie(n, err) = write_string(w, "hello");
+  CHECK(n == 5);
+  CHECK(err == nil);
+  auto pr = pipe_return{};
+  pr << c;
+  CHECK(pr.n == 5);
+  CHECK(pr.err == nil);
+  CHECK(bytes::to_string(buf1, pr.n) == "hello");
+  t1.join();
+}
+
+TEST_CASE("Pipe: context deadline during write", "[io]") {
+  pipe_reader r;
+  pipe_writer w;
+  std::tie(r, w) = make_pipe();
+  auto [ctx, cancel] = context::with_timeout(context::background(), 1ms);
+  auto [n, err] = w.write(ctx, bytes::to_bytes(std::string_view{"hello"}));
+  CHECK(n == 0);
+  CHECK(err == context::error::deadline_exceeded);
+  cancel();
+
+  std::tie(n, err) = w.write(ctx, bytes::to_bytes(std::string_view{"hello"}));
+  CHECK(n == 0);
+  CHECK(err == context::error::deadline_exceeded);
+}
+
+TEST_CASE("Pipe: context canceled during concurrent read and write", "[io]") {
+  // Canceling runs the watch while the context is locked, so waiters must
+  // not consult the context while holding the pipe lock.
+  for (int i = 0; i < 100; ++i) {
+    pipe_reader r;
+    pipe_writer w;
+    std::tie(r, w) = make_pipe();
+    auto [ctx, cancel] = context::with_cancel(context::background());
+    auto werr = std::error_code{};
+    auto tw = std::thread{[&, &ctx = ctx]() {
+      auto b = std::vector<uint8_t>{'x'};
+      for (;;) {
+        if (auto [n, err] = w.write(ctx, b); err) {
+          werr = err;
+          return;
+        }
+      }
+    }};
+    auto rerr = std::error_code{};
+    auto tr = std::thread{[&, &ctx = ctx]() {
+      auto b = std::vector<uint8_t>(1);
+      for (;;) {
+        if (auto [n, err] = r.read(ctx, b); err) {
+          rerr = err;
+          return;
+        }
+      }
+    }};
+    std::this_thread::sleep_for(100us);
+    cancel();
+    tw.join();
+    tr.join();
+    CHECK(werr == context::error::canceled);
+    CHECK(rerr == context::error::canceled);
+  }
+}
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+TEST_CASE("Pipe benchmarks", "[!benchmark]") {
+  // Each run moves total bytes from a writer thread to a reader with a
+  // 64 KiB buffer.
+  auto run = [](long size, long total) {
+    auto [r, w] = make_pipe();
+    auto t = std::thread{[&, w = w]() mutable {
+      auto data = std::vector<uint8_t>(size, 'x');
+      for (long n = 0; n < total; n += size) {
+        w.write(data);
+      }
+      w.close();
+    }};
+    auto buf = std::vector<uint8_t>(64 << 10);
+    long n = 0;
+    for (;;) {
+      auto [m, err] = r.read(buf);
+      n += m;
+      if (err) {
+        break;
+      }
+    }
+    t.join();
+    return n;
+  };
+
+  BENCHMARK("64 B writes (256 KiB)") {
+    return run(64, 256 << 10);
+  };
+
+  BENCHMARK("4 KiB writes (4 MiB)") {
+    return run(4 << 10, 4 << 20);
+  };
+
+  BENCHMARK("1 MiB writes (16 MiB)") {
+    return run(1 << 20, 16 << 20);
+  };
+}
+
+#endif  // defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
 }  // namespace bongo::io
@@ -0,0 +1,10 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <bongo/net/dial.h>
+#include <bongo/net/error.h>
+#include <bongo/net/ipsock.h>
+#include <bongo/net/net.h>
+#include <bongo/net/sharded.h>
+#include <bongo/net/udpsock.h>
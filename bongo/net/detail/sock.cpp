@@ -0,0 +1,413 @@
+// Copyright The Go Authors.
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "bongo/bongo.h"
+#include "bongo/context.h"
+#include "bongo/detail/poll.h"
+#include "bongo/net/detail/sock.h"
+#include "bongo/net/error.h"
+#include "bongo/net/ipsock.h"
+#include "bongo/net/net.h"
+
+namespace bongo::net::detail {
+namespace {
+
+std::error_code errno_error() {
+  return std::error_code{errno, std::system_category()};
+}
+
+sockaddr_any unix_sockaddr(std::string_view name) {
+  auto sa = sockaddr_any{};
+  auto un = reinterpret_cast<struct ::sockaddr_un*>(&sa.ss);
+  un->sun_family = AF_UNIX;
+  std::memcpy(un->sun_path, name.data(), name.size());
+  if (name.starts_with('@')) {
+    // Abstract socket names begin with a NUL byte and are not terminated.
+    un->sun_path[0] = '\0';
+    sa.len = static_cast<::socklen_t>(offsetof(struct ::sockaddr_un, sun_path) + name.size());
+  } else {
+    sa.len = static_cast<::socklen_t>(offsetof(struct ::sockaddr_un, sun_path) + name.size() + 1);
+  }
+  return sa;
+}
+
+sockaddr_any wildcard(int family, uint16_t port) {
+  auto sa = sockaddr_any{};
+  if (family == AF_INET6) {
+    auto in6 = reinterpret_cast<struct ::sockaddr_in6*>(&sa.ss);
+    in6->sin6_family = AF_INET6;
+    in6->sin6_addr = in6addr_any;
+    in6->sin6_port = htons(port);
+    sa.len = sizeof *in6;
+  } else {
+    auto in = reinterpret_cast<struct ::sockaddr_in*>(&sa.ss);
+    in->sin_family = AF_INET;
+    in->sin_addr.s_addr = htonl(INADDR_ANY);
+    in->sin_port = htons(port);
+    sa.len = sizeof *in;
+  }
+  return sa;
+}
+
+// Connects fd to ra, waiting for a non-blocking connect to complete.
+std::error_code connect(bongo::detail::poll::fd& fd, std::string_view network,
+                        sockaddr_any const& ra, context::context_type const* ctx) {
+  std::error_code err;
+  if (::connect(fd.sysfd, ra.get(), ra.len) == -1) {
+    err = errno_error();
+  }
+  if (err && err != std::errc::operation_in_progress && err != std::errc::connection_already_in_progress &&
+      err != std::errc::interrupted) {
+    return err;
+  }
+  if (auto err1 = fd.init(network, true); err1) {
+    return err1;
+  }
+  if (!err) {
+    return nil;
+  }
+  for (;;) {
+    // Performing multiple connect system calls on a non-blocking socket
+    // under Unix variants does not necessarily result in earlier errors
+    // being returned. Instead, once runtime-integrated network poller tells
+    // us that the socket is ready, get the SO_ERROR socket option to see if
+    // the connection succeeded or failed.
+    if (auto err1 = ctx != nullptr ? fd.wait_write(*ctx) : fd.wait_write(); err1) {
+      return err1;
+    }
+    auto [nerr, err2] = getsockopt_int(fd.sysfd, SOL_SOCKET, SO_ERROR);
+    if (err2) {
+      return err2;
+    }
+    switch (nerr) {
+    case EINPROGRESS:
+    case EALREADY:
+    case EINTR:
+      continue;
+    case EISCONN:
+      return nil;
+    case 0:
+      // The runtime poller can wake us up spuriously, see issues 14548 and
+      // 19289. Check that we are connected before returning.
+      if (auto [_, err3] = getpeername(fd.sysfd); !err3) {
+        return nil;
+      }
+      continue;
+    default:
+      return std::error_code{nerr, std::system_category()};
+    }
+  }
+}
+
+}  // namespace
+
+std::pair<network_type, std::error_code> parse_network(std::string_view network) {
+  if (network == "tcp") {
+    return {{AF_UNSPEC, SOCK_STREAM}, nil};
+  }
+  if (network == "tcp4") {
+    return {{AF_INET, SOCK_STREAM}, nil};
+  }
+  if (network == "tcp6") {
+    return {{AF_INET6, SOCK_STREAM}, nil};
+  }
+  if (network == "udp") {
+    return {{AF_UNSPEC, SOCK_DGRAM}, nil};
+  }
+  if (network == "udp4") {
+    return {{AF_INET, SOCK_DGRAM}, nil};
+  }
+  if (network == "udp6") {
+    return {{AF_INET6, SOCK_DGRAM}, nil};
+  }
+  if (network == "unix") {
+    return {{AF_UNIX, SOCK_STREAM}, nil};
+  }
+  return {{}, error::unknown_network};
+}
+
+std::pair<std::vector<sockaddr_any>, std::error_code> resolve(
+    std::string_view network, std::string_view address, bool passive) {
+  auto [nt, err] = parse_network(network);
+  if (err) {
+    return {{}, err};
+  }
+  if (nt.family == AF_UNIX) {
+    if (address.empty()) {
+      return {{}, error::missing_address};
+    }
+    if (address.size() >= sizeof(::sockaddr_un::sun_path)) {
+      return {{}, std::make_error_code(std::errc::invalid_argument)};
+    }
+    return {{unix_sockaddr(address)}, nil};
+  }
+
+  auto [host, port, err1] = split_host_port(address);
+  if (err1) {
+    return {{}, err1};
+  }
+  if (host.empty() && !passive) {
+    return {{}, error::missing_address};
+  }
+  auto service = port.empty() ? std::string{"0"} : std::string{port};
+
+  struct ::addrinfo hints = {};
+  hints.ai_family = nt.family;
+  hints.ai_socktype = nt.sotype;
+  if (host.empty()) {
+    // Listen on all addresses. For "tcp" prefer a dual-stack IPv6 socket
+    // and fall back to IPv4 if IPv6 is not available.
+    struct ::addrinfo* res = nullptr;
+    hints.ai_flags = AI_PASSIVE;
+    if (auto rc = ::getaddrinfo(nullptr, service.c_str(), &hints, &res); rc != 0) {
+      return {{}, error::invalid_port};
+    }
+    uint16_t p = 0;
+    if (res->ai_family == AF_INET6) {
+      p = ntohs(reinterpret_cast<struct ::sockaddr_in6*>(res->ai_addr)->sin6_port);
+    } else {
+      p = ntohs(reinterpret_cast<struct ::sockaddr_in*>(res->ai_addr)->sin_port);
+    }
+    ::freeaddrinfo(res);
+    switch (nt.family) {
+    case AF_INET:
+      return {{wildcard(AF_INET, p)}, nil};
+    case AF_INET6:
+      return {{wildcard(AF_INET6, p)}, nil};
+    default:
+      return {{wildcard(AF_INET6, p), wildcard(AF_INET, p)}, nil};
+    }
+  }
+
+  // getaddrinfo accepts an IPv6 zone as a scope suffix, as in "fe80::1%lo".
+  struct ::addrinfo* res = nullptr;
+  auto node = std::string{host};
+  if (auto rc = ::getaddrinfo(node.c_str(), service.c_str(), &hints, &res); rc != 0) {
+    if (rc == EAI_SERVICE) {
+      return {{}, error::invalid_port};
+    }
+    if (rc == EAI_SYSTEM) {
+      return {{}, errno_error()};
+    }
+    return {{}, error::no_such_host};
+  }
+  auto addrs = std::vector<sockaddr_any>{};
+  for (auto ai = res; ai != nullptr; ai = ai->ai_next) {
+    if (ai->ai_addrlen > sizeof(struct ::sockaddr_storage)) {
+      continue;
+    }
+    auto sa = sockaddr_any{};
+    std::memcpy(&sa.ss, ai->ai_addr, ai->ai_addrlen);
+    sa.len = ai->ai_addrlen;
+    addrs.push_back(sa);
+  }
+  ::freeaddrinfo(res);
+  if (addrs.empty()) {
+    return {{}, error::no_suitable_address};
+  }
+  return {std::move(addrs), nil};
+}
+
+addr to_addr(std::string_view network, sockaddr_any const& sa) {
+  char buf[INET6_ADDRSTRLEN];
+  switch (sa.family()) {
+  case AF_INET: {
+    auto in = reinterpret_cast<struct ::sockaddr_in const*>(&sa.ss);
+    ::inet_ntop(AF_INET, &in->sin_addr, buf, sizeof buf);
+    return {std::string{network}, join_host_port(buf, std::to_string(ntohs(in->sin_port)))};
+  }
+  case AF_INET6: {
+    auto in6 = reinterpret_cast<struct ::sockaddr_in6 const*>(&sa.ss);
+    ::inet_ntop(AF_INET6, &in6->sin6_addr, buf, sizeof buf);
+    return {std::string{network}, join_host_port(buf, std::to_string(ntohs(in6->sin6_port)))};
+  }
+  case AF_UNIX: {
+    auto un = reinterpret_cast<struct ::sockaddr_un const*>(&sa.ss);
+    auto n = static_cast<long>(sa.len) - static_cast<long>(offsetof(struct ::sockaddr_un, sun_path));
+    if (n <= 0) {
+      // Unnamed socket.
+      return {std::string{network}, ""};
+    }
+    auto name = std::string{un->sun_path, static_cast<size_t>(n)};
+    if (name[0] == '\0') {
+      name[0] = '@';
+    } else if (auto i = name.find('\0'); i != std::string::npos) {
+      name.resize(i);
+    }
+    return {std::string{network}, std::move(name)};
+  }
+  default:
+    return {std::string{network}, ""};
+  }
+}
+
+std::pair<std::unique_ptr<bongo::detail::poll::fd>, std::error_code> socket(int family, int sotype, int proto) {
+  auto s = ::socket(family, sotype|SOCK_NONBLOCK|SOCK_CLOEXEC, proto);
+  if (s == -1) {
+    return {nullptr, errno_error()};
+  }
+  auto is_stream = sotype == SOCK_STREAM;
+  auto zero_read_is_eof = sotype != SOCK_DGRAM && sotype != SOCK_RAW;
+  return {std::make_unique<bongo::detail::poll::fd>(s, is_stream, zero_read_is_eof), nil};
+}
+
+std::pair<socket_result, std::error_code> dial_socket(
+    context::context_type const* ctx, std::string_view network, std::string_view address) {
+  if (ctx != nullptr) {
+    if (auto err = (*ctx)->err(); err) {
+      return {socket_result{}, err};
+    }
+  }
+  auto [nt, err] = parse_network(network);
+  if (err) {
+    return {socket_result{}, err};
+  }
+  auto [addrs, err1] = resolve(network, address, false);
+  if (err1) {
+    return {socket_result{}, err1};
+  }
+  // Try each address in order and return the first error if all fail.
+  std::error_code first;
+  for (auto const& ra : addrs) {
+    auto [fd, err2] = socket(ra.family(), nt.sotype, 0);
+    if (!err2) {
+      err2 = connect(*fd, network, ra, ctx);
+    }
+    if (err2) {
+      if (!first) {
+        first = err2;
+      }
+      if (ctx != nullptr && (*ctx)->err()) {
+        break;
+      }
+      continue;
+    }
+    if (nt.sotype == SOCK_STREAM && ra.family() != AF_UNIX) {
+      setsockopt_int(fd->sysfd, IPPROTO_TCP, TCP_NODELAY, 1);
+    }
+    auto [lsa, err3] = getsockname(fd->sysfd);
+    if (err3) {
+      fd->close();
+      return {socket_result{}, err3};
+    }
+    return {socket_result{std::move(fd), lsa, ra}, nil};
+  }
+  return {socket_result{}, first};
+}
+
+std::pair<socket_result, std::error_code> listen_socket(
+    std::string_view network, std::string_view address, control_func const& control) {
+  auto [nt, err] = parse_network(network);
+  if (err) {
+    return {socket_result{}, err};
+  }
+  auto [addrs, err1] = resolve(network, address, true);
+  if (err1) {
+    return {socket_result{}, err1};
+  }
+  std::error_code first;
+  for (auto const& la : addrs) {
+    auto [fd, err2] = socket(la.family(), nt.sotype, 0);
+    if (err2) {
+      if (!first) {
+        first = err2;
+      }
+      // Fall back to the next address family, for example IPv4 on a host
+      // without IPv6.
+      if (err2 == std::errc::address_family_not_supported) {
+        continue;
+      }
+      break;
+    }
+    if (la.family() == AF_INET6 && nt.family == AF_UNSPEC) {
+      // Accept IPv4 traffic on a wildcard "tcp" or "udp" socket.
+      setsockopt_int(fd->sysfd, IPPROTO_IPV6, IPV6_V6ONLY, 0);
+    }
+    if (nt.sotype == SOCK_STREAM && la.family() != AF_UNIX) {
+      // Allow reuse of recently-used addresses.
+      if (err2 = setsockopt_int(fd->sysfd, SOL_SOCKET, SO_REUSEADDR, 1); err2) {
+        return {socket_result{}, err2};
+      }
+    }
+    if (control) {
+      if (err2 = control(fd->sysfd); err2) {
+        return {socket_result{}, err2};
+      }
+    }
+    if (::bind(fd->sysfd, la.get(), la.len) == -1) {
+      err2 = errno_error();
+      if (!first) {
+        first = err2;
+      }
+      if (err2 == std::errc::address_not_available) {
+        continue;
+      }
+      break;
+    }
+    if (nt.sotype == SOCK_STREAM && ::listen(fd->sysfd, SOMAXCONN) == -1) {
+      return {socket_result{}, errno_error()};
+    }
+    if (err2 = fd->init(network, true); err2) {
+      return {socket_result{}, err2};
+    }
+    auto [lsa, err3] = getsockname(fd->sysfd);
+    if (err3) {
+      fd->close();
+      return {socket_result{}, err3};
+    }
+    return {socket_result{std::move(fd), lsa, {}}, nil};
+  }
+  return {socket_result{}, first};
+}
+
+std::pair<sockaddr_any, std::error_code> getsockname(int fd) {
+  auto sa = sockaddr_any{};
+  sa.len = sizeof sa.ss;
+  if (::getsockname(fd, sa.get(), &sa.len) == -1) {
+    return {{}, errno_error()};
+  }
+  return {sa, nil};
+}
+
+std::pair<sockaddr_any, std::error_code> getpeername(int fd) {
+  auto sa = sockaddr_any{};
+  sa.len = sizeof sa.ss;
+  if (::getpeername(fd, sa.get(), &sa.len) == -1) {
+    return {{}, errno_error()};
+  }
+  return {sa, nil};
+}
+
+std::error_code setsockopt_int(int fd, int level, int opt, int value) {
+  if (::setsockopt(fd, level, opt, &value, sizeof value) == -1) {
+    return errno_error();
+  }
+  return nil;
+}
+
+std::pair<int, std::error_code> getsockopt_int(int fd, int level, int opt) {
+  int value = 0;
+  auto len = static_cast<::socklen_t>(sizeof value);
+  if (::getsockopt(fd, level, opt, &value, &len) == -1) {
+    return {0, errno_error()};
+  }
+  return {value, nil};
+}
+
+}  // namespace bongo::net::detail
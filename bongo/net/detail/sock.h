@@ -0,0 +1,77 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <sys/socket.h>
+
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <bongo/context/context.h>
+#include <bongo/detail/poll.h>
+#include <bongo/net/net.h>
+
+namespace bongo::net::detail {
+
+// A socket address in the form used by the system calls.
+struct sockaddr_any {
+  struct ::sockaddr_storage ss = {};
+  ::socklen_t len = 0;
+
+  int family() const noexcept { return ss.ss_family; }
+  struct ::sockaddr* get() noexcept { return reinterpret_cast<struct ::sockaddr*>(&ss); }
+  struct ::sockaddr const* get() const noexcept { return reinterpret_cast<struct ::sockaddr const*>(&ss); }
+};
+
+// Address family and socket type of a named network.
+struct network_type {
+  int family;  // AF_UNSPEC if either IPv4 or IPv6 may be used
+  int sotype;
+};
+
+std::pair<network_type, std::error_code> parse_network(std::string_view network);
+
+// Resolves address on the named network into a list of socket addresses to
+// try in order. If passive is true an empty host means the wildcard
+// address.
+std::pair<std::vector<sockaddr_any>, std::error_code> resolve(
+    std::string_view network, std::string_view address, bool passive);
+
+// Returns the string form of a socket address.
+addr to_addr(std::string_view network, sockaddr_any const& sa);
+
+// Creates a non-blocking, close-on-exec socket. The descriptor is not yet
+// registered with the poller.
+std::pair<std::unique_ptr<bongo::detail::poll::fd>, std::error_code> socket(int family, int sotype, int proto);
+
+// Called with a new socket before it is bound, to set socket options.
+using control_func = std::function<std::error_code(int fd)>;
+
+// A socket registered with the poller together with its local address and,
+// for a connected socket, its remote address.
+struct socket_result {
+  std::unique_ptr<bongo::detail::poll::fd> fd;
+  sockaddr_any laddr;
+  sockaddr_any raddr;
+};
+
+// Creates a socket connected to address, trying each resolved address in
+// order. If ctx is not null the attempt is abandoned when it is done.
+std::pair<socket_result, std::error_code> dial_socket(
+    context::context_type const* ctx, std::string_view network, std::string_view address);
+
+// Creates a socket bound to address. Stream sockets are also put into the
+// listening state.
+std::pair<socket_result, std::error_code> listen_socket(
+    std::string_view network, std::string_view address, control_func const& control = nullptr);
+
+std::pair<sockaddr_any, std::error_code> getsockname(int fd);
+std::pair<sockaddr_any, std::error_code> getpeername(int fd);
+std::error_code setsockopt_int(int fd, int level, int opt, int value);
+std::pair<int, std::error_code> getsockopt_int(int fd, int level, int opt);
+
+}  // namespace bongo::net::detail
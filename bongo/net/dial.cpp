@@ -0,0 +1,56 @@
+// Copyright The Go Authors.
+
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include "bongo/bongo.h"
+#include "bongo/context.h"
+#include "bongo/net/detail/sock.h"
+#include "bongo/net/dial.h"
+#include "bongo/net/error.h"
+#include "bongo/net/net.h"
+
+namespace bongo::net {
+namespace {
+
+std::pair<conn, std::error_code> dial_stream(context::context_type const* ctx, std::string_view network, std::string_view address) {
+  if (auto [nt, err] = detail::parse_network(network); err || nt.sotype != SOCK_STREAM) {
+    return {conn{}, error::unknown_network};
+  }
+  auto [s, err] = detail::dial_socket(ctx, network, address);
+  if (err) {
+    return {conn{}, err};
+  }
+  auto laddr = detail::to_addr(network, s.laddr);
+  auto raddr = detail::to_addr(network, s.raddr);
+  return {conn{std::move(s.fd), std::move(laddr), std::move(raddr)}, nil};
+}
+
+}  // namespace
+
+std::pair<conn, std::error_code> dial(std::string_view network, std::string_view address) {
+  return dial_stream(nullptr, network, address);
+}
+
+std::pair<conn, std::error_code> dial(context::context_type const& ctx, std::string_view network, std::string_view address) {
+  return dial_stream(&ctx, network, address);
+}
+
+std::pair<listener, std::error_code> listen(std::string_view network, std::string_view address) {
+  if (auto [nt, err] = detail::parse_network(network); err || nt.sotype != SOCK_STREAM) {
+    return {listener{}, error::unknown_network};
+  }
+  auto [s, err] = detail::listen_socket(network, address);
+  if (err) {
+    return {listener{}, err};
+  }
+  auto unlink = std::string{};
+  if (s.laddr.family() == AF_UNIX && !address.starts_with('@')) {
+    unlink = address;
+  }
+  return {listener{std::move(s.fd), detail::to_addr(network, s.laddr), std::move(unlink)}, nil};
+}
+
+}  // namespace bongo::net
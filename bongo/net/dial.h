@@ -0,0 +1,43 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <bongo/context/context.h>
+#include <bongo/net/net.h>
+
+namespace bongo::net {
+
+// Connects to the address on the named network.
+//
+// Known networks are "tcp", "tcp4" (IPv4-only), "tcp6" (IPv6-only) and
+// "unix". For TCP networks the address has the form "host:port". The host
+// may be a literal IP address or a host name that is resolved to one or
+// more addresses, which are tried in order. For Unix networks the address
+// is a file system path, or an abstract socket name if it begins with '@'.
+//
+// - https://golang.org/pkg/net/#Dial
+std::pair<conn, std::error_code> dial(std::string_view network, std::string_view address);
+
+// Like dial but the connection attempt is abandoned if ctx is done before
+// it completes. Once connected, the context has no effect on the
+// connection.
+//
+// - https://golang.org/pkg/net/#Dialer.DialContext
+std::pair<conn, std::error_code> dial(context::context_type const& ctx, std::string_view network, std::string_view address);
+
+// Announces on the local network address.
+//
+// The network must be "tcp", "tcp4", "tcp6" or "unix". For TCP networks, if
+// the host in the address is empty the listener listens on all available
+// addresses, and if the port is empty or "0" a port number is chosen
+// automatically. The local_addr method of the listener reports the chosen
+// address.
+//
+// - https://golang.org/pkg/net/#Listen
+std::pair<listener, std::error_code> listen(std::string_view network, std::string_view address);
+
+}  // namespace bongo::net
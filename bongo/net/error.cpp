@@ -0,0 +1,46 @@
+// Copyright The Go Authors.
+
+#include <system_error>
+
+#include "bongo/net/error.h"
+
+namespace bongo::net {
+namespace {
+
+struct error_category : std::error_category {
+  const char* name() const noexcept { return "net"; }
+  std::string message(int e) const {
+    switch (static_cast<error>(e)) {
+    case error::unknown_network:
+      return "unknown network";
+    case error::missing_address:
+      return "missing address";
+    case error::missing_port:
+      return "missing port in address";
+    case error::too_many_colons:
+      return "too many colons in address";
+    case error::missing_bracket:
+      return "missing ']' in address";
+    case error::unexpected_bracket:
+      return "unexpected bracket in address";
+    case error::invalid_port:
+      return "invalid port";
+    case error::no_such_host:
+      return "no such host";
+    case error::no_suitable_address:
+      return "no suitable address found";
+    default:
+      return "unrecognized error";
+    }
+  }
+};
+
+const error_category error_category{};
+
+}  // namespace
+
+std::error_code make_error_code(error e) {
+  return {static_cast<int>(e), error_category};
+}
+
+}  // namespace bongo::net
@@ -0,0 +1,30 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <system_error>
+
+namespace bongo::net {
+
+enum class error {
+  unknown_network = 1,
+  missing_address,
+  missing_port,
+  too_many_colons,
+  missing_bracket,
+  unexpected_bracket,
+  invalid_port,
+  no_such_host,
+  no_suitable_address,
+};
+
+std::error_code make_error_code(error e);
+
+}  // namespace bongo::net
+
+namespace std {
+
+template <>
+struct is_error_code_enum<bongo::net::error> : true_type {};
+
+}  // namespace std
@@ -0,0 +1,69 @@
+// Copyright The Go Authors.
+
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+
+#include "bongo/bongo.h"
+#include "bongo/net/error.h"
+#include "bongo/net/ipsock.h"
+
+namespace bongo::net {
+
+std::tuple<std::string_view, std::string_view, std::error_code> split_host_port(std::string_view hostport) {
+  std::string_view host;
+  long j = 0;
+  long k = 0;
+
+  // The port starts after the last colon.
+  auto i = hostport.rfind(':');
+  if (i == std::string_view::npos) {
+    return {"", "", error::missing_port};
+  }
+
+  if (hostport.starts_with('[')) {
+    // Expect the first ']' just before the last ':'.
+    auto end = hostport.find(']');
+    if (end == std::string_view::npos) {
+      return {"", "", error::missing_bracket};
+    }
+    if (end + 1 == hostport.size()) {
+      // There can't be a ':' behind the ']' now.
+      return {"", "", error::missing_port};
+    }
+    if (end + 1 != i) {
+      // Either ']' isn't followed by a colon, or it is followed by a colon
+      // that is not the last one.
+      if (hostport[end+1] == ':') {
+        return {"", "", error::too_many_colons};
+      }
+      return {"", "", error::missing_port};
+    }
+    host = hostport.substr(1, end - 1);
+    j = 1;
+    k = static_cast<long>(end) + 1;  // there can't be a '[' resp. ']' before these positions
+  } else {
+    host = hostport.substr(0, i);
+    if (host.find(':') != std::string_view::npos) {
+      return {"", "", error::too_many_colons};
+    }
+  }
+  if (hostport.find('[', j) != std::string_view::npos) {
+    return {"", "", error::unexpected_bracket};
+  }
+  if (hostport.find(']', k) != std::string_view::npos) {
+    return {"", "", error::unexpected_bracket};
+  }
+  return {host, hostport.substr(i + 1), nil};
+}
+
+std::string join_host_port(std::string_view host, std::string_view port) {
+  // We assume that host is a literal IPv6 address if host has colons.
+  if (host.find(':') != std::string_view::npos) {
+    return "[" + std::string{host} + "]:" + std::string{port};
+  }
+  return std::string{host} + ":" + std::string{port};
+}
+
+}  // namespace bongo::net
@@ -0,0 +1,28 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+
+namespace bongo::net {
+
+// Splits a network address of the form "host:port", "host%zone:port",
+// "[host]:port" or "[host%zone]:port" into host or host%zone and port.
+//
+// A literal IPv6 address in hostport must be enclosed in square brackets,
+// as in "[::1]:80", "[::1%lo0]:80".
+//
+// - https://golang.org/pkg/net/#SplitHostPort
+std::tuple<std::string_view, std::string_view, std::error_code> split_host_port(std::string_view hostport);
+
+// Combines host and port into a network address of the form "host:port". If
+// host contains a colon, as found in literal IPv6 addresses, then join_host_port
+// returns "[host]:port".
+//
+// - https://golang.org/pkg/net/#JoinHostPort
+std::string join_host_port(std::string_view host, std::string_view port);
+
+}  // namespace bongo::net
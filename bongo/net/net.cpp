@@ -0,0 +1,177 @@
+// Copyright The Go Authors.
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <utility>
+
+#include "bongo/bongo.h"
+#include "bongo/context.h"
+#include "bongo/detail/poll.h"
+#include "bongo/net/detail/sock.h"
+#include "bongo/net/net.h"
+
+namespace bongo::net {
+
+std::pair<long, std::error_code> conn::read(std::span<uint8_t> b) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  return pfd_->read(b);
+}
+
+std::pair<long, std::error_code> conn::write(std::span<uint8_t const> b) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  return pfd_->write(b);
+}
+
+std::pair<long, std::error_code> conn::readv(std::span<std::span<uint8_t> const> v) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  return pfd_->readv(v);
+}
+
+std::pair<long, std::error_code> conn::writev(std::span<std::span<uint8_t const> const> v) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  return pfd_->writev(v);
+}
+
+std::pair<long, std::error_code> conn::read(context::context_type const& ctx, std::span<uint8_t> b) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  return pfd_->read(ctx, b);
+}
+
+std::pair<long, std::error_code> conn::write(context::context_type const& ctx, std::span<uint8_t const> b) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  return pfd_->write(ctx, b);
+}
+
+std::error_code conn::close() {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  return pfd_->close();
+}
+
+std::error_code conn::close_read() {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  return pfd_->shutdown(SHUT_RD);
+}
+
+std::error_code conn::close_write() {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  return pfd_->shutdown(SHUT_WR);
+}
+
+std::error_code conn::set_deadline(std::chrono::system_clock::time_point t) {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  return pfd_->set_deadline(t);
+}
+
+std::error_code conn::set_read_deadline(std::chrono::system_clock::time_point t) {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  return pfd_->set_read_deadline(t);
+}
+
+std::error_code conn::set_write_deadline(std::chrono::system_clock::time_point t) {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  return pfd_->set_write_deadline(t);
+}
+
+std::error_code conn::set_no_delay(bool no_delay) {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  return pfd_->setsockopt_int(IPPROTO_TCP, TCP_NODELAY, no_delay ? 1 : 0);
+}
+
+std::error_code conn::check_valid() const {
+  if (!pfd_) {
+    return std::make_error_code(std::errc::invalid_argument);
+  }
+  return nil;
+}
+
+std::pair<conn, std::error_code> listener::accept() {
+  if (auto err = check_valid(); err) {
+    return {conn{}, err};
+  }
+  auto rsa = detail::sockaddr_any{};
+  auto [s, err] = pfd_->accept(&rsa.ss);
+  if (err) {
+    return {conn{}, err};
+  }
+  auto pfd = std::make_unique<bongo::detail::poll::fd>(s, true, true);
+  if (auto err1 = pfd->init(laddr_.network(), true); err1) {
+    pfd->close();
+    return {conn{}, err1};
+  }
+  auto [lsa, err2] = detail::getsockname(s);
+  if (err2) {
+    pfd->close();
+    return {conn{}, err2};
+  }
+  if (rsa.family() == AF_INET || rsa.family() == AF_INET6) {
+    rsa.len = rsa.family() == AF_INET ? sizeof(struct ::sockaddr_in) : sizeof(struct ::sockaddr_in6);
+    detail::setsockopt_int(s, IPPROTO_TCP, TCP_NODELAY, 1);
+  } else {
+    // The peer of an accepted Unix socket is usually unnamed.
+    std::tie(rsa, std::ignore) = detail::getpeername(s);
+  }
+  auto laddr = detail::to_addr(laddr_.network(), lsa);
+  auto raddr = detail::to_addr(laddr_.network(), rsa);
+  return {conn{std::move(pfd), std::move(laddr), std::move(raddr)}, nil};
+}
+
+std::error_code listener::close() {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  auto err = pfd_->close();
+  if (!unlink_.empty()) {
+    ::unlink(unlink_.c_str());
+    unlink_.clear();
+  }
+  return err;
+}
+
+std::error_code listener::set_deadline(std::chrono::system_clock::time_point t) {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  return pfd_->set_deadline(t);
+}
+
+std::error_code listener::check_valid() const {
+  if (!pfd_) {
+    return std::make_error_code(std::errc::invalid_argument);
+  }
+  return nil;
+}
+
+}  // namespace bongo::net
@@ -0,0 +1,193 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <bongo/context/context.h>
+#include <bongo/detail/poll.h>
+#include <bongo/detail/poll/zero_copy_linux.h>
+#include <bongo/io/io.h>
+
+namespace bongo::net {
+
+/**
+ * A network end point address.
+ *
+ * - https://golang.org/pkg/net/#Addr
+ */
+class addr {
+  std::string network_;
+  std::string address_;
+
+ public:
+  addr() = default;
+  addr(std::string network, std::string address)
+      : network_{std::move(network)}
+      , address_{std::move(address)} {}
+
+  // Name of the network, for example "tcp" or "unix".
+  std::string const& network() const noexcept { return network_; }
+
+  // String form of the address, for example "192.0.2.1:25" or "[2001:db8::1]:80".
+  std::string const& string() const noexcept { return address_; }
+};
+
+/**
+ * A stream-oriented network connection.
+ *
+ * Sockets are non-blocking. A read or write that would block parks the
+ * calling thread until the runtime network poller reports readiness or a
+ * deadline expires.
+ *
+ * - https://golang.org/pkg/net/#Conn
+ */
+class conn {
+  std::unique_ptr<bongo::detail::poll::fd> pfd_;
+  addr laddr_;
+  addr raddr_;
+
+ public:
+  conn() = default;
+  conn(std::unique_ptr<bongo::detail::poll::fd> fd, addr laddr, addr raddr)
+      : pfd_{std::move(fd)}
+      , laddr_{std::move(laddr)}
+      , raddr_{std::move(raddr)} {}
+  conn(conn const& other) = delete;
+  conn& operator=(conn const& other) = delete;
+  conn(conn&& other) = default;
+  conn& operator=(conn&& other) = default;
+  ~conn() = default;
+
+  std::pair<long, std::error_code> read(std::span<uint8_t> b);
+  std::pair<long, std::error_code> write(std::span<uint8_t const> b);
+
+  // Vectored read and write with readv(2) and writev(2), implementing
+  // io::ReaderV and io::WriterV. A header and body are written in one
+  // system call without copying them together.
+  std::pair<long, std::error_code> readv(std::span<std::span<uint8_t> const> v);
+  std::pair<long, std::error_code> writev(std::span<std::span<uint8_t const> const> v);
+
+  // Context-aware read and write. These return the context error if ctx is
+  // done before the operation completes.
+  std::pair<long, std::error_code> read(context::context_type const& ctx, std::span<uint8_t> b);
+  std::pair<long, std::error_code> write(context::context_type const& ctx, std::span<uint8_t const> b);
+
+  std::error_code close();
+
+  // Shuts down the reading or writing side of the connection.
+  std::error_code close_read();
+  std::error_code close_write();
+
+  addr const& local_addr() const noexcept { return laddr_; }
+  addr const& remote_addr() const noexcept { return raddr_; }
+
+  std::error_code set_deadline(std::chrono::system_clock::time_point t);
+  std::error_code set_read_deadline(std::chrono::system_clock::time_point t);
+  std::error_code set_write_deadline(std::chrono::system_clock::time_point t);
+
+  // Controls whether the operating system should delay packet transmission
+  // in hopes of sending fewer packets (Nagle's algorithm). The default is
+  // true (no delay) for TCP connections.
+  std::error_code set_no_delay(bool no_delay);
+
+  // Implement io::ReaderFrom and io::WriterTo. When the other end is also
+  // backed by a descriptor, such as an os::file or another conn, the data
+  // is copied in the kernel with sendfile or splice.
+  //
+  // - https://golang.org/pkg/net/#TCPConn.ReadFrom
+  // - https://golang.org/pkg/net/#TCPConn.WriteTo
+  template <typename U> requires io::ReaderFunc<U>
+  std::pair<int64_t, std::error_code> read_from(U& r);
+  template <typename U> requires io::WriterFunc<U>
+  std::pair<int64_t, std::error_code> write_to(U& w);
+
+  uintptr_t fd() const noexcept { return static_cast<uintptr_t>(pfd_->sysfd); }
+  bongo::detail::poll::fd* poll_fd() const noexcept { return pfd_.get(); }
+
+ private:
+  std::error_code check_valid() const;
+
+  // Hide read_from and write_to so the generic io::copy does not call back
+  // into them.
+  struct without_read_from {
+    conn* c;
+    std::pair<long, std::error_code> write(std::span<uint8_t const> b) { return c->write(b); }
+  };
+  struct without_write_to {
+    conn* c;
+    std::pair<long, std::error_code> read(std::span<uint8_t> b) { return c->read(b); }
+  };
+};
+
+template <typename U> requires io::ReaderFunc<U>
+std::pair<int64_t, std::error_code> conn::read_from(U& r) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  if (auto [n, handled, err] = bongo::detail::poll::zero_copy(*this, r); handled) {
+    return {n, err};
+  }
+  auto w = without_read_from{this};
+  return io::copy(w, r);
+}
+
+template <typename U> requires io::WriterFunc<U>
+std::pair<int64_t, std::error_code> conn::write_to(U& w) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  if (auto [n, handled, err] = bongo::detail::poll::zero_copy(w, *this); handled) {
+    return {n, err};
+  }
+  auto r = without_write_to{this};
+  return io::copy(w, r);
+}
+
+/**
+ * A generic network listener for stream-oriented protocols.
+ *
+ * - https://golang.org/pkg/net/#Listener
+ */
+class listener {
+  std::unique_ptr<bongo::detail::poll::fd> pfd_;
+  addr laddr_;
+  // Path of a Unix domain socket removed on close.
+  std::string unlink_;
+
+ public:
+  listener() = default;
+  listener(std::unique_ptr<bongo::detail::poll::fd> fd, addr laddr, std::string unlink = "")
+      : pfd_{std::move(fd)}
+      , laddr_{std::move(laddr)}
+      , unlink_{std::move(unlink)} {}
+  listener(listener const& other) = delete;
+  listener& operator=(listener const& other) = delete;
+  listener(listener&& other) = default;
+  listener& operator=(listener&& other) = default;
+  ~listener() = default;
+
+  // Waits for and returns the next connection to the listener.
+  std::pair<conn, std::error_code> accept();
+
+  // Closes the listener. Any blocked accept operations will be unblocked
+  // and return errors.
+  std::error_code close();
+
+  addr const& local_addr() const noexcept { return laddr_; }
+
+  std::error_code set_deadline(std::chrono::system_clock::time_point t);
+
+  uintptr_t fd() const noexcept { return static_cast<uintptr_t>(pfd_->sysfd); }
+
+ private:
+  std::error_code check_valid() const;
+};
+
+}  // namespace bongo::net
@@ -0,0 +1,320 @@
+// Copyright The Go Authors.
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "bongo/bongo.h"
+#include "bongo/bytes.h"
+#include "bongo/context.h"
+#include "bongo/detail/poll/error.h"
+#include "bongo/io.h"
+#include "bongo/net.h"
+#include "bongo/os.h"
+
+using namespace std::chrono_literals;
+
+namespace bongo::net {
+namespace {
+
+// Echoes everything read on the next accepted connection until EOF.
+std::thread echo_server(listener& ln) {
+  return std::thread{[&ln]() {
+    auto [c, err] = ln.accept();
+    REQUIRE(err == nil);
+    auto buf = std::vector<uint8_t>(4096);
+    for (;;) {
+      auto [n, err1] = c.read(buf);
+      if (err1) {
+        CHECK(err1 == io::eof);
+        break;
+      }
+      auto [m, err2] = c.write(std::span{buf}.subspan(0, n));
+      REQUIRE(err2 == nil);
+      REQUIRE(m == n);
+    }
+    c.close();
+  }};
+}
+
+void check_echo(conn& c) {
+  auto msg = bytes::to_bytes(std::string_view{"hello, world"});
+  auto [n, err] = c.write(msg);
+  REQUIRE(err == nil);
+  REQUIRE(n == static_cast<long>(msg.size()));
+  auto buf = std::vector<uint8_t>(msg.size());
+  auto [m, err1] = io::read_full(c, buf);
+  REQUIRE(err1 == nil);
+  REQUIRE(m == static_cast<long>(msg.size()));
+  CHECK(std::equal(buf.begin(), buf.end(), msg.begin()));
+}
+
+}  // namespace
+
+TEST_CASE("Split host port", "[net]") {
+  struct {
+    std::string_view hostport;
+    std::string_view host;
+    std::string_view port;
+  } tests[] = {
+    {"localhost:http", "localhost", "http"},
+    {"localhost:80", "localhost", "80"},
+    {"127.0.0.1:80", "127.0.0.1", "80"},
+    {"[::1]:80", "::1", "80"},
+    {"[fe80::1%lo0]:80", "fe80::1%lo0", "80"},
+    {":80", "", "80"},
+    {"[]:80", "", "80"},
+    {"localhost:", "localhost", ""},
+    {"[::1]:", "::1", ""},
+  };
+  for (auto& test : tests) {
+    auto [host, port, err] = split_host_port(test.hostport);
+    CHECK(err == nil);
+    CHECK(host == test.host);
+    CHECK(port == test.port);
+    if (!test.host.empty() || !test.port.empty()) {
+      auto joined = join_host_port(host, port);
+      std::tie(host, port, err) = split_host_port(joined);
+      CHECK(host == test.host);
+      CHECK(port == test.port);
+    }
+  }
+
+  struct {
+    std::string_view hostport;
+    error err;
+  } errors[] = {
+    {"golang.org", error::missing_port},
+    {"127.0.0.1", error::missing_port},
+    {"[::1]", error::missing_port},
+    {"[fe80::1%lo0]", error::missing_port},
+    {"[localhost]", error::missing_port},
+    {"localhost", error::missing_port},
+    {"[::1]:80:", error::too_many_colons},
+    {"::1:80", error::too_many_colons},
+    {"[::1]x:80", error::missing_port},
+    {"[foo:bar]baz:", error::missing_port},
+    {"[foo]bar:baz", error::missing_port},
+    {"[::1", error::missing_bracket},
+    {"[::1:80", error::missing_bracket},
+    {"localhost]:80", error::unexpected_bracket},
+    {"[foo]:[bar]:baz", error::too_many_colons},
+    {"[foo]:[bar]baz", error::unexpected_bracket},
+    {"foo[bar]:baz", error::unexpected_bracket},
+    {"[::1]:80]", error::unexpected_bracket},
+  };
+  for (auto& test : errors) {
+    auto [host, port, err] = split_host_port(test.hostport);
+    CHECK(err == test.err);
+  }
+}
+
+TEST_CASE("Join host port", "[net]") {
+  CHECK(join_host_port("localhost", "80") == "localhost:80");
+  CHECK(join_host_port("::1", "80") == "[::1]:80");
+  CHECK(join_host_port("", "80") == ":80");
+}
+
+TEST_CASE("TCP echo", "[net]") {
+  auto [ln, err] = listen("tcp4", "127.0.0.1:0");
+  REQUIRE(err == nil);
+  CHECK(ln.local_addr().network() == "tcp4");
+  CHECK(ln.local_addr().string().starts_with("127.0.0.1:"));
+  auto t = echo_server(ln);
+
+  auto [c, err1] = dial("tcp", ln.local_addr().string());
+  REQUIRE(err1 == nil);
+  CHECK(c.remote_addr().string() == ln.local_addr().string());
+  CHECK(c.local_addr().string().starts_with("127.0.0.1:"));
+  check_echo(c);
+  REQUIRE(c.close_write() == nil);
+  t.join();
+  auto buf = std::vector<uint8_t>(1);
+  auto [n, err2] = c.read(buf);
+  CHECK(n == 0);
+  CHECK(err2 == io::eof);
+  CHECK(c.close() == nil);
+  CHECK(ln.close() == nil);
+}
+
+TEST_CASE("Wildcard listener", "[net]") {
+  auto [ln, err] = listen("tcp", ":0");
+  REQUIRE(err == nil);
+  auto [_, port, err1] = split_host_port(ln.local_addr().string());
+  REQUIRE(err1 == nil);
+  auto t = echo_server(ln);
+  auto [c, err2] = dial("tcp", join_host_port("127.0.0.1", port));
+  REQUIRE(err2 == nil);
+  check_echo(c);
+  c.close();
+  t.join();
+}
+
+TEST_CASE("Unix echo", "[net]") {
+  SECTION("Abstract") {
+    auto name = "@bongo-net-test-" + std::to_string(::getpid());
+    auto [ln, err] = listen("unix", name);
+    REQUIRE(err == nil);
+    CHECK(ln.local_addr().string() == name);
+    auto t = echo_server(ln);
+    auto [c, err1] = dial("unix", name);
+    REQUIRE(err1 == nil);
+    CHECK(c.remote_addr().string() == name);
+    check_echo(c);
+    c.close();
+    t.join();
+  }
+
+  SECTION("Path") {
+    auto name = "/tmp/bongo-net-test-" + std::to_string(::getpid()) + ".sock";
+    auto [ln, err] = listen("unix", name);
+    REQUIRE(err == nil);
+    auto t = echo_server(ln);
+    auto [c, err1] = dial("unix", name);
+    REQUIRE(err1 == nil);
+    check_echo(c);
+    c.close();
+    t.join();
+    ln.close();
+    // The socket file is removed when the listener is closed
+    CHECK(::access(name.c_str(), F_OK) == -1);
+  }
+}
+
+TEST_CASE("Dial errors", "[net]") {
+  auto [c, err] = dial("ipx", "localhost:80");
+  CHECK(err == error::unknown_network);
+  std::tie(c, err) = dial("tcp", "localhost");
+  CHECK(err == error::missing_port);
+  std::tie(c, err) = dial("tcp", ":80");
+  CHECK(err == error::missing_address);
+
+  // Nothing listens on a port that was just released
+  auto [ln, err1] = listen("tcp4", "127.0.0.1:0");
+  REQUIRE(err1 == nil);
+  auto address = ln.local_addr().string();
+  ln.close();
+  std::tie(c, err) = dial("tcp4", address);
+  CHECK(err == std::errc::connection_refused);
+
+  auto [ctx, cancel] = context::with_cancel(context::background());
+  cancel();
+  std::tie(c, err) = dial(ctx, "tcp4", address);
+  CHECK(err == context::error::canceled);
+}
+
+TEST_CASE("Accept deadline", "[net]") {
+  auto [ln, err] = listen("tcp4", "127.0.0.1:0");
+  REQUIRE(err == nil);
+  REQUIRE(ln.set_deadline(std::chrono::system_clock::now() + 10ms) == nil);
+  auto [c, err1] = ln.accept();
+  CHECK(err1 == bongo::detail::poll::error::deadline_exceeded);
+
+  // Closing the listener unblocks accept
+  REQUIRE(ln.set_deadline({}) == nil);
+  auto t = std::thread{[&ln = ln]() {
+    std::this_thread::sleep_for(10ms);
+    ln.close();
+  }};
+  std::tie(c, err1) = ln.accept();
+  t.join();
+  CHECK(err1 == bongo::detail::poll::error::net_closing);
+}
+
+TEST_CASE("Read deadline on conn", "[net]") {
+  auto [ln, err] = listen("tcp4", "127.0.0.1:0");
+  REQUIRE(err == nil);
+  auto [c, err1] = dial("tcp4", ln.local_addr().string());
+  REQUIRE(err1 == nil);
+  auto [s, err2] = ln.accept();
+  REQUIRE(err2 == nil);
+  REQUIRE(c.set_read_deadline(std::chrono::system_clock::now() + 10ms) == nil);
+  auto buf = std::vector<uint8_t>(1);
+  auto [n, err3] = c.read(buf);
+  CHECK(n == 0);
+  CHECK(err3 == bongo::detail::poll::error::deadline_exceeded);
+}
+
+TEST_CASE("Copy between file and connection", "[net]") {
+  auto [ln, err] = listen("tcp4", "127.0.0.1:0");
+  REQUIRE(err == nil);
+  auto text = std::string{};
+  for (int i = 0; i < 100000; ++i) {
+    text += std::to_string(i) + "\n";
+  }
+  auto name = "/tmp/bongo-net-copy-" + std::to_string(::getpid());
+  auto [f, err1] = os::create(name);
+  REQUIRE(err1 == nil);
+  auto _ = defer([&name]() { ::unlink(name.c_str()); });
+  f.write(bytes::to_bytes(text));
+  f.seek(0, io::seek_start);
+
+  // The server sends the file with sendfile and closes.
+  auto t = std::thread{[&]() {
+    auto [c, err2] = ln.accept();
+    REQUIRE(err2 == nil);
+    auto [n, err3] = io::copy(c, f);
+    CHECK(n == static_cast<int64_t>(text.size()));
+    CHECK(err3 == nil);
+    c.close();
+  }};
+
+  // The client splices the connection into another file.
+  auto [c, err2] = dial("tcp4", ln.local_addr().string());
+  REQUIRE(err2 == nil);
+  auto name1 = name + "-1";
+  auto [g, err3] = os::create(name1);
+  REQUIRE(err3 == nil);
+  auto _1 = defer([&name1]() { ::unlink(name1.c_str()); });
+  auto [n, err4] = io::copy(g, c);
+  t.join();
+  CHECK(n == static_cast<int64_t>(text.size()));
+  CHECK(err4 == nil);
+
+  g.seek(0, io::seek_start);
+  auto got = bytes::buffer{};
+  io::copy(got, g);
+  CHECK(got.str() == text);
+}
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+TEST_CASE("Net benchmarks", "[!benchmark]") {
+  for (auto network : {"tcp4", "unix"}) {
+    auto address = std::string{network} == "unix"
+        ? "@bongo-net-bench-" + std::to_string(::getpid())
+        : std::string{"127.0.0.1:0"};
+    auto [ln, err] = listen(network, address);
+    REQUIRE(err == nil);
+    auto t = echo_server(ln);
+    auto [c, err1] = dial(network, ln.local_addr().string());
+    REQUIRE(err1 == nil);
+    auto msg = std::vector<uint8_t>(64, 'x');
+    auto buf = std::vector<uint8_t>(64);
+    auto round_trip = [&]() {
+      c.write(msg);
+      io::read_full(c, buf);
+    };
+
+    BENCHMARK("Echo 64 B round trip (" + std::string{network} + ")") {
+      round_trip();
+    };
+
+    c.close();
+    t.join();
+    ln.close();
+  }
+}
+
+#endif  // defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+}  // namespace bongo::net
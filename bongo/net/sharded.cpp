@@ -0,0 +1,174 @@
+// Copyright The Go Authors.
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bongo/bongo.h"
+#include "bongo/detail/poll/error.h"
+#include "bongo/net/detail/sock.h"
+#include "bongo/net/error.h"
+#include "bongo/net/net.h"
+#include "bongo/net/sharded.h"
+
+namespace bongo::net {
+namespace {
+
+// Returns the CPUs the calling thread may run on.
+std::vector<int> allowed_cpus() {
+  auto set = ::cpu_set_t{};
+  auto cpus = std::vector<int>{};
+  if (::sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+  if (cpus.empty()) {
+    cpus.push_back(0);
+  }
+  return cpus;
+}
+
+std::error_code pin_thread(int cpu) {
+  auto set = ::cpu_set_t{};
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if (auto rc = ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set); rc != 0) {
+    return std::error_code{rc, std::system_category()};
+  }
+  return nil;
+}
+
+// Accept errors caused by resource exhaustion that may clear up on retry.
+bool temporary(std::error_code err) {
+  return err == std::errc::too_many_files_open ||
+         err == std::errc::too_many_files_open_in_system ||
+         err == std::errc::no_buffer_space ||
+         err == std::errc::not_enough_memory;
+}
+
+}  // namespace
+
+std::error_code sharded_listener::serve(handler_func const& handler) {
+  if (listeners_.empty()) {
+    return std::make_error_code(std::errc::invalid_argument);
+  }
+  auto errs = std::vector<std::error_code>(listeners_.size());
+  auto workers = std::vector<std::thread>{};
+  workers.reserve(listeners_.size());
+  for (int i = 0; i < size(); ++i) {
+    workers.emplace_back([this, i, &handler, &errs] {
+      errs[i] = accept_loop(i, handler);
+    });
+  }
+  for (auto& t : workers) {
+    t.join();
+  }
+  for (auto err : errs) {
+    if (err) {
+      return err;
+    }
+  }
+  return nil;
+}
+
+std::error_code sharded_listener::accept_loop(int i, handler_func const& handler) {
+  if (cpus_[i] >= 0) {
+    if (auto err = pin_thread(cpus_[i]); err) {
+      close();
+      return err;
+    }
+  }
+  auto& ln = listeners_[i];
+  auto delay = std::chrono::milliseconds{0};
+  for (;;) {
+    auto [c, err] = ln.accept();
+    if (err) {
+      if (closed_ || err == bongo::detail::poll::error::net_closing) {
+        return nil;
+      }
+      if (temporary(err)) {
+        // Back off as in net/http.Server.Serve.
+        delay = std::clamp(delay * 2, std::chrono::milliseconds{5}, std::chrono::milliseconds{1000});
+        std::this_thread::sleep_for(delay);
+        continue;
+      }
+      close();
+      return err;
+    }
+    delay = {};
+    handler(i, std::move(c));
+  }
+}
+
+std::error_code sharded_listener::close() {
+  if (listeners_.empty()) {
+    return std::make_error_code(std::errc::invalid_argument);
+  }
+  if (closed_.exchange(true)) {
+    return bongo::detail::poll::error::net_closing;
+  }
+  std::error_code first;
+  for (auto& ln : listeners_) {
+    if (auto err = ln.close(); err && !first) {
+      first = err;
+    }
+  }
+  return first;
+}
+
+std::pair<sharded_listener, std::error_code> listen_sharded(
+    std::string_view network, std::string_view address, int shards, bool pin) {
+  if (auto [nt, err] = detail::parse_network(network); err || nt.sotype != SOCK_STREAM || nt.family == AF_UNIX) {
+    return {sharded_listener{}, error::unknown_network};
+  }
+  auto allowed = allowed_cpus();
+  if (shards <= 0) {
+    shards = static_cast<int>(allowed.size());
+  }
+  auto listeners = std::vector<listener>{};
+  auto cpus = std::vector<int>{};
+  auto bound = std::string{address};
+  for (int i = 0; i < shards; ++i) {
+    auto cpu = pin ? allowed[i % allowed.size()] : -1;
+    auto control = [cpu](int fd) -> std::error_code {
+      if (auto err = detail::setsockopt_int(fd, SOL_SOCKET, SO_REUSEPORT, 1); err) {
+        return err;
+      }
+      if (cpu >= 0) {
+        // Prefer this shard for connections whose packets the kernel
+        // processes on the same CPU. Older kernels ignore it.
+        detail::setsockopt_int(fd, SOL_SOCKET, SO_INCOMING_CPU, cpu);
+      }
+      return nil;
+    };
+    auto [s, err] = detail::listen_socket(network, bound, control);
+    if (err) {
+      for (auto& ln : listeners) {
+        ln.close();
+      }
+      return {sharded_listener{}, err};
+    }
+    auto laddr = detail::to_addr(network, s.laddr);
+    if (i == 0) {
+      // Bind the remaining shards to the port chosen by the first.
+      bound = laddr.string();
+    }
+    listeners.emplace_back(std::move(s.fd), std::move(laddr));
+    cpus.push_back(cpu);
+  }
+  return {sharded_listener{std::move(listeners), std::move(cpus)}, nil};
+}
+
+}  // namespace bongo::net
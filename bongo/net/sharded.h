@@ -0,0 +1,89 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <bongo/net/net.h>
+
+namespace bongo::net {
+
+/**
+ * A set of TCP listeners bound to the same address with SO_REUSEPORT.
+ *
+ * The kernel spreads incoming connections across the listeners, so each
+ * shard runs its own accept loop without contending on a shared socket. The
+ * serve method runs one accept loop per shard on a worker thread pinned to
+ * a CPU. Threads started by a handler inherit that CPU affinity, which keeps
+ * a connection on the core that accepted it.
+ */
+class sharded_listener {
+ public:
+  // Called on the worker thread of a shard with each accepted connection.
+  // The handler should hand long-lived connections off to another thread so
+  // the shard keeps accepting.
+  using handler_func = std::function<void(int shard, conn c)>;
+
+ private:
+  std::vector<listener> listeners_;
+  std::vector<int> cpus_;  // CPU of each shard, or -1 to leave unpinned
+  std::atomic_bool closed_ = false;
+
+ public:
+  sharded_listener() = default;
+  sharded_listener(std::vector<listener> listeners, std::vector<int> cpus)
+      : listeners_{std::move(listeners)}
+      , cpus_{std::move(cpus)} {}
+  sharded_listener(sharded_listener const& other) = delete;
+  sharded_listener& operator=(sharded_listener const& other) = delete;
+  sharded_listener(sharded_listener&& other) noexcept
+      : listeners_{std::move(other.listeners_)}
+      , cpus_{std::move(other.cpus_)}
+      , closed_{other.closed_.load()} {}
+  sharded_listener& operator=(sharded_listener&& other) noexcept {
+    listeners_ = std::move(other.listeners_);
+    cpus_ = std::move(other.cpus_);
+    closed_ = other.closed_.load();
+    return *this;
+  }
+  ~sharded_listener() = default;
+
+  // Accepts connections on every shard and calls handler for each one.
+  // Blocks until the listener is closed, in which case nil is returned, or
+  // an accept fails with a permanent error, in which case all shards are
+  // closed and the error is returned.
+  std::error_code serve(handler_func const& handler);
+
+  // Closes every shard. Blocked accept loops return and serve returns.
+  std::error_code close();
+
+  // Address shared by all shards.
+  addr const& local_addr() const noexcept { return listeners_.front().local_addr(); }
+
+  int size() const noexcept { return static_cast<int>(listeners_.size()); }
+
+  // The listener of shard i, for callers running their own accept loops.
+  listener& shard(int i) { return listeners_.at(i); }
+
+ private:
+  std::error_code accept_loop(int i, handler_func const& handler);
+};
+
+// Announces on the local TCP address with one SO_REUSEPORT listener per
+// shard. If shards is zero, one shard is created for each CPU the calling
+// thread may run on. If pin is true, shard i is served on the i-th of those
+// CPUs and sets SO_INCOMING_CPU to it, so since Linux 6.2 a connection goes
+// to the shard of the CPU that handles its packets rather than being spread
+// by hash.
+//
+// The network must be "tcp", "tcp4" or "tcp6". If the port is empty or "0"
+// the first shard chooses a port and the others bind to the same one.
+std::pair<sharded_listener, std::error_code> listen_sharded(
+    std::string_view network, std::string_view address, int shards = 0, bool pin = true);
+
+}  // namespace bongo::net
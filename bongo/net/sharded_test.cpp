@@ -0,0 +1,213 @@
+// Copyright The Go Authors.
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/utsname.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "bongo/bongo.h"
+#include "bongo/net.h"
+
+namespace bongo::net {
+namespace {
+
+// Writes the shard index to the connection and closes it.
+void reply_shard(int shard, conn c) {
+  auto b = std::vector<uint8_t>{static_cast<uint8_t>(shard)};
+  c.write(b);
+  c.close();
+}
+
+// Dials the listener and returns the shard index it replies with, or -1 on
+// error. It does not assert so it can run on other threads.
+int dial_shard(sharded_listener& ln) {
+  auto [c, err1] = dial("tcp4", ln.local_addr().string());
+  if (err1) {
+    return -1;
+  }
+  auto b = std::vector<uint8_t>(1);
+  auto [n, err2] = c.read(b);
+  c.close();
+  if (err2 || n != 1) {
+    return -1;
+  }
+  return b[0];
+}
+
+// CPUs the calling thread may run on, in the order listen_sharded assigns
+// them to shards.
+std::vector<int> allowed_cpus() {
+  auto set = ::cpu_set_t{};
+  auto cpus = std::vector<int>{};
+  REQUIRE(::sched_getaffinity(0, sizeof(set), &set) == 0);
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &set)) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+// Whether reuseport selection honors SO_INCOMING_CPU, which is the case
+// since Linux 6.2.
+bool incoming_cpu_selects_shard() {
+  auto u = ::utsname{};
+  if (::uname(&u) != 0) {
+    return false;
+  }
+  auto in = std::istringstream{u.release};
+  int major = 0;
+  int minor = 0;
+  char dot = 0;
+  in >> major >> dot >> minor;
+  return major > 6 || (major == 6 && minor >= 2);
+}
+
+}  // namespace
+
+TEST_CASE("Sharded listener", "[net]") {
+  // Without pinning SO_INCOMING_CPU is not set, so the kernel spreads
+  // connections by hash regardless of the CPU handling them.
+  auto [ln, err] = listen_sharded("tcp4", "127.0.0.1:0", 4, /*pin=*/false);
+  REQUIRE(err == nil);
+  REQUIRE(ln.size() == 4);
+  for (int i = 0; i < ln.size(); ++i) {
+    CHECK(ln.shard(i).local_addr().string() == ln.local_addr().string());
+  }
+
+  auto serve_err = std::error_code{};
+  auto t = std::thread{[&] {
+    serve_err = ln.serve(reply_shard);
+  }};
+
+  auto seen = std::set<int>{};
+  for (int i = 0; i < 200; ++i) {
+    auto shard = dial_shard(ln);
+    REQUIRE(shard != -1);
+    seen.insert(shard);
+  }
+  // The kernel hashes connections across all shards.
+  CHECK(seen.size() == 4);
+
+  CHECK(ln.close() == nil);
+  t.join();
+  CHECK(serve_err == nil);
+}
+
+TEST_CASE("Pinned sharded listener", "[net]") {
+  if (!incoming_cpu_selects_shard()) {
+    WARN("SO_INCOMING_CPU steering needs Linux 6.2");
+    return;
+  }
+  // One shard per allowed CPU, shard i pinned to cpus[i].
+  auto cpus = allowed_cpus();
+  auto [ln, err] = listen_sharded("tcp4", "127.0.0.1:0");
+  REQUIRE(err == nil);
+  REQUIRE(ln.size() == static_cast<int>(cpus.size()));
+  auto t = std::thread{[&ln = ln] {
+    ln.serve(reply_shard);
+  }};
+
+  // On loopback the SYN is processed on the dialing thread's CPU, so every
+  // connection lands on the shard pinned to that CPU.
+  auto n = std::min<int>(cpus.size(), 8);
+  for (int i = 0; i < n; ++i) {
+    auto shard = -1;
+    auto d = std::thread{[&] {
+      auto set = ::cpu_set_t{};
+      CPU_ZERO(&set);
+      CPU_SET(cpus[i], &set);
+      if (::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set) != 0) {
+        return;
+      }
+      for (int j = 0; j < 10; ++j) {
+        shard = dial_shard(ln);
+        if (shard != i) {
+          return;
+        }
+      }
+    }};
+    d.join();
+    CHECK(shard == i);
+  }
+
+  CHECK(ln.close() == nil);
+  t.join();
+}
+
+TEST_CASE("Sharded listener errors", "[net]") {
+  auto [ln, err] = listen_sharded("unix", "@bongo-sharded");
+  CHECK(err == error::unknown_network);
+  auto [ln1, err1] = listen_sharded("udp4", "127.0.0.1:0");
+  CHECK(err1 == error::unknown_network);
+
+  // A port held by a listener without SO_REUSEPORT cannot be shared.
+  auto [l, err2] = listen("tcp4", "127.0.0.1:0");
+  REQUIRE(err2 == nil);
+  auto [ln2, err3] = listen_sharded("tcp4", l.local_addr().string(), 2);
+  CHECK(err3 == std::errc::address_in_use);
+  l.close();
+}
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+TEST_CASE("Sharded listener benchmarks", "[!benchmark]") {
+  // Each client thread repeatedly connects and waits for the server to
+  // close the connection, so the rate is bounded by accept throughput.
+  auto const clients = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+  constexpr int per_client = 100;
+  auto shard_counts = std::vector<int>{1, 2, 4};
+  if (auto cpus = static_cast<int>(std::thread::hardware_concurrency()); cpus > 4) {
+    shard_counts.push_back(cpus);
+  }
+  for (auto shards : shard_counts) {
+    auto [ln, err] = listen_sharded("tcp4", "127.0.0.1:0", shards);
+    REQUIRE(err == nil);
+    auto server = std::thread{[&ln = ln] {
+      ln.serve([](int, conn c) {
+        c.close();
+      });
+    }};
+    auto address = ln.local_addr().string();
+    auto failed = std::atomic<int>{0};
+    BENCHMARK_ADVANCED(std::to_string(clients * per_client) + " connections, " + std::to_string(shards) + " shards")(Catch::Benchmark::Chronometer meter) {
+      meter.measure([&] {
+        auto threads = std::vector<std::thread>{};
+        for (int i = 0; i < clients; ++i) {
+          threads.emplace_back([&] {
+            auto b = std::vector<uint8_t>(1);
+            for (int j = 0; j < per_client; ++j) {
+              auto [c, err1] = dial("tcp4", address);
+              if (err1) {
+                ++failed;
+                continue;
+              }
+              c.read(b);
+              c.close();
+            }
+          });
+        }
+        for (auto& t : threads) {
+          t.join();
+        }
+      });
+    };
+    CHECK(failed == 0);
+    ln.close();
+    server.join();
+  }
+}
+
+#endif  // defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+}  // namespace bongo::net
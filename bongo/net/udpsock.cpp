@@ -0,0 +1,224 @@
+// Copyright The Go Authors.
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <utility>
+
+#include "bongo/bongo.h"
+#include "bongo/net/detail/sock.h"
+#include "bongo/net/error.h"
+#include "bongo/net/net.h"
+#include "bongo/net/udpsock.h"
+
+namespace bongo::net {
+namespace {
+
+// Maximum number of messages passed to a single recvmmsg or sendmmsg. The
+// message headers are built on the stack.
+constexpr static size_t chunk = 64;
+
+bool is_udp(std::string_view network) {
+  auto [nt, err] = detail::parse_network(network);
+  return !err && nt.sotype == SOCK_DGRAM;
+}
+
+}  // namespace
+
+std::string udp_addr::string() const {
+  return detail::to_addr("udp", sa_).string();
+}
+
+std::pair<udp_addr, std::error_code> resolve_udp_addr(std::string_view network, std::string_view address) {
+  if (!is_udp(network)) {
+    return {udp_addr{}, error::unknown_network};
+  }
+  auto [addrs, err] = detail::resolve(network, address, true);
+  if (err) {
+    return {udp_addr{}, err};
+  }
+  return {udp_addr{addrs.front()}, nil};
+}
+
+std::pair<long, std::error_code> packet_conn::read(std::span<uint8_t> b) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  return pfd_->read(b);
+}
+
+std::pair<long, std::error_code> packet_conn::write(std::span<uint8_t const> b) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  return pfd_->write(b);
+}
+
+std::tuple<long, udp_addr, std::error_code> packet_conn::read_from(std::span<uint8_t> b) {
+  if (auto err = check_valid(); err) {
+    return {0, udp_addr{}, err};
+  }
+  auto sa = detail::sockaddr_any{};
+  struct ::iovec iov = {b.data(), b.size()};
+  struct ::msghdr msg = {};
+  msg.msg_name = &sa.ss;
+  msg.msg_namelen = sizeof sa.ss;
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  auto [n, err] = pfd_->read_msg(&msg, 0);
+  if (err) {
+    return {0, udp_addr{}, err};
+  }
+  sa.len = msg.msg_namelen;
+  return {n, udp_addr{sa}, nil};
+}
+
+std::pair<long, std::error_code> packet_conn::write_to(std::span<uint8_t const> b, udp_addr const& addr) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  struct ::iovec iov = {const_cast<uint8_t*>(b.data()), b.size()};
+  struct ::msghdr msg = {};
+  msg.msg_name = const_cast<::sockaddr*>(addr.sockaddr().get());
+  msg.msg_namelen = addr.sockaddr().len;
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  return pfd_->write_msg(&msg, 0);
+}
+
+std::pair<long, std::error_code> packet_conn::read_batch(std::span<message> msgs) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  msgs = msgs.subspan(0, std::min(msgs.size(), chunk));
+  struct ::mmsghdr hdrs[chunk] = {};
+  struct ::iovec iovs[chunk];
+  detail::sockaddr_any addrs[chunk];
+  for (size_t i = 0; i < msgs.size(); ++i) {
+    iovs[i] = {msgs[i].buffer.data(), msgs[i].buffer.size()};
+    hdrs[i].msg_hdr.msg_name = &addrs[i].ss;
+    hdrs[i].msg_hdr.msg_namelen = sizeof addrs[i].ss;
+    hdrs[i].msg_hdr.msg_iov = &iovs[i];
+    hdrs[i].msg_hdr.msg_iovlen = 1;
+  }
+  auto [n, err] = pfd_->read_mmsg(std::span{hdrs, msgs.size()});
+  for (long i = 0; i < n; ++i) {
+    addrs[i].len = hdrs[i].msg_hdr.msg_namelen;
+    msgs[i].n = hdrs[i].msg_len;
+    msgs[i].addr = udp_addr{addrs[i]};
+  }
+  return {n, err};
+}
+
+std::pair<long, std::error_code> packet_conn::write_batch(std::span<message> msgs) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  long nn = 0;
+  while (nn < static_cast<long>(msgs.size())) {
+    auto batch = msgs.subspan(nn, std::min(msgs.size() - nn, chunk));
+    struct ::mmsghdr hdrs[chunk] = {};
+    struct ::iovec iovs[chunk];
+    for (size_t i = 0; i < batch.size(); ++i) {
+      iovs[i] = {batch[i].buffer.data(), batch[i].buffer.size()};
+      if (!batch[i].addr.empty()) {
+        hdrs[i].msg_hdr.msg_name = const_cast<::sockaddr*>(batch[i].addr.sockaddr().get());
+        hdrs[i].msg_hdr.msg_namelen = batch[i].addr.sockaddr().len;
+      }
+      hdrs[i].msg_hdr.msg_iov = &iovs[i];
+      hdrs[i].msg_hdr.msg_iovlen = 1;
+    }
+    auto [n, err] = pfd_->write_mmsg(std::span{hdrs, batch.size()});
+    for (long i = 0; i < n; ++i) {
+      batch[i].n = hdrs[i].msg_len;
+    }
+    nn += n;
+    if (err) {
+      return {nn, err};
+    }
+  }
+  return {nn, nil};
+}
+
+std::error_code packet_conn::close() {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  return pfd_->close();
+}
+
+std::error_code packet_conn::set_deadline(std::chrono::system_clock::time_point t) {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  return pfd_->set_deadline(t);
+}
+
+std::error_code packet_conn::set_read_deadline(std::chrono::system_clock::time_point t) {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  return pfd_->set_read_deadline(t);
+}
+
+std::error_code packet_conn::set_write_deadline(std::chrono::system_clock::time_point t) {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  return pfd_->set_write_deadline(t);
+}
+
+std::error_code packet_conn::set_read_buffer(int bytes) {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  return pfd_->setsockopt_int(SOL_SOCKET, SO_RCVBUF, bytes);
+}
+
+std::error_code packet_conn::set_write_buffer(int bytes) {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  return pfd_->setsockopt_int(SOL_SOCKET, SO_SNDBUF, bytes);
+}
+
+std::error_code packet_conn::check_valid() const {
+  if (!pfd_) {
+    return std::make_error_code(std::errc::invalid_argument);
+  }
+  return nil;
+}
+
+std::pair<packet_conn, std::error_code> listen_udp(std::string_view network, std::string_view address) {
+  if (!is_udp(network)) {
+    return {packet_conn{}, error::unknown_network};
+  }
+  auto [s, err] = detail::listen_socket(network, address);
+  if (err) {
+    return {packet_conn{}, err};
+  }
+  return {packet_conn{std::move(s.fd), detail::to_addr(network, s.laddr), addr{}}, nil};
+}
+
+std::pair<packet_conn, std::error_code> dial_udp(std::string_view network, std::string_view address) {
+  if (!is_udp(network)) {
+    return {packet_conn{}, error::unknown_network};
+  }
+  auto [s, err] = detail::dial_socket(nullptr, network, address);
+  if (err) {
+    return {packet_conn{}, err};
+  }
+  auto laddr = detail::to_addr(network, s.laddr);
+  auto raddr = detail::to_addr(network, s.raddr);
+  return {packet_conn{std::move(s.fd), std::move(laddr), std::move(raddr)}, nil};
+}
+
+}  // namespace bongo::net
@@ -0,0 +1,136 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <utility>
+
+#include <bongo/detail/poll.h>
+#include <bongo/net/detail/sock.h>
+#include <bongo/net/net.h>
+
+namespace bongo::net {
+
+/**
+ * The address of a UDP end point.
+ *
+ * - https://golang.org/pkg/net/#UDPAddr
+ */
+class udp_addr {
+  detail::sockaddr_any sa_;
+
+ public:
+  udp_addr() = default;
+  explicit udp_addr(detail::sockaddr_any const& sa)
+      : sa_{sa} {}
+
+  // String form of the address, for example "192.0.2.1:53".
+  std::string string() const;
+
+  bool empty() const noexcept { return sa_.len == 0; }
+  detail::sockaddr_any const& sockaddr() const noexcept { return sa_; }
+};
+
+// Returns the address of a UDP end point. The network must be "udp",
+// "udp4" or "udp6". If the host is a name it is resolved to its first
+// address.
+//
+// - https://golang.org/pkg/net/#ResolveUDPAddr
+std::pair<udp_addr, std::error_code> resolve_udp_addr(std::string_view network, std::string_view address);
+
+/**
+ * A datagram transferred by packet_conn::read_batch or write_batch.
+ *
+ * - https://pkg.go.dev/golang.org/x/net/ipv4#Message
+ */
+struct message {
+  std::span<uint8_t> buffer;  // payload, or the buffer to receive into
+  long n = 0;                 // number of bytes read or written
+  udp_addr addr;              // source of a read, destination of a write
+};
+
+/**
+ * A UDP network connection.
+ *
+ * Like conn, the socket is non-blocking and blocked operations park on the
+ * runtime network poller. A read returns at most one datagram, and a
+ * zero-length datagram is not an EOF.
+ *
+ * - https://golang.org/pkg/net/#UDPConn
+ */
+class packet_conn {
+  std::unique_ptr<bongo::detail::poll::fd> pfd_;
+  addr laddr_;
+  addr raddr_;
+
+ public:
+  packet_conn() = default;
+  packet_conn(std::unique_ptr<bongo::detail::poll::fd> fd, addr laddr, addr raddr)
+      : pfd_{std::move(fd)}
+      , laddr_{std::move(laddr)}
+      , raddr_{std::move(raddr)} {}
+  packet_conn(packet_conn const& other) = delete;
+  packet_conn& operator=(packet_conn const& other) = delete;
+  packet_conn(packet_conn&& other) = default;
+  packet_conn& operator=(packet_conn&& other) = default;
+  ~packet_conn() = default;
+
+  // Read from and write to the connected peer.
+  std::pair<long, std::error_code> read(std::span<uint8_t> b);
+  std::pair<long, std::error_code> write(std::span<uint8_t const> b);
+
+  // Reads a datagram and returns the number of bytes read and its source.
+  std::tuple<long, udp_addr, std::error_code> read_from(std::span<uint8_t> b);
+
+  // Writes a datagram to addr.
+  std::pair<long, std::error_code> write_to(std::span<uint8_t const> b, udp_addr const& addr);
+
+  // Reads up to msgs.size() datagrams with as few system calls as possible
+  // (recvmmsg). This waits for at least one datagram and returns the number
+  // of messages filled in.
+  std::pair<long, std::error_code> read_batch(std::span<message> msgs);
+
+  // Writes msgs with as few system calls as possible (sendmmsg) and returns
+  // the number of messages sent. A message with an empty address is sent to
+  // the connected peer.
+  std::pair<long, std::error_code> write_batch(std::span<message> msgs);
+
+  std::error_code close();
+
+  addr const& local_addr() const noexcept { return laddr_; }
+  addr const& remote_addr() const noexcept { return raddr_; }
+
+  std::error_code set_deadline(std::chrono::system_clock::time_point t);
+  std::error_code set_read_deadline(std::chrono::system_clock::time_point t);
+  std::error_code set_write_deadline(std::chrono::system_clock::time_point t);
+
+  // Set the size of the operating system's receive and transmit buffers.
+  std::error_code set_read_buffer(int bytes);
+  std::error_code set_write_buffer(int bytes);
+
+  uintptr_t fd() const noexcept { return static_cast<uintptr_t>(pfd_->sysfd); }
+
+ private:
+  std::error_code check_valid() const;
+};
+
+// Announces on the local UDP address. If the host is empty the socket
+// listens on all available addresses, and if the port is empty or "0" a
+// port number is chosen automatically.
+//
+// - https://golang.org/pkg/net/#ListenUDP
+std::pair<packet_conn, std::error_code> listen_udp(std::string_view network, std::string_view address);
+
+// Creates a UDP socket connected to the remote address.
+//
+// - https://golang.org/pkg/net/#DialUDP
+std::pair<packet_conn, std::error_code> dial_udp(std::string_view network, std::string_view address);
+
+}  // namespace bongo::net
@@ -0,0 +1,156 @@
+// Copyright The Go Authors.
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "bongo/bongo.h"
+#include "bongo/bytes.h"
+#include "bongo/detail/poll/error.h"
+#include "bongo/net.h"
+
+using namespace std::chrono_literals;
+
+namespace bongo::net {
+
+TEST_CASE("UDP read/write", "[net]") {
+  auto [srv, err] = listen_udp("udp4", "127.0.0.1:0");
+  REQUIRE(err == nil);
+  auto [c, err1] = dial_udp("udp4", srv.local_addr().string());
+  REQUIRE(err1 == nil);
+  CHECK(c.remote_addr().string() == srv.local_addr().string());
+
+  auto msg = bytes::to_bytes(std::string_view{"ping"});
+  auto [n, err2] = c.write(msg);
+  REQUIRE(err2 == nil);
+  CHECK(n == 4);
+
+  auto buf = std::vector<uint8_t>(64);
+  auto [m, from, err3] = srv.read_from(buf);
+  REQUIRE(err3 == nil);
+  CHECK(m == 4);
+  CHECK(from.string() == c.local_addr().string());
+
+  std::tie(n, err2) = srv.write_to(bytes::to_bytes(std::string_view{"pong"}), from);
+  REQUIRE(err2 == nil);
+  std::tie(n, err2) = c.read(buf);
+  REQUIRE(err2 == nil);
+  CHECK(std::string_view{reinterpret_cast<char*>(buf.data()), static_cast<size_t>(n)} == "pong");
+
+  // A zero-length datagram is not EOF
+  std::tie(n, err2) = c.write({});
+  REQUIRE(err2 == nil);
+  std::tie(m, from, err3) = srv.read_from(buf);
+  CHECK(m == 0);
+  CHECK(err3 == nil);
+}
+
+TEST_CASE("UDP batch", "[net]") {
+  auto [srv, err] = listen_udp("udp4", "127.0.0.1:0");
+  REQUIRE(err == nil);
+  auto [to, err1] = resolve_udp_addr("udp4", srv.local_addr().string());
+  REQUIRE(err1 == nil);
+  CHECK(to.string() == srv.local_addr().string());
+  auto [c, err2] = listen_udp("udp4", "127.0.0.1:0");
+  REQUIRE(err2 == nil);
+
+  constexpr int count = 100;
+  auto payloads = std::vector<std::string>{};
+  auto out = std::vector<message>(count);
+  for (int i = 0; i < count; ++i) {
+    payloads.push_back(std::to_string(i));
+  }
+  for (int i = 0; i < count; ++i) {
+    out[i].buffer = std::span{reinterpret_cast<uint8_t*>(payloads[i].data()), payloads[i].size()};
+    out[i].addr = to;
+  }
+  auto [n, err3] = c.write_batch(out);
+  REQUIRE(err3 == nil);
+  CHECK(n == count);
+  CHECK(out[99].n == 2);
+
+  auto bufs = std::vector<std::vector<uint8_t>>(count, std::vector<uint8_t>(16));
+  auto in = std::vector<message>(count);
+  for (int i = 0; i < count; ++i) {
+    in[i].buffer = bufs[i];
+  }
+  int got = 0;
+  while (got < count) {
+    auto [m, err4] = srv.read_batch(std::span{in}.subspan(got));
+    REQUIRE(err4 == nil);
+    REQUIRE(m > 0);
+    got += m;
+  }
+  for (int i = 0; i < count; ++i) {
+    CHECK(std::string_view{reinterpret_cast<char*>(bufs[i].data()), static_cast<size_t>(in[i].n)} == payloads[i]);
+    CHECK(in[i].addr.string() == c.local_addr().string());
+  }
+}
+
+TEST_CASE("UDP read deadline", "[net]") {
+  auto [srv, err] = listen_udp("udp4", "127.0.0.1:0");
+  REQUIRE(err == nil);
+  REQUIRE(srv.set_read_deadline(std::chrono::system_clock::now() + 10ms) == nil);
+  auto bufs = std::vector<uint8_t>(16);
+  auto in = std::vector<message>(1);
+  in[0].buffer = bufs;
+  auto [n, err1] = srv.read_batch(in);
+  CHECK(n == 0);
+  CHECK(err1 == bongo::detail::poll::error::deadline_exceeded);
+}
+
+TEST_CASE("UDP errors", "[net]") {
+  auto [c, err] = listen_udp("tcp", "127.0.0.1:0");
+  CHECK(err == error::unknown_network);
+  auto [l, err1] = listen("udp", "127.0.0.1:0");
+  CHECK(err1 == error::unknown_network);
+}
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+TEST_CASE("UDP benchmarks", "[!benchmark]") {
+  // Each iteration sends a burst of datagrams over loopback and receives
+  // them all, so none are dropped.
+  constexpr int burst = 64;
+  auto [srv, err] = listen_udp("udp4", "127.0.0.1:0");
+  REQUIRE(err == nil);
+  auto [c, err1] = dial_udp("udp4", srv.local_addr().string());
+  REQUIRE(err1 == nil);
+  REQUIRE(srv.set_read_buffer(1 << 20) == nil);
+  auto payload = std::vector<uint8_t>(64, 'x');
+  auto bufs = std::vector<std::vector<uint8_t>>(burst, std::vector<uint8_t>(2048));
+  auto out = std::vector<message>(burst);
+  auto in = std::vector<message>(burst);
+  for (int i = 0; i < burst; ++i) {
+    out[i].buffer = payload;
+    in[i].buffer = bufs[i];
+  }
+
+  BENCHMARK("64 datagrams with write/read_from") {
+    for (int i = 0; i < burst; ++i) {
+      c.write(payload);
+    }
+    for (int i = 0; i < burst; ++i) {
+      srv.read_from(bufs[i]);
+    }
+  };
+
+  BENCHMARK("64 datagrams with write_batch/read_batch") {
+    c.write_batch(out);
+    for (int got = 0; got < burst; ) {
+      auto [n, err2] = srv.read_batch(std::span{in}.subspan(got));
+      if (err2) {
+        FAIL("read_batch: " << err2.message());
+      }
+      got += n;
+    }
+  };
+}
+
+#endif  // defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+}  // namespace bongo::net
@@ -0,0 +1,307 @@
+// Copyright The Go Authors.
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bongo/bongo.h"
+#include "bongo/io/fs.h"
+#include "bongo/os/dir_unix.h"
+#include "bongo/os/stat_unix.h"
+#include "bongo/os/types.h"
+#include "bongo/runtime/defer.h"
+#include "bongo/syscall.h"
+
+namespace bongo::os {
+namespace {
+
+// Size of the buffer passed to getdents64. Large directories are read in
+// fewer system calls than with readdir(3), which uses 32 KiB.
+constexpr size_t block_size = 64 << 10;
+
+std::error_code errno_error() {
+  return std::error_code{errno, std::system_category()};
+}
+
+std::string join(std::string const& dir, std::string const& name) {
+  if (!dir.empty() && dir.back() == '/') {
+    return dir + name;
+  }
+  return dir + "/" + name;
+}
+
+file_mode dtype_to_mode(unsigned char t) {
+  switch (t) {
+  case DT_BLK:
+    return mode_device;
+  case DT_CHR:
+    return mode_device | mode_char_device;
+  case DT_DIR:
+    return mode_dir;
+  case DT_FIFO:
+    return mode_named_pipe;
+  case DT_LNK:
+    return mode_symlink;
+  case DT_SOCK:
+    return mode_socket;
+  case DT_REG:
+  default:
+    return 0;
+  }
+}
+
+// Reads the entries of the named directory in directory order.
+std::pair<std::vector<dir_entry>, std::error_code> read_dir_unsorted(std::string const& name) {
+  auto fd = ::open(name.c_str(), O_RDONLY|O_DIRECTORY|O_CLOEXEC);
+  if (fd == -1) {
+    return {std::vector<dir_entry>{}, errno_error()};
+  }
+  auto _ = runtime::defer([fd]() { ::close(fd); });
+  thread_local auto buf = std::vector<uint8_t>(block_size);
+  auto parent = std::make_shared<std::string const>(name);
+  auto entries = std::vector<dir_entry>{};
+  for (;;) {
+    auto [n, err] = syscall::getdents(fd, buf);
+    if (err == std::errc::interrupted) {
+      continue;
+    }
+    if (err) {
+      return {std::move(entries), err};
+    }
+    if (n == 0) {
+      break;
+    }
+    for (long off = 0; off < n;) {
+      auto d = reinterpret_cast<struct ::dirent64 const*>(buf.data() + off);
+      off += d->d_reclen;
+      if (d->d_ino == 0) {
+        // File absent in directory
+        continue;
+      }
+      auto base = std::string_view{d->d_name};
+      if (base == "." || base == "..") {
+        continue;
+      }
+      auto type = dtype_to_mode(d->d_type);
+      if (d->d_type == DT_UNKNOWN) {
+        // Some file systems do not report the type
+        struct ::stat s;
+        if (::fstatat(fd, d->d_name, &s, AT_SYMLINK_NOFOLLOW) == -1) {
+          if (errno == ENOENT) {
+            // Removed since the directory was read
+            continue;
+          }
+          return {std::move(entries), errno_error()};
+        }
+        type = file_info_from_stat(base, s).mode.type();
+      }
+      entries.emplace_back(parent, std::string{base}, type);
+    }
+  }
+  return {std::move(entries), nil};
+}
+
+// Returns the entry for the root of a walk, which is not read from a
+// directory.
+dir_entry root_entry(std::string const& root, file_info const& info) {
+  auto p = std::string_view{root};
+  while (p.size() > 1 && p.back() == '/') {
+    p.remove_suffix(1);
+  }
+  auto i = p.rfind('/');
+  auto parent = std::string{"."};
+  if (i == 0) {
+    parent = "/";
+  } else if (i != std::string_view::npos) {
+    parent = p.substr(0, i);
+  }
+  return dir_entry{std::make_shared<std::string const>(std::move(parent)), info.name, info.mode.type()};
+}
+
+std::error_code walk(std::string const& path, dir_entry const& d, walk_dir_func const& fn) {
+  if (auto err = fn(path, d, nil); err || !d.is_dir()) {
+    if (err == io::fs::skip_dir && d.is_dir()) {
+      // Successfully skipped directory
+      err = nil;
+    }
+    return err;
+  }
+  auto [dirs, err] = read_dir(path);
+  if (err) {
+    // Second call, to report the read_dir error
+    err = fn(path, d, err);
+    if (err) {
+      if (err == io::fs::skip_dir) {
+        err = nil;
+      }
+      return err;
+    }
+  }
+  for (auto const& d1 : dirs) {
+    if (auto err1 = walk(join(path, d1.name()), d1, fn); err1) {
+      if (err1 == io::fs::skip_dir) {
+        break;
+      }
+      return err1;
+    }
+  }
+  return nil;
+}
+
+// Reads directories from a shared stack on a pool of threads. Entries are
+// visited in directory order, which avoids sorting each directory, and
+// subdirectories are pushed so the walk proceeds depth first.
+class parallel_walker {
+  walk_dir_func const& fn_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::vector<std::pair<std::string, dir_entry>> stack_;  // directories to read
+  long pending_ = 0;  // directories on the stack or being read
+  std::atomic_bool done_ = false;
+  std::error_code err_;
+
+ public:
+  explicit parallel_walker(walk_dir_func const& fn)
+      : fn_{fn} {}
+
+  std::error_code walk(std::string const& root, dir_entry const& d, int threads) {
+    if (auto err = fn_(root, d, nil); err || !d.is_dir()) {
+      return err;
+    }
+    stack_.emplace_back(root, d);
+    pending_ = 1;
+    auto workers = std::vector<std::thread>{};
+    for (int i = 0; i < threads; ++i) {
+      workers.emplace_back([this]() { run(); });
+    }
+    for (auto& t : workers) {
+      t.join();
+    }
+    return err_;
+  }
+
+ private:
+  void run() {
+    for (;;) {
+      auto job = std::pair<std::string, dir_entry>{};
+      {
+        auto lock = std::unique_lock{mu_};
+        cv_.wait(lock, [this]() { return done_ || !stack_.empty() || pending_ == 0; });
+        if (done_ || stack_.empty()) {
+          return;
+        }
+        job = std::move(stack_.back());
+        stack_.pop_back();
+      }
+      visit(job.first, job.second);
+      auto lock = std::lock_guard{mu_};
+      if (--pending_ == 0) {
+        cv_.notify_all();
+      }
+    }
+  }
+
+  void visit(std::string const& path, dir_entry const& d) {
+    auto [entries, err] = read_dir_unsorted(path);
+    if (err) {
+      err = fn_(path, d, err);
+      if (err == io::fs::skip_dir) {
+        return;
+      }
+      if (err) {
+        return stop(err);
+      }
+    }
+    auto dirs = std::vector<std::pair<std::string, dir_entry>>{};
+    for (auto& d1 : entries) {
+      if (done_) {
+        return;
+      }
+      auto path1 = join(path, d1.name());
+      err = fn_(path1, d1, nil);
+      if (err == io::fs::skip_dir) {
+        if (d1.is_dir()) {
+          continue;
+        }
+        break;
+      }
+      if (err) {
+        return stop(err);
+      }
+      if (d1.is_dir()) {
+        dirs.emplace_back(std::move(path1), std::move(d1));
+      }
+    }
+    if (dirs.empty()) {
+      return;
+    }
+    auto lock = std::lock_guard{mu_};
+    pending_ += dirs.size();
+    std::move(dirs.begin(), dirs.end(), std::back_inserter(stack_));
+    cv_.notify_all();
+  }
+
+  void stop(std::error_code err) {
+    auto lock = std::lock_guard{mu_};
+    if (!done_) {
+      done_ = true;
+      err_ = err;
+    }
+    cv_.notify_all();
+  }
+};
+
+}  // namespace
+
+std::string dir_entry::path() const {
+  if (parent_ == nullptr) {
+    return name_;
+  }
+  return join(*parent_, name_);
+}
+
+std::pair<file_info, std::error_code> dir_entry::info() const {
+  return lstat(path());
+}
+
+std::pair<std::vector<dir_entry>, std::error_code> read_dir(std::string const& name) {
+  auto [entries, err] = read_dir_unsorted(name);
+  std::sort(entries.begin(), entries.end(), [](auto const& a, auto const& b) {
+    return a.name() < b.name();
+  });
+  return {std::move(entries), err};
+}
+
+std::error_code walk_dir(std::string const& root, walk_dir_func fn, int threads) {
+  auto [info, err] = lstat(root);
+  if (err) {
+    err = fn(root, dir_entry{}, err);
+  } else if (threads <= 1) {
+    err = walk(root, root_entry(root, info), fn);
+  } else {
+    err = parallel_walker{fn}.walk(root, root_entry(root, info), threads);
+  }
+  if (err == io::fs::skip_dir || err == io::fs::skip_all) {
+    return nil;
+  }
+  return err;
+}
+
+}  // namespace bongo::os
@@ -0,0 +1,85 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <bongo/io/fs.h>
+#include <bongo/os/types.h>
+
+namespace bongo::os {
+
+/**
+ * An entry read from a directory.
+ *
+ * The name and type bits come straight from the directory listing, so
+ * reading a directory does not stat its entries. info() stats the entry
+ * when it is called. Entries read from the same directory share a single
+ * copy of the directory path.
+ *
+ * - https://golang.org/pkg/io/fs/#DirEntry
+ */
+class dir_entry {
+  std::shared_ptr<std::string const> parent_;
+  std::string name_;
+  file_mode type_ = 0;
+
+ public:
+  dir_entry() = default;
+  dir_entry(std::shared_ptr<std::string const> parent, std::string name, file_mode type)
+      : parent_{std::move(parent)}
+      , name_{std::move(name)}
+      , type_{type} {}
+
+  // The base name of the file.
+  std::string const& name() const noexcept { return name_; }
+
+  // Whether the entry describes a directory.
+  bool is_dir() const noexcept { return type_.is_dir(); }
+
+  // The type bits of the entry, a subset of the bits returned by
+  // file_mode::type.
+  file_mode type() const noexcept { return type_; }
+
+  // The path of the entry, the directory path joined with the name.
+  std::string path() const;
+
+  // Stats the entry without following symbolic links. If the file was
+  // removed or renamed since the directory was read, info returns an error.
+  std::pair<file_info, std::error_code> info() const;
+};
+
+// Reads the named directory, returning its entries sorted by name. If an
+// error occurs reading the directory, read_dir returns the entries it was
+// able to read before the error.
+//
+// - https://golang.org/pkg/os/#ReadDir
+std::pair<std::vector<dir_entry>, std::error_code> read_dir(std::string const& name);
+
+// Called by walk_dir for each file or directory in the tree. If reading a
+// directory fails the function is called a second time for that directory
+// with the error. Returning io::fs::skip_dir skips the directory, or the
+// rest of the containing directory if the entry is a file. Returning
+// io::fs::skip_all stops the walk. Any other error stops the walk and is
+// returned by walk_dir.
+//
+// - https://golang.org/pkg/io/fs/#WalkDirFunc
+using walk_dir_func = std::function<std::error_code(std::string const& path, dir_entry const& d, std::error_code err)>;
+
+// Walks the file tree rooted at root, calling fn for each file or
+// directory including root. Symbolic links are not followed.
+//
+// With threads greater than one, directories are read by a pool of that
+// many threads and fn is called concurrently from all of them. Each
+// directory is still visited before its entries, but the order is
+// otherwise unspecified. With one thread the walk is in lexical order.
+//
+// - https://golang.org/pkg/path/filepath/#WalkDir
+std::error_code walk_dir(std::string const& root, walk_dir_func fn, int threads = 1);
+
+}  // namespace bongo::os
@@ -0,0 +1,137 @@
+// Copyright The Go Authors.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include "bongo/bongo.h"
+#include "bongo/io.h"
+#include "bongo/os/direct_linux.h"
+#include "bongo/os/file_unix.h"
+#include "bongo/sync/pool.h"
+
+namespace bongo::os {
+namespace {
+
+sync::pool<aligned_buffer> buffer_pool{[]() {
+  return std::make_unique<aligned_buffer>(direct_writer::default_size);
+}};
+
+constexpr long align_down(long n) {
+  return n & ~(direct_alignment - 1);
+}
+
+constexpr long align_up(long n) {
+  return align_down(n + direct_alignment - 1);
+}
+
+}  // namespace
+
+direct_writer::direct_writer(file& f, long size)
+    : f_{&f} {
+  size = align_up(std::max(size, direct_alignment));
+  if (size == default_size) {
+    buf_ = buffer_pool.get();
+  } else {
+    buf_ = std::make_unique<aligned_buffer>(size);
+  }
+  auto [end, err] = f.seek(0, io::seek_end);
+  if (err) {
+    err_ = err;
+    return;
+  }
+  // Read back the last partial block, it is rewritten by the first flush
+  off_ = align_down(end);
+  n_ = end - off_;
+  if (n_ > 0) {
+    auto [n, err1] = f.read_at(std::span{buf_->data(), static_cast<size_t>(direct_alignment)}, off_);
+    if (n < n_) {
+      err_ = err1 ? err1 : io::error::unexpected_eof;
+    }
+  }
+}
+
+direct_writer::~direct_writer() {
+  if (buf_ == nullptr) {
+    return;
+  }
+  flush();
+  if (size() == default_size) {
+    buffer_pool.put(std::move(buf_));
+  }
+}
+
+std::error_code direct_writer::flush() {
+  if (err_) {
+    return err_;
+  }
+  if (n_ == 0) {
+    return nil;
+  }
+  auto end = align_up(n_);
+  std::fill(buf_->data() + n_, buf_->data() + end, 0);
+  auto [n, err] = f_->write_at(std::span{buf_->data(), static_cast<size_t>(end)}, off_);
+  if (err) {
+    err_ = err;
+    return err;
+  }
+  if (end != n_) {
+    // Drop the padding
+    if (err = f_->truncate(off_ + n_); err) {
+      err_ = err;
+      return err;
+    }
+  }
+  auto full = align_down(n_);
+  if (full != n_) {
+    std::memmove(buf_->data(), buf_->data() + full, n_ - full);
+  }
+  off_ += full;
+  n_ -= full;
+  return nil;
+}
+
+std::error_code direct_writer::sync() {
+  if (auto err = flush(); err) {
+    return err;
+  }
+  if (auto err = f_->sync(); err) {
+    err_ = err;
+    return err;
+  }
+  return nil;
+}
+
+std::pair<long, std::error_code> direct_writer::write(std::span<uint8_t const> p) {
+  long nn = 0;
+  while (!p.empty()) {
+    if (available() == 0 && flush()) {
+      return {nn, err_};
+    }
+    if (err_) {
+      return {nn, err_};
+    }
+    auto n = std::min(static_cast<size_t>(available()), p.size());
+    std::memcpy(buf_->data() + n_, p.data(), n);
+    n_ += n;
+    nn += n;
+    p = p.subspan(n);
+  }
+  return {nn, err_};
+}
+
+std::error_code direct_writer::write_byte(uint8_t c) {
+  auto [n, err] = write(std::span{&c, 1});
+  return err;
+}
+
+std::pair<long, std::error_code> direct_writer::write_string(std::string_view s) {
+  return write(std::span{reinterpret_cast<uint8_t const*>(s.data()), s.size()});
+}
+
+}  // namespace bongo::os
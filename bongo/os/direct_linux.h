@@ -0,0 +1,96 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <bongo/os/file_unix.h>
+
+namespace bongo::os {
+
+// Alignment of buffers, offsets and lengths for I/O on a file opened with
+// o_direct. This is a multiple of the logical block size of common devices.
+constexpr static long direct_alignment = 4096;
+
+// Allocates memory aligned for o_direct I/O.
+template <typename T>
+struct aligned_allocator {
+  using value_type = T;
+
+  aligned_allocator() = default;
+  template <typename U>
+  aligned_allocator(aligned_allocator<U> const&) noexcept {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{direct_alignment}));
+  }
+
+  void deallocate(T* p, size_t n) noexcept {
+    ::operator delete(p, n * sizeof(T), std::align_val_t{direct_alignment});
+  }
+
+  friend bool operator==(aligned_allocator const&, aligned_allocator const&) { return true; }
+};
+
+using aligned_buffer = std::vector<uint8_t, aligned_allocator<uint8_t>>;
+
+/**
+ * A buffered writer for files opened with o_direct.
+ *
+ * Data is accumulated in an aligned buffer and written to the end of the
+ * file in whole blocks. flush writes a final partial block padded with
+ * zeros, truncates the file back to the written length, and keeps the
+ * partial block buffered so the next flush rewrites it in place. The
+ * interface matches bufio::writer.
+ *
+ * The writer positions writes with write_at and ignores the file offset,
+ * so the file must not be opened with o_append. If the file does not end
+ * on a block boundary its last partial block is read back when the writer
+ * is created, which requires the file to be opened with o_rdwr.
+ *
+ * Buffers of the default size are recycled through a pool, so writers can
+ * be created cheaply, for example for each segment of a log.
+ */
+class direct_writer {
+  file* f_;
+  std::unique_ptr<aligned_buffer> buf_;
+  long n_ = 0;       // bytes buffered
+  int64_t off_ = 0;  // file offset of the start of the buffer
+  std::error_code err_;
+
+ public:
+  constexpr static long default_size = 1 << 20;
+
+  // Creates a writer appending to f with a buffer of at least size bytes,
+  // rounded up to a multiple of direct_alignment.
+  explicit direct_writer(file& f, long size = default_size);
+  direct_writer(direct_writer const& other) = delete;
+  direct_writer(direct_writer&& other) = default;
+  direct_writer& operator=(direct_writer const& other) = delete;
+  direct_writer& operator=(direct_writer&& other) = default;
+  ~direct_writer();
+
+  long size() const noexcept { return static_cast<long>(buf_->size()); }
+  long buffered() const noexcept { return n_; }
+  long available() const noexcept { return size() - n_; }
+
+  // Writes the buffered data to the file.
+  std::error_code flush();
+
+  // Flushes the buffered data and commits the file to stable storage.
+  std::error_code sync();
+
+  std::pair<long, std::error_code> write(std::span<uint8_t const> p);
+  std::error_code write_byte(uint8_t c);
+  std::pair<long, std::error_code> write_string(std::string_view s);
+};
+
+}  // namespace bongo::os
@@ -11,6 +11,10 @@ struct error_category : std::error_category {
   const char* name() const noexcept { return "os"; }
   std::string message(int e) const {
     switch (static_cast<error>(e)) {
+    case error::negative_offset:
+      return "negative offset";
+    case error::write_at_in_append_mode:
+      return "invalid use of write_at on file opened with O_APPEND";
     default:
       return "unrecognized error";
     }
@@ -6,7 +6,10 @@
 
 namespace bongo::os {
 
-enum class error {};
+enum class error {
+  negative_offset = 1,
+  write_at_in_append_mode,
+};
 
 std::error_code make_error_code(error e);
 
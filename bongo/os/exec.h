@@ -0,0 +1,6 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <bongo/os/exec/error.h>
+#include <bongo/os/exec/exec.h>
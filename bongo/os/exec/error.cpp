@@ -0,0 +1,40 @@
+// Copyright The Go Authors.
+
+#include <system_error>
+
+#include "bongo/os/exec/error.h"
+
+namespace bongo::os::exec {
+namespace {
+
+struct error_category : std::error_category {
+  const char* name() const noexcept { return "os/exec"; }
+  std::string message(int e) const {
+    switch (static_cast<error>(e)) {
+    case error::not_found:
+      return "executable file not found in $PATH";
+    case error::already_started:
+      return "already started";
+    case error::not_started:
+      return "not started";
+    case error::already_waited:
+      return "wait was already called";
+    case error::already_set:
+      return "standard stream already set";
+    case error::exit_status:
+      return "process exited with a non-zero status";
+    default:
+      return "unrecognized error";
+    }
+  }
+};
+
+const error_category error_category{};
+
+}  // namespace
+
+std::error_code make_error_code(error e) {
+  return {static_cast<int>(e), error_category};
+}
+
+}  // namespace bongo::os::exec
@@ -0,0 +1,27 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <system_error>
+
+namespace bongo::os::exec {
+
+enum class error {
+  not_found = 1,
+  already_started,
+  not_started,
+  already_waited,
+  already_set,
+  exit_status,
+};
+
+std::error_code make_error_code(error e);
+
+}  // namespace bongo::os::exec
+
+namespace std {
+
+template <>
+struct is_error_code_enum<bongo::os::exec::error> : true_type {};
+
+}  // namespace std
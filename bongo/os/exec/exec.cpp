@@ -0,0 +1,385 @@
+// Copyright The Go Authors.
+
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "bongo/bongo.h"
+#include "bongo/context.h"
+#include "bongo/io.h"
+#include "bongo/os/exec/error.h"
+#include "bongo/os/exec/exec.h"
+#include "bongo/os/file_unix.h"
+#include "bongo/runtime/defer.h"
+#include "bongo/syscall.h"
+
+extern char** environ;
+
+namespace bongo::os::exec {
+namespace {
+
+std::error_code errno_error(int e = errno) {
+  return std::error_code{e, std::system_category()};
+}
+
+std::error_code find_executable(std::string const& file) {
+  struct ::stat s;
+  if (::stat(file.c_str(), &s) == -1) {
+    return errno_error();
+  }
+  if (S_ISDIR(s.st_mode) || (s.st_mode & 0111) == 0) {
+    return std::make_error_code(std::errc::permission_denied);
+  }
+  return nil;
+}
+
+// Returns a null-terminated array pointing into v.
+std::vector<char*> to_argv(std::vector<std::string>& v) {
+  auto argv = std::vector<char*>{};
+  argv.reserve(v.size() + 1);
+  for (auto& s : v) {
+    argv.push_back(s.data());
+  }
+  argv.push_back(nullptr);
+  return argv;
+}
+
+}  // namespace
+
+cmd::cmd(cmd&& other) noexcept
+    : ctx_{std::move(other.ctx_)}
+    , err_{other.err_}
+    , pipes_{std::exchange(other.pipes_, {-1, -1, -1})}
+    , pid_{std::exchange(other.pid_, -1)}
+    , status_{other.status_}
+    , waited_{other.waited_}
+    , killed_{std::move(other.killed_)}
+    , stop_{std::move(other.stop_)}
+    , path{std::move(other.path)}
+    , args{std::move(other.args)}
+    , env{std::move(other.env)}
+    , dir{std::move(other.dir)}
+    , stdin_file{std::exchange(other.stdin_file, nullptr)}
+    , stdout_file{std::exchange(other.stdout_file, nullptr)}
+    , stderr_file{std::exchange(other.stderr_file, nullptr)} {}
+
+cmd& cmd::operator=(cmd&& other) noexcept {
+  if (this != &other) {
+    close_pipes();
+    ctx_ = std::move(other.ctx_);
+    err_ = other.err_;
+    pipes_ = std::exchange(other.pipes_, {-1, -1, -1});
+    pid_ = std::exchange(other.pid_, -1);
+    status_ = other.status_;
+    waited_ = other.waited_;
+    killed_ = std::move(other.killed_);
+    stop_ = std::move(other.stop_);
+    path = std::move(other.path);
+    args = std::move(other.args);
+    env = std::move(other.env);
+    dir = std::move(other.dir);
+    stdin_file = std::exchange(other.stdin_file, nullptr);
+    stdout_file = std::exchange(other.stdout_file, nullptr);
+    stderr_file = std::exchange(other.stderr_file, nullptr);
+  }
+  return *this;
+}
+
+cmd::~cmd() {
+  close_pipes();
+  if (stop_) {
+    stop_();
+  }
+}
+
+std::error_code cmd::run() {
+  if (auto err = start(); err) {
+    return err;
+  }
+  return wait();
+}
+
+std::error_code cmd::start() {
+  if (pid_ != -1) {
+    return error::already_started;
+  }
+  if (err_) {
+    close_pipes();
+    return err_;
+  }
+  if (ctx_ != nullptr) {
+    if (auto err = ctx_->err(); err) {
+      close_pipes();
+      return err;
+    }
+  }
+  auto _ = runtime::defer([this]() { close_pipes(); });
+
+  posix_spawn_file_actions_t actions;
+  if (auto e = ::posix_spawn_file_actions_init(&actions); e != 0) {
+    return errno_error(e);
+  }
+  auto _1 = runtime::defer([&actions]() { ::posix_spawn_file_actions_destroy(&actions); });
+  auto files = std::array<file*, 3>{stdin_file, stdout_file, stderr_file};
+  for (int i = 0; i < 3; ++i) {
+    auto fd = pipes_[i];
+    if (fd == -1 && files[i] != nullptr) {
+      fd = static_cast<int>(files[i]->fd());
+    }
+    auto e = 0;
+    if (fd == -1) {
+      e = ::posix_spawn_file_actions_addopen(&actions, i, "/dev/null", i == 0 ? O_RDONLY : O_WRONLY, 0);
+    } else {
+      // The duplicate does not inherit close-on-exec
+      e = ::posix_spawn_file_actions_adddup2(&actions, fd, i);
+    }
+    if (e != 0) {
+      return errno_error(e);
+    }
+  }
+  if (!dir.empty()) {
+    if (auto e = ::posix_spawn_file_actions_addchdir_np(&actions, dir.c_str()); e != 0) {
+      return errno_error(e);
+    }
+  }
+
+  // Start the process with no signals blocked and default dispositions
+  posix_spawnattr_t attr;
+  if (auto e = ::posix_spawnattr_init(&attr); e != 0) {
+    return errno_error(e);
+  }
+  auto _2 = runtime::defer([&attr]() { ::posix_spawnattr_destroy(&attr); });
+  sigset_t mask, def;
+  ::sigemptyset(&mask);
+  ::sigfillset(&def);
+  ::posix_spawnattr_setsigmask(&attr, &mask);
+  ::posix_spawnattr_setsigdefault(&attr, &def);
+  ::posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK|POSIX_SPAWN_SETSIGDEF);
+
+  auto argv_strings = args.empty() ? std::vector<std::string>{path} : args;
+  auto argv = to_argv(argv_strings);
+  auto envv = to_argv(env);
+  pid_t pid;
+  auto e = ::posix_spawn(&pid, path.c_str(), &actions, &attr, argv.data(), env.empty() ? environ : envv.data());
+  if (e != 0) {
+    return errno_error(e);
+  }
+  pid_ = pid;
+
+  if (ctx_ != nullptr && ctx_->done() != nullptr) {
+    killed_ = std::make_shared<std::atomic_bool>(false);
+    stop_ = context::after_func(ctx_, [pid, killed = killed_]() {
+      // The process is not reaped until stop returns, so pid still names it
+      *killed = true;
+      ::kill(pid, SIGKILL);
+    });
+  }
+  return nil;
+}
+
+std::error_code cmd::wait() {
+  if (pid_ == -1) {
+    return error::not_started;
+  }
+  if (waited_) {
+    return error::already_waited;
+  }
+  waited_ = true;
+
+  // Wait for the process to exit without reaping it, so the cancelation
+  // callback cannot signal a reused pid.
+  siginfo_t info;
+  while (::waitid(P_PID, pid_, &info, WEXITED|WNOWAIT) == -1) {
+    if (errno != EINTR) {
+      return errno_error();
+    }
+  }
+  if (stop_) {
+    stop_();
+    stop_ = nullptr;
+  }
+  while (::waitpid(pid_, &status_, 0) == -1) {
+    if (errno != EINTR) {
+      return errno_error();
+    }
+  }
+  if (killed_ && *killed_) {
+    return ctx_->err();
+  }
+  if (!WIFEXITED(status_) || WEXITSTATUS(status_) != 0) {
+    return error::exit_status;
+  }
+  return nil;
+}
+
+std::pair<std::string, std::error_code> cmd::output() {
+  if (stdout_file != nullptr) {
+    return {"", error::already_set};
+  }
+  auto [r, err] = stdout_pipe();
+  if (err) {
+    return {"", err};
+  }
+  if (err = start(); err) {
+    return {"", err};
+  }
+  auto [b, err1] = io::read_all(r);
+  r.close();
+  if (auto err2 = wait(); err2) {
+    err1 = err2;
+  }
+  return {std::string{b.begin(), b.end()}, err1};
+}
+
+std::pair<std::string, std::error_code> cmd::combined_output() {
+  if (stdout_file != nullptr || stderr_file != nullptr || pipes_[2] != -1) {
+    return {"", error::already_set};
+  }
+  auto [r, err] = stdout_pipe();
+  if (err) {
+    return {"", err};
+  }
+  pipes_[2] = ::fcntl(pipes_[1], F_DUPFD_CLOEXEC, 0);
+  if (pipes_[2] == -1) {
+    return {"", errno_error()};
+  }
+  if (err = start(); err) {
+    return {"", err};
+  }
+  auto [b, err1] = io::read_all(r);
+  r.close();
+  if (auto err2 = wait(); err2) {
+    err1 = err2;
+  }
+  return {std::string{b.begin(), b.end()}, err1};
+}
+
+std::pair<file, std::error_code> cmd::stdin_pipe() {
+  return pipe(0);
+}
+
+std::pair<file, std::error_code> cmd::stdout_pipe() {
+  return pipe(1);
+}
+
+std::pair<file, std::error_code> cmd::stderr_pipe() {
+  return pipe(2);
+}
+
+std::error_code cmd::kill() {
+  if (pid_ == -1) {
+    return error::not_started;
+  }
+  if (waited_) {
+    return std::make_error_code(std::errc::no_such_process);
+  }
+  if (::kill(pid_, SIGKILL) == -1) {
+    return errno_error();
+  }
+  return nil;
+}
+
+int cmd::exit_code() const noexcept {
+  if (!waited_ || !WIFEXITED(status_)) {
+    return -1;
+  }
+  return WEXITSTATUS(status_);
+}
+
+std::pair<file, std::error_code> cmd::pipe(int i) {
+  if (pid_ != -1) {
+    return {file{}, error::already_started};
+  }
+  auto files = std::array<file*, 3>{stdin_file, stdout_file, stderr_file};
+  if (pipes_[i] != -1 || files[i] != nullptr) {
+    return {file{}, error::already_set};
+  }
+  int p[2];
+  if (auto err = syscall::pipe2(p, O_CLOEXEC); err) {
+    return {file{}, err};
+  }
+  // The child end stays blocking, the parent end is registered with the
+  // poller.
+  auto child = i == 0 ? p[0] : p[1];
+  auto parent = i == 0 ? p[1] : p[0];
+  syscall::set_nonblock(parent, true);
+  auto [f, err] = make_file(static_cast<uintptr_t>(parent), i == 0 ? "|1" : "|0");
+  if (err) {
+    ::close(child);
+    return {file{}, err};
+  }
+  pipes_[i] = child;
+  return {std::move(f), nil};
+}
+
+void cmd::close_pipes() {
+  for (auto& fd : pipes_) {
+    if (fd != -1) {
+      ::close(fd);
+      fd = -1;
+    }
+  }
+}
+
+cmd command(std::string name, std::vector<std::string> args) {
+  auto c = cmd{};
+  args.insert(args.begin(), name);
+  c.args = std::move(args);
+  c.path = std::move(name);
+  if (c.path.find('/') == std::string::npos) {
+    std::tie(c.path, c.err_) = look_path(c.path);
+    if (c.err_) {
+      c.path = c.args[0];
+    }
+  }
+  return c;
+}
+
+cmd command_context(context::context_type ctx, std::string name, std::vector<std::string> args) {
+  auto c = command(std::move(name), std::move(args));
+  c.ctx_ = std::move(ctx);
+  return c;
+}
+
+std::pair<std::string, std::error_code> look_path(std::string const& file) {
+  if (file.find('/') != std::string::npos) {
+    if (auto err = find_executable(file); err) {
+      return {"", err};
+    }
+    return {file, nil};
+  }
+  auto env = ::getenv("PATH");
+  auto path = std::string_view{env != nullptr ? env : ""};
+  while (!path.empty()) {
+    auto i = std::min(path.find(':'), path.size());
+    auto dir = path.substr(0, i);
+    path.remove_prefix(std::min(i + 1, path.size()));
+    if (dir.empty()) {
+      // Relative lookups in the current directory are not supported
+      continue;
+    }
+    auto name = std::string{dir} + "/" + file;
+    if (find_executable(name) == nil) {
+      return {name, nil};
+    }
+  }
+  return {"", error::not_found};
+}
+
+}  // namespace bongo::os::exec
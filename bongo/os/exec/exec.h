@@ -0,0 +1,137 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <bongo/context/context.h>
+#include <bongo/os/exec/error.h>
+#include <bongo/os/file_unix.h>
+
+namespace bongo::os::exec {
+
+/**
+ * An external command being prepared or run.
+ *
+ * The process is created with posix_spawn(3), which on Linux clones the
+ * parent with CLONE_VM|CLONE_VFORK instead of copying its page tables, so
+ * the cost of starting a command does not grow with the size of the
+ * parent.
+ *
+ * A cmd cannot be reused after calling run, output, combined_output or
+ * start. A command that is started must be waited for, or the process is
+ * left as a zombie.
+ *
+ * - https://golang.org/pkg/os/exec/#Cmd
+ */
+class cmd {
+  context::context_type ctx_;
+  std::error_code err_;  // lookup error
+  std::array<int, 3> pipes_ = {-1, -1, -1};  // child ends of pipes
+  int pid_ = -1;
+  int status_ = 0;
+  bool waited_ = false;
+  std::shared_ptr<std::atomic_bool> killed_;  // killed because ctx was done
+  std::function<bool()> stop_;
+
+ public:
+  // Path of the command to run. This is the only field that must be set
+  // to a non-empty value.
+  std::string path;
+
+  // Command line arguments, including the command as args[0].
+  std::vector<std::string> args;
+
+  // Environment of the process, each entry of the form "key=value". If
+  // empty the process uses the current environment.
+  std::vector<std::string> env;
+
+  // Working directory of the command. If empty the command runs in the
+  // calling process's current directory.
+  std::string dir;
+
+  // Open files used as the standard input, output and error of the
+  // process. If null the process uses /dev/null. The descriptors are
+  // shared with the process, so a file in non-blocking mode, such as the
+  // ends of os::pipe, is non-blocking in the process too.
+  file* stdin_file = nullptr;
+  file* stdout_file = nullptr;
+  file* stderr_file = nullptr;
+
+  cmd() = default;
+  cmd(cmd const& other) = delete;
+  cmd(cmd&& other) noexcept;
+  cmd& operator=(cmd const& other) = delete;
+  cmd& operator=(cmd&& other) noexcept;
+  ~cmd();
+
+  // Starts the command and waits for it to complete.
+  std::error_code run();
+
+  // Starts the command but does not wait for it to complete.
+  std::error_code start();
+
+  // Waits for the command to exit. The error is error::exit_status if the
+  // command exits with a non-zero status or is killed by a signal, or the
+  // context error if the command was killed because the context was done.
+  std::error_code wait();
+
+  // Runs the command and returns its standard output.
+  std::pair<std::string, std::error_code> output();
+
+  // Runs the command and returns its standard output and standard error
+  // combined.
+  std::pair<std::string, std::error_code> combined_output();
+
+  // Returns a pipe connected to the standard input, output or error of
+  // the command when it starts. The caller owns the returned end, and must
+  // close the input pipe for commands that read until end of file. The
+  // output pipes should be read to the end before calling wait.
+  std::pair<file, std::error_code> stdin_pipe();
+  std::pair<file, std::error_code> stdout_pipe();
+  std::pair<file, std::error_code> stderr_pipe();
+
+  // Sends SIGKILL to the started process.
+  std::error_code kill();
+
+  // The process ID, or -1 if the command is not started.
+  int pid() const noexcept { return pid_; }
+
+  // The exit code of the exited process, or -1 if it has not exited or
+  // was terminated by a signal.
+  int exit_code() const noexcept;
+
+  friend cmd command(std::string name, std::vector<std::string> args);
+  friend cmd command_context(context::context_type ctx, std::string name, std::vector<std::string> args);
+
+ private:
+  std::pair<file, std::error_code> pipe(int i);
+  void close_pipes();
+};
+
+// Returns a cmd to execute the named program with the given arguments.
+// If name contains no slash it is resolved with look_path.
+//
+// - https://golang.org/pkg/os/exec/#Command
+cmd command(std::string name, std::vector<std::string> args = {});
+
+// Like command but the process is killed with SIGKILL if the context is
+// done before the command completes.
+//
+// - https://golang.org/pkg/os/exec/#CommandContext
+cmd command_context(context::context_type ctx, std::string name, std::vector<std::string> args = {});
+
+// Searches the directories named by the PATH environment variable for an
+// executable named file. If file contains a slash it is tried directly.
+//
+// - https://golang.org/pkg/os/exec/#LookPath
+std::pair<std::string, std::error_code> look_path(std::string const& file);
+
+}  // namespace bongo::os::exec
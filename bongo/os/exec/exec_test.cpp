@@ -0,0 +1,170 @@
+// Copyright The Go Authors.
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "bongo/bongo.h"
+#include "bongo/bytes.h"
+#include "bongo/context.h"
+#include "bongo/io.h"
+#include "bongo/os.h"
+#include "bongo/os/exec.h"
+#include "bongo/runtime/defer.h"
+
+using namespace std::chrono_literals;
+
+namespace bongo::os::exec {
+
+TEST_CASE("Look path", "[os/exec]") {
+  auto [path, err] = look_path("sh");
+  CHECK(err == nil);
+  CHECK(path.ends_with("/sh"));
+  std::tie(path, err) = look_path("/bin/sh");
+  CHECK(err == nil);
+  CHECK(path == "/bin/sh");
+  std::tie(path, err) = look_path("bongo-no-such-command");
+  CHECK(err == error::not_found);
+  std::tie(path, err) = look_path("/etc/passwd");
+  CHECK(err == std::errc::permission_denied);
+  std::tie(path, err) = look_path("/bongo-no-such-command");
+  CHECK(err == std::errc::no_such_file_or_directory);
+}
+
+TEST_CASE("Command output", "[os/exec]") {
+  auto [out, err] = command("echo", {"hello", "world"}).output();
+  CHECK(err == nil);
+  CHECK(out == "hello world\n");
+
+  std::tie(out, err) = command("sh", {"-c", "echo out; echo err >&2"}).combined_output();
+  CHECK(err == nil);
+  CHECK(out == "out\nerr\n");
+
+  auto c = command("sh", {"-c", "pwd; echo $BONGO_TEST"});
+  c.dir = "/tmp";
+  c.env = {"BONGO_TEST=value"};
+  std::tie(out, err) = c.output();
+  CHECK(err == nil);
+  CHECK(out == "/tmp\nvalue\n");
+}
+
+TEST_CASE("Command exit status", "[os/exec]") {
+  auto c = command("sh", {"-c", "exit 3"});
+  CHECK(c.exit_code() == -1);
+  CHECK(c.run() == error::exit_status);
+  CHECK(c.exit_code() == 3);
+  CHECK(c.wait() == error::already_waited);
+  CHECK(c.start() == error::already_started);
+
+  auto c1 = command("true");
+  CHECK(c1.wait() == error::not_started);
+  CHECK(c1.kill() == error::not_started);
+  CHECK(c1.run() == nil);
+  CHECK(c1.exit_code() == 0);
+
+  CHECK(command("bongo-no-such-command").run() == error::not_found);
+  CHECK(command("/bongo-no-such-command").run() == std::errc::no_such_file_or_directory);
+
+  // Killed by a signal
+  auto c2 = command("sleep", {"10"});
+  REQUIRE(c2.start() == nil);
+  CHECK(c2.pid() > 0);
+  CHECK(c2.kill() == nil);
+  CHECK(c2.wait() == error::exit_status);
+  CHECK(c2.exit_code() == -1);
+}
+
+TEST_CASE("Command pipes", "[os/exec]") {
+  auto c = command("tr", {"a-z", "A-Z"});
+  auto [in, err] = c.stdin_pipe();
+  REQUIRE(err == nil);
+  auto [out, err1] = c.stdout_pipe();
+  REQUIRE(err1 == nil);
+  auto [out1, err2] = c.stdout_pipe();
+  CHECK(err2 == error::already_set);
+  REQUIRE(c.start() == nil);
+  auto [in1, err3] = c.stdin_pipe();
+  CHECK(err3 == error::already_started);
+
+  auto t = std::thread{[&in = in]() {
+    in.write(bytes::to_bytes(std::string_view{"hello, world\n"}));
+    in.close();
+  }};
+  auto got = bytes::buffer{};
+  auto [n, err4] = io::copy(got, out);
+  t.join();
+  CHECK(err4 == nil);
+  CHECK(got.str() == "HELLO, WORLD\n");
+  CHECK(c.wait() == nil);
+
+  // Standard streams from files
+  auto [r, w, err5] = pipe();
+  REQUIRE(err5 == nil);
+  auto c1 = command("echo", {"from a file"});
+  c1.stdout_file = &w;
+  CHECK(c1.run() == nil);
+  w.close();
+  auto [b, err6] = io::read_all(r);
+  CHECK(err6 == nil);
+  CHECK(bytes::to_string(b) == "from a file\n");
+}
+
+TEST_CASE("Command context", "[os/exec]") {
+  auto [ctx, cancel] = context::with_cancel(context::background());
+  auto c = command_context(ctx, "sleep", {"10"});
+  REQUIRE(c.start() == nil);
+  auto start = std::chrono::steady_clock::now();
+  auto t = std::thread{[&cancel = cancel]() {
+    std::this_thread::sleep_for(10ms);
+    cancel();
+  }};
+  CHECK(c.wait() == context::error::canceled);
+  t.join();
+  CHECK(std::chrono::steady_clock::now() - start < 5s);
+
+  // Already done
+  CHECK(command_context(ctx, "true").run() == context::error::canceled);
+
+  // Completes before the deadline
+  auto [ctx1, cancel1] = context::with_timeout(context::background(), 10s);
+  auto _ = runtime::defer([&cancel1 = cancel1]() { cancel1(); });
+  CHECK(command_context(ctx1, "true").run() == nil);
+}
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+TEST_CASE("Exec benchmarks", "[!benchmark]") {
+  // A large resident heap makes fork copy a large page table
+  constexpr size_t heap_size = size_t{2} << 30;
+  auto heap = ::mmap(nullptr, heap_size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+  REQUIRE(heap != MAP_FAILED);
+  auto _ = runtime::defer([heap]() { ::munmap(heap, heap_size); });
+  std::memset(heap, 1, heap_size);
+
+  BENCHMARK("Spawn /bin/true with a 2 GiB heap (posix_spawn)") {
+    return command("/bin/true").run();
+  };
+  BENCHMARK("Spawn /bin/true with a 2 GiB heap (fork)") {
+    auto pid = ::fork();
+    if (pid == 0) {
+      ::execl("/bin/true", "true", nullptr);
+      ::_exit(127);
+    }
+    int status;
+    ::waitpid(pid, &status, 0);
+    return status;
+  };
+}
+
+#endif  // defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+}  // namespace bongo::os::exec
@@ -1,15 +1,23 @@
 // Copyright The Go Authors.
 
+#include <fcntl.h>
 #include <unistd.h>
 
+#include <chrono>
 #include <memory>
+#include <span>
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <tuple>
 #include <utility>
 
 #include "bongo/bongo.h"
+#include "bongo/context.h"
+#include "bongo/io.h"
+#include "bongo/os/error.h"
 #include "bongo/os/file_unix.h"
+#include "bongo/os/stat_unix.h"
 #include "bongo/os/types.h"
 #include "bongo/syscall.h"
 
@@ -53,24 +61,20 @@ std::error_code ignoring_interrupted(Fn fn) {
   }
 }
 
-std::string_view basename(std::string_view name) {
-  long i = name.size() - 1;
-  // Remove trailing slashes
-  for (; i > 0 && name[i] == '/'; --i) {
-    name = name.substr(0, i);
-  }
-  // Remove leading directory name
-  for (--i; i >= 0; --i) {
-    if (name[i] == '/') {
-      name = name.substr(i+1);
-      break;
-    }
+int fadvise_flag(advice a) {
+  switch (a) {
+  case advice::sequential:
+    return POSIX_FADV_SEQUENTIAL;
+  case advice::random:
+    return POSIX_FADV_RANDOM;
+  case advice::will_need:
+    return POSIX_FADV_WILLNEED;
+  case advice::dont_need:
+    return POSIX_FADV_DONTNEED;
+  case advice::normal:
+  default:
+    return POSIX_FADV_NORMAL;
   }
-  return name;
-}
-
-std::chrono::system_clock::time_point to_duration(time_t t) {
-  return std::chrono::system_clock::time_point{std::chrono::seconds{t}};
 }
 
 }  // namespace
@@ -81,40 +85,158 @@ std::pair<file_info, std::error_code> file::stat() {
   if (err) {
     return {file_info{}, err};
   }
-  file_mode mode = s.st_mode & 0777;
-  switch (s.st_mode & S_IFMT) {
-  case S_IFBLK:
-    mode |= mode_device;
-    break;
-  case S_IFCHR:
-    mode |= mode_device | mode_char_device;
-    break;
-  case S_IFDIR:
-    mode |= mode_dir;
-    break;
-  case S_IFIFO:
-    mode |= mode_named_pipe;
-    break;
-  case S_IFLNK:
-    mode |= mode_symlink;
-    break;
-  case S_IFREG:
-  default:
-    break;
-  case S_IFSOCK:
-    mode |= mode_socket;
-    break;
+  return {file_info_from_stat(name_, s), nil};
+}
+
+std::pair<long, std::error_code> file::read(std::span<uint8_t> b) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  return pfd_->read(b);
+}
+
+std::pair<long, std::error_code> file::write(std::span<uint8_t const> b) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  return pfd_->write(b);
+}
+
+std::pair<long, std::error_code> file::readv(std::span<std::span<uint8_t> const> v) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  return pfd_->readv(v);
+}
+
+std::pair<long, std::error_code> file::writev(std::span<std::span<uint8_t const> const> v) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
   }
-  if ((s.st_mode&S_ISGID) != 0) {
-    mode |= mode_setgid;
+  return pfd_->writev(v);
+}
+
+std::pair<long, std::error_code> file::read(context::context_type const& ctx, std::span<uint8_t> b) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  return pfd_->read(ctx, b);
+}
+
+std::pair<long, std::error_code> file::write(context::context_type const& ctx, std::span<uint8_t const> b) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  return pfd_->write(ctx, b);
+}
+
+std::pair<long, std::error_code> file::read_at(std::span<uint8_t> b, int64_t off) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
   }
-  if ((s.st_mode&S_ISUID) != 0) {
-    mode |= mode_setuid;
+  if (off < 0) {
+    return {0, error::negative_offset};
   }
-  if ((s.st_mode&S_ISVTX) != 0) {
-    mode |= mode_sticky;
+  long n = 0;
+  while (!b.empty()) {
+    auto [m, err] = pfd_->pread(b, off);
+    if (err) {
+      return {n, err};
+    }
+    n += m;
+    b = b.subspan(m);
+    off += m;
+  }
+  return {n, nil};
+}
+
+std::pair<long, std::error_code> file::write_at(std::span<uint8_t const> b, int64_t off) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  if (append_mode_) {
+    return {0, error::write_at_in_append_mode};
+  }
+  if (off < 0) {
+    return {0, error::negative_offset};
+  }
+  long n = 0;
+  while (!b.empty()) {
+    auto [m, err] = pfd_->pwrite(b, off);
+    if (err) {
+      return {n + m, err};
+    }
+    n += m;
+    b = b.subspan(m);
+    off += m;
   }
-  return {file_info{std::string{basename(name_)}, s.st_size, mode, to_duration(s.st_mtime)}, nil};
+  return {n, nil};
+}
+
+std::pair<int64_t, std::error_code> file::seek(int64_t offset, long whence) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  return pfd_->seek(offset, static_cast<int>(whence));
+}
+
+std::error_code file::sync() {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  return pfd_->fsync();
+}
+
+std::error_code file::truncate(int64_t size) {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  return pfd_->ftruncate(size);
+}
+
+std::error_code file::advise(advice a, int64_t offset, int64_t length) {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  if (a == advice::huge_page) {
+    return nil;
+  }
+  return pfd_->fadvise(offset, length, fadvise_flag(a));
+}
+
+std::error_code file::readahead(int64_t offset, long count) {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  return pfd_->readahead(offset, count);
+}
+
+std::error_code file::set_deadline(std::chrono::system_clock::time_point t) {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  return pfd_->set_deadline(t);
+}
+
+std::error_code file::set_read_deadline(std::chrono::system_clock::time_point t) {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  return pfd_->set_read_deadline(t);
+}
+
+std::error_code file::set_write_deadline(std::chrono::system_clock::time_point t) {
+  if (auto err = check_valid(); err) {
+    return err;
+  }
+  return pfd_->set_write_deadline(t);
+}
+
+std::error_code file::check_valid() const {
+  if (!pfd_) {
+    return std::make_error_code(std::errc::invalid_argument);
+  }
+  return nil;
 }
 
 std::pair<file, std::error_code> make_file(uintptr_t fd, std::string&& name) {
@@ -154,4 +276,24 @@ std::pair<file, std::error_code> open_file_nolog(std::string const& name, long f
   return open_file_nolog(std::string{name}, flag, perm);
 }
 
+std::tuple<file, file, std::error_code> pipe() {
+  int p[2];
+  if (auto err = syscall::pipe2(p, O_CLOEXEC); err) {
+    return {file{}, file{}, err};
+  }
+  auto [r, err1] = make_file(static_cast<uintptr_t>(p[0]), "|0", new_file_kind::pipe);
+  if (err1) {
+    syscall::close(p[0]);
+    syscall::close(p[1]);
+    return {file{}, file{}, err1};
+  }
+  auto [w, err2] = make_file(static_cast<uintptr_t>(p[1]), "|1", new_file_kind::pipe);
+  if (err2) {
+    r.close();
+    syscall::close(p[1]);
+    return {file{}, file{}, err2};
+  }
+  return {std::move(r), std::move(w), nil};
+}
+
 }  // namespace bongo::os
@@ -5,12 +5,17 @@
 #include <chrono>
 #include <memory>
 #include <string>
+#include <span>
 #include <string_view>
 #include <system_error>
+#include <tuple>
 #include <utility>
 
+#include <bongo/context/context.h>
 #include <bongo/detail/poll.h>
+#include <bongo/detail/poll/zero_copy_linux.h>
 #include <bongo/detail/syscall/unix.h>
+#include <bongo/io/io.h>
 #include <bongo/os/types.h>
 
 namespace bongo::os {
@@ -19,7 +24,7 @@ class file {
   std::unique_ptr<detail::poll::fd> pfd_;
   std::string name_;
   [[maybe_unused]] bool stdout_or_err_;
-  [[maybe_unused]] bool append_mode_;
+  bool append_mode_;
 
  public:
   file() = default;
@@ -37,14 +42,124 @@ class file {
   std::string const& name() const { return name_; }
   std::error_code close() { return pfd_->close(); }
   uintptr_t fd() const noexcept { return static_cast<uintptr_t>(pfd_->sysfd); }
+  detail::poll::fd* poll_fd() const noexcept { return pfd_.get(); }
 
   std::pair<file_info, std::error_code> stat();
+
+  std::pair<long, std::error_code> read(std::span<uint8_t> b);
+  std::pair<long, std::error_code> write(std::span<uint8_t const> b);
+
+  // Vectored read and write with readv(2) and writev(2), implementing
+  // io::ReaderV and io::WriterV. A header and body are written in one
+  // system call without copying them together.
+  std::pair<long, std::error_code> readv(std::span<std::span<uint8_t> const> v);
+  std::pair<long, std::error_code> writev(std::span<std::span<uint8_t const> const> v);
+
+  // Context-aware read and write. These return the context error if ctx is
+  // done before the operation completes.
+  std::pair<long, std::error_code> read(context::context_type const& ctx, std::span<uint8_t> b);
+  std::pair<long, std::error_code> write(context::context_type const& ctx, std::span<uint8_t const> b);
+
+  // Reads len(b) bytes from the file starting at byte offset off. Unlike
+  // read, it returns an error whenever fewer than len(b) bytes are read; at
+  // end of file that error is io::eof.
+  //
+  // - https://golang.org/pkg/os/#File.ReadAt
+  std::pair<long, std::error_code> read_at(std::span<uint8_t> b, int64_t off);
+
+  // Writes len(b) bytes to the file starting at byte offset off. It returns
+  // an error if the file was opened with O_APPEND.
+  //
+  // - https://golang.org/pkg/os/#File.WriteAt
+  std::pair<long, std::error_code> write_at(std::span<uint8_t const> b, int64_t off);
+
+  // Sets the offset for the next read or write on the file, interpreted
+  // according to whence: io::seek_start, io::seek_current or io::seek_end.
+  //
+  // - https://golang.org/pkg/os/#File.Seek
+  std::pair<int64_t, std::error_code> seek(int64_t offset, long whence);
+
+  // Commits the contents of the file to stable storage.
+  //
+  // - https://golang.org/pkg/os/#File.Sync
+  std::error_code sync();
+
+  // Changes the size of the file. It does not change the I/O offset.
+  //
+  // - https://golang.org/pkg/os/#File.Truncate
+  std::error_code truncate(int64_t size);
+
+  // Declares an access pattern for length bytes of the file starting at
+  // offset, with posix_fadvise(2). A length of zero extends to the end of
+  // the file. huge_page applies only to mappings and is ignored.
+  std::error_code advise(advice a, int64_t offset = 0, int64_t length = 0);
+
+  // Starts reading count bytes of the file starting at offset into the
+  // page cache, with readahead(2). It does not wait for the reads to
+  // complete.
+  std::error_code readahead(int64_t offset, long count);
+
+  // Implements io::ReaderFrom and io::WriterTo, so io::copy to or from a
+  // file calls these directly. When the other end is also backed by a
+  // descriptor, such as another file, a pipe or a net::conn, the data is
+  // copied in the kernel with copy_file_range, sendfile or splice.
+  //
+  // - https://golang.org/pkg/os/#File.ReadFrom
+  // - https://golang.org/pkg/os/#File.WriteTo
+  template <typename U> requires io::ReaderFunc<U>
+  std::pair<int64_t, std::error_code> read_from(U& r);
+  template <typename U> requires io::WriterFunc<U>
+  std::pair<int64_t, std::error_code> write_to(U& w);
+
+  std::error_code set_deadline(std::chrono::system_clock::time_point t);
+  std::error_code set_read_deadline(std::chrono::system_clock::time_point t);
+  std::error_code set_write_deadline(std::chrono::system_clock::time_point t);
+
+ private:
+  std::error_code check_valid() const;
+
+  // Hide read_from and write_to so the generic io::copy does not call back
+  // into them.
+  struct without_read_from {
+    file* f;
+    std::pair<long, std::error_code> write(std::span<uint8_t const> b) { return f->write(b); }
+  };
+  struct without_write_to {
+    file* f;
+    std::pair<long, std::error_code> read(std::span<uint8_t> b) { return f->read(b); }
+  };
 };
 
+template <typename U> requires io::ReaderFunc<U>
+std::pair<int64_t, std::error_code> file::read_from(U& r) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  if (auto [n, handled, err] = detail::poll::zero_copy(*this, r); handled) {
+    return {n, err};
+  }
+  auto w = without_read_from{this};
+  return io::copy(w, r);
+}
+
+template <typename U> requires io::WriterFunc<U>
+std::pair<int64_t, std::error_code> file::write_to(U& w) {
+  if (auto err = check_valid(); err) {
+    return {0, err};
+  }
+  if (auto [n, handled, err] = detail::poll::zero_copy(w, *this); handled) {
+    return {n, err};
+  }
+  auto r = without_write_to{this};
+  return io::copy(w, r);
+}
+
 std::pair<file, std::error_code> make_file(uintptr_t fd, std::string&& name);
 std::pair<file, std::error_code> make_file(uintptr_t fd, std::string const& name);
 
 std::pair<file, std::error_code> open_file_nolog(std::string&& name, long flag, file_mode perm);
 std::pair<file, std::error_code> open_file_nolog(std::string const& name, long flag, file_mode perm);
 
+std::tuple<file, file, std::error_code> pipe();
+
 }  // namespace bongo::os
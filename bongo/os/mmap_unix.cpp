@@ -0,0 +1,113 @@
+// Copyright The Go Authors.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "bongo/bongo.h"
+#include "bongo/os/mmap_unix.h"
+#include "bongo/syscall.h"
+
+namespace bongo::os {
+namespace {
+
+std::error_code errno_error() {
+  return std::error_code{errno, std::system_category()};
+}
+
+int madvise_flag(advice a) {
+  switch (a) {
+  case advice::sequential:
+    return MADV_SEQUENTIAL;
+  case advice::random:
+    return MADV_RANDOM;
+  case advice::will_need:
+    return MADV_WILLNEED;
+  case advice::dont_need:
+    return MADV_DONTNEED;
+  case advice::huge_page:
+    return MADV_HUGEPAGE;
+  case advice::normal:
+  default:
+    return MADV_NORMAL;
+  }
+}
+
+}  // namespace
+
+mmap_file& mmap_file::operator=(mmap_file&& other) noexcept {
+  if (this != &other) {
+    close();
+    data_ = std::exchange(other.data_, {});
+    name_ = std::move(other.name_);
+    r_ = std::exchange(other.r_, {});
+  }
+  return *this;
+}
+
+std::error_code mmap_file::advise(advice a) {
+  if (data_.empty()) {
+    return nil;
+  }
+  auto addr = const_cast<uint8_t*>(data_.data());
+  if (::madvise(addr, data_.size(), madvise_flag(a)) == -1) {
+    auto err = errno_error();
+    if (a == advice::huge_page && err == std::errc::invalid_argument) {
+      // The kernel was built without transparent huge pages, or does not
+      // support them for this file system.
+      return nil;
+    }
+    return err;
+  }
+  return nil;
+}
+
+std::error_code mmap_file::close() {
+  if (data_.empty()) {
+    return nil;
+  }
+  auto addr = const_cast<uint8_t*>(data_.data());
+  auto size = data_.size();
+  data_ = {};
+  r_.reset({});
+  if (::munmap(addr, size) == -1) {
+    return errno_error();
+  }
+  return nil;
+}
+
+std::pair<mmap_file, std::error_code> open_mmap_file(std::string const& name) {
+  auto [fd, err] = syscall::open(name, O_RDONLY|O_CLOEXEC, 0);
+  if (err) {
+    return {mmap_file{}, err};
+  }
+  auto _ = defer([fd = fd]() { syscall::close(fd); });
+  struct ::stat s;
+  if (err = syscall::fstat(fd, &s); err) {
+    return {mmap_file{}, err};
+  }
+  if (!S_ISREG(s.st_mode)) {
+    return {mmap_file{}, std::make_error_code(std::errc::invalid_argument)};
+  }
+  if (s.st_size == 0) {
+    // A zero length mapping is invalid.
+    return {mmap_file{{}, name}, nil};
+  }
+  auto size = static_cast<size_t>(s.st_size);
+  auto addr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) {
+    return {mmap_file{}, errno_error()};
+  }
+  auto data = std::span<uint8_t const>{static_cast<uint8_t const*>(addr), size};
+  return {mmap_file{data, name}, nil};
+}
+
+}  // namespace bongo::os
@@ -0,0 +1,82 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <bongo/bytes/reader.h>
+#include <bongo/io/io.h>
+#include <bongo/os/types.h>
+
+namespace bongo::os {
+
+/**
+ * A read-only memory-mapped file.
+ *
+ * The contents are available directly through bytes(), so algorithms that
+ * operate on a std::span need not copy them. The file also implements
+ * io::Reader, io::ReaderAt, io::Seeker and io::WriterTo over the mapping.
+ *
+ * read_at may be called concurrently. read, seek and write_to share an
+ * offset and must not be. Truncating the file while it is mapped causes
+ * access past the new end of file to raise SIGBUS.
+ *
+ * - https://pkg.go.dev/golang.org/x/exp/mmap
+ */
+class mmap_file {
+  std::span<uint8_t const> data_;
+  std::string name_;
+  bytes::reader r_;
+
+ public:
+  mmap_file() = default;
+  mmap_file(std::span<uint8_t const> data, std::string name)
+      : data_{data}
+      , name_{std::move(name)}
+      , r_{data} {}
+  mmap_file(mmap_file const& other) = delete;
+  mmap_file& operator=(mmap_file const& other) = delete;
+  mmap_file(mmap_file&& other) noexcept
+      : data_{std::exchange(other.data_, {})}
+      , name_{std::move(other.name_)}
+      , r_{std::exchange(other.r_, {})} {}
+  mmap_file& operator=(mmap_file&& other) noexcept;
+  ~mmap_file() { close(); }
+
+  std::string const& name() const noexcept { return name_; }
+
+  // The mapped contents of the file. The span is valid until close.
+  std::span<uint8_t const> bytes() const noexcept { return data_; }
+
+  int64_t size() const noexcept { return static_cast<int64_t>(data_.size()); }
+
+  // Returns the byte at index i.
+  uint8_t at(int64_t i) const { return data_[i]; }
+
+  std::pair<long, std::error_code> read(std::span<uint8_t> b) { return r_.read(b); }
+  std::pair<long, std::error_code> read_at(std::span<uint8_t> b, int64_t off) { return r_.read_at(b, off); }
+  std::pair<int64_t, std::error_code> seek(int64_t offset, long whence) { return r_.seek(offset, whence); }
+
+  // Writes the contents from the current offset to w with a single call.
+  template <typename U> requires io::WriterFunc<U>
+  std::pair<int64_t, std::error_code> write_to(U& w) { return r_.write_to(w); }
+
+  // Advises the kernel how the mapping will be accessed. Hints the kernel
+  // does not support, such as huge pages for file mappings on some
+  // configurations, are ignored.
+  std::error_code advise(advice a);
+
+  // Unmaps the file. The span returned by bytes() is no longer valid.
+  std::error_code close();
+};
+
+// Maps the named file into memory for reading.
+//
+// - https://pkg.go.dev/golang.org/x/exp/mmap#Open
+std::pair<mmap_file, std::error_code> open_mmap_file(std::string const& name);
+
+}  // namespace bongo::os
@@ -8,7 +8,12 @@
 #include <system_error>
 #include <utility>
 
+#include <bongo/os/dir_unix.h>
+#include <bongo/os/direct_linux.h>
+#include <bongo/os/error.h>
 #include <bongo/os/file.h>
+#include <bongo/os/mmap_unix.h>
+#include <bongo/os/stat_unix.h>
 #include <bongo/os/types.h>
 
 namespace bongo::os {
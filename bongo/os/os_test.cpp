@@ -1,11 +1,56 @@
 // Copyright The Go Authors.
 
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <catch2/catch.hpp>
 
 #include "bongo/bongo.h"
+#include "bongo/bufio.h"
+#include "bongo/bytes.h"
+#include "bongo/context.h"
+#include "bongo/detail/poll/error.h"
+#include "bongo/io.h"
 #include "bongo/os.h"
+#include "bongo/strings.h"
+
+using namespace std::chrono_literals;
 
 namespace bongo::os {
+namespace {
+
+// Returns the name of a file that does not yet exist. The caller removes
+// it.
+std::string temp_name() {
+  static int n = 0;
+  return "/tmp/bongo-os-test-" + std::to_string(::getpid()) + "-" + std::to_string(n++);
+}
+
+// Returns the name of a new temporary directory. The caller removes it.
+std::string temp_dir() {
+  auto name = temp_name();
+  REQUIRE(::mkdir(name.c_str(), 0755) == 0);
+  return name;
+}
+
+// Creates an empty file.
+void touch(std::string const& name) {
+  auto [f, err] = create(name);
+  REQUIRE(err == nil);
+}
+
+}  // namespace
 
 TEST_CASE("Stat", "[os]") {
   auto [file, err1] = open("/etc/group");
@@ -24,4 +69,858 @@ TEST_CASE("Fstat", "[os]") {
 TEST_CASE("Fstat error", "[os]") {
 }
 
+TEST_CASE("Pipe read/write", "[os]") {
+  auto [r, w, err] = pipe();
+  REQUIRE(err == nil);
+  auto [n, err1] = w.write(bytes::to_bytes(std::string_view{"hello"}));
+  CHECK(n == 5);
+  CHECK(err1 == nil);
+  auto buf = std::vector<uint8_t>(64);
+  auto [m, err2] = r.read(buf);
+  CHECK(err2 == nil);
+  CHECK(bytes::to_string(buf, m) == "hello");
+  w.close();
+  std::tie(m, err2) = r.read(buf);
+  CHECK(m == 0);
+  CHECK(err2 == io::eof);
+}
+
+TEST_CASE("Pipe readv/writev", "[os]") {
+  auto [r, w, err] = pipe();
+  REQUIRE(err == nil);
+  auto v = std::array{bytes::to_bytes(std::string_view{"hel"}), bytes::to_bytes(std::string_view{"lo"})};
+  auto [n, err1] = w.writev(v);
+  CHECK(n == 5);
+  CHECK(err1 == nil);
+  auto b1 = std::vector<uint8_t>(2);
+  auto b2 = std::vector<uint8_t>(64);
+  auto iov = std::array{std::span{b1}, std::span{b2}};
+  auto [m, err2] = r.readv(iov);
+  CHECK(err2 == nil);
+  CHECK(m == 5);
+  CHECK(std::string{bytes::to_string(b1)}.append(bytes::to_string(b2, 3)) == "hello");
+  w.close();
+  std::tie(m, err2) = r.readv(iov);
+  CHECK(m == 0);
+  CHECK(err2 == io::eof);
+}
+
+TEST_CASE("Read deadline", "[os]") {
+  auto [r, w, err] = pipe();
+  REQUIRE(err == nil);
+  auto buf = std::vector<uint8_t>(64);
+  REQUIRE(r.set_read_deadline(std::chrono::system_clock::now() + 1ms) == nil);
+  auto [n, err1] = r.read(buf);
+  CHECK(n == 0);
+  CHECK(err1 == detail::poll::error::deadline_exceeded);
+
+  // Clearing the deadline makes the file readable again
+  REQUIRE(r.set_read_deadline(std::chrono::system_clock::time_point{}) == nil);
+  w.write(bytes::to_bytes(std::string_view{"x"}));
+  std::tie(n, err1) = r.read(buf);
+  CHECK(n == 1);
+  CHECK(err1 == nil);
+}
+
+TEST_CASE("Regular file deadline", "[os]") {
+  // Regular files cannot be registered with epoll and always block.
+  auto [file, err1] = open("/etc/group");
+  REQUIRE(err1 == nil);
+  CHECK(file.set_read_deadline(std::chrono::system_clock::now() + 1ms) == detail::poll::error::no_deadline);
+}
+
+TEST_CASE("Extend read deadline", "[os]") {
+  auto [r, w, err] = pipe();
+  REQUIRE(err == nil);
+  auto buf = std::vector<uint8_t>(64);
+  REQUIRE(r.set_read_deadline(std::chrono::system_clock::now() + 20ms) == nil);
+  auto t = std::thread{[&r]() {
+    // Extend the deadline while the reader is parked
+    std::this_thread::sleep_for(5ms);
+    r.set_read_deadline(std::chrono::system_clock::now() + 1h);
+  }};
+  auto t1 = std::thread{[&w]() {
+    std::this_thread::sleep_for(100ms);
+    w.write(bytes::to_bytes(std::string_view{"x"}));
+  }};
+  auto [n, err1] = r.read(buf);
+  t.join();
+  t1.join();
+  CHECK(n == 1);
+  CHECK(err1 == nil);
+}
+
+TEST_CASE("Context canceled during read", "[os]") {
+  auto [r, w, err] = pipe();
+  REQUIRE(err == nil);
+  auto [ctx, cancel] = context::with_cancel(context::background());
+  auto t = std::thread{[&]() {
+    std::this_thread::sleep_for(1ms);
+    cancel();
+  }};
+  auto buf = std::vector<uint8_t>(64);
+  auto [n, err1] = r.read(ctx, buf);
+  CHECK(n == 0);
+  CHECK(err1 == context::error::canceled);
+  t.join();
+
+  // The deadline is restored after the operation
+  w.write(bytes::to_bytes(std::string_view{"x"}));
+  std::tie(n, err1) = r.read(buf);
+  CHECK(n == 1);
+  CHECK(err1 == nil);
+}
+
+TEST_CASE("Context deadline during write", "[os]") {
+  auto [r, w, err] = pipe();
+  REQUIRE(err == nil);
+  auto [ctx, cancel] = context::with_timeout(context::background(), 10ms);
+  auto buf = std::vector<uint8_t>(1 << 20);
+  auto [n, err1] = w.write(ctx, buf);
+  CHECK(n < static_cast<long>(buf.size()));
+  CHECK(err1 == context::error::deadline_exceeded);
+  cancel();
+
+  std::tie(n, err1) = w.write(ctx, buf);
+  CHECK(n == 0);
+  CHECK(err1 == ctx->err());
+}
+
+TEST_CASE("Read at and write at", "[os]") {
+  auto name = temp_name();
+  auto [f, err] = create(name);
+  REQUIRE(err == nil);
+  auto _ = defer([&name]() { ::unlink(name.c_str()); });
+
+  auto [n, err1] = f.write_at(bytes::to_bytes(std::string_view{"hello, world"}), 0);
+  CHECK(n == 12);
+  CHECK(err1 == nil);
+  std::tie(n, err1) = f.write_at(bytes::to_bytes(std::string_view{"WORLD"}), 7);
+  CHECK(n == 5);
+  CHECK(err1 == nil);
+
+  auto buf = std::vector<uint8_t>(5);
+  std::tie(n, err1) = f.read_at(buf, 7);
+  CHECK(n == 5);
+  CHECK(err1 == nil);
+  CHECK(bytes::to_string(buf, n) == "WORLD");
+
+  // A short read at end of file reports io::eof
+  std::tie(n, err1) = f.read_at(buf, 10);
+  CHECK(n == 2);
+  CHECK(err1 == io::eof);
+  CHECK(bytes::to_string(buf, n) == "LD");
+
+  std::tie(n, err1) = f.read_at(buf, -1);
+  CHECK(err1 == error::negative_offset);
+  std::tie(n, err1) = f.write_at(buf, -1);
+  CHECK(err1 == error::negative_offset);
+
+  // Positional I/O does not move the file offset
+  std::tie(n, err1) = f.read(buf);
+  CHECK(n == 5);
+  CHECK(bytes::to_string(buf, n) == "hello");
+}
+
+TEST_CASE("Write at in append mode", "[os]") {
+  auto name = temp_name();
+  auto [f, err] = open_file(name, o_wronly|o_create|o_append, 0600);
+  REQUIRE(err == nil);
+  auto _ = defer([&name]() { ::unlink(name.c_str()); });
+  auto [n, err1] = f.write_at(bytes::to_bytes(std::string_view{"x"}), 0);
+  CHECK(n == 0);
+  CHECK(err1 == error::write_at_in_append_mode);
+}
+
+TEST_CASE("Seek", "[os]") {
+  auto name = temp_name();
+  auto [f, err] = create(name);
+  REQUIRE(err == nil);
+  auto _ = defer([&name]() { ::unlink(name.c_str()); });
+  f.write(bytes::to_bytes(std::string_view{"hello, world\n"}));
+
+  struct {
+    int64_t in;
+    long whence;
+    int64_t out;
+  } tests[] = {
+    {0, io::seek_current, 13},
+    {0, io::seek_start, 0},
+    {5, io::seek_start, 5},
+    {0, io::seek_end, 13},
+    {0, io::seek_start, 0},
+    {2, io::seek_current, 2},
+    {-1, io::seek_end, 12},
+    {1 << 20, io::seek_start, 1 << 20},
+  };
+  for (auto& tt : tests) {
+    auto [off, err1] = f.seek(tt.in, tt.whence);
+    CHECK(err1 == nil);
+    CHECK(off == tt.out);
+  }
+  auto [off, err1] = f.seek(-1, io::seek_start);
+  CHECK(err1 == std::errc::invalid_argument);
+
+  auto [r, w, err2] = pipe();
+  REQUIRE(err2 == nil);
+  std::tie(off, err1) = r.seek(0, io::seek_current);
+  CHECK(err1 == std::errc::invalid_seek);
+}
+
+TEST_CASE("Copy to and from a file", "[os]") {
+  auto name = temp_name();
+  auto [f, err] = create(name);
+  REQUIRE(err == nil);
+  auto _ = defer([&name]() { ::unlink(name.c_str()); });
+
+  auto text = std::string{};
+  for (int i = 0; i < 10000; ++i) {
+    text += std::to_string(i) + "\n";
+  }
+  auto sr = strings::reader{text};
+  auto [n, err1] = io::copy(f, sr);
+  CHECK(n == static_cast<int64_t>(text.size()));
+  CHECK(err1 == nil);
+
+  f.seek(0, io::seek_start);
+  auto buf = bytes::buffer{};
+  std::tie(n, err1) = io::copy(buf, f);
+  CHECK(n == static_cast<int64_t>(text.size()));
+  CHECK(err1 == nil);
+  CHECK(buf.str() == text);
+
+  // File to file
+  auto name1 = temp_name();
+  auto [g, err2] = create(name1);
+  REQUIRE(err2 == nil);
+  auto _1 = defer([&name1]() { ::unlink(name1.c_str()); });
+  f.seek(0, io::seek_start);
+  std::tie(n, err1) = io::copy(g, f);
+  CHECK(n == static_cast<int64_t>(text.size()));
+  CHECK(err1 == nil);
+
+  // Through bufio
+  g.seek(0, io::seek_start);
+  auto br = bufio::reader{g};
+  auto [line, err3] = br.read_string('\n');
+  CHECK(err3 == nil);
+  CHECK(line == "0\n");
+}
+
+TEST_CASE("Zero-copy between files and pipes", "[os]") {
+  auto text = std::string{};
+  for (int i = 0; i < 100000; ++i) {
+    text += std::to_string(i) + "\n";
+  }
+  auto name = temp_name();
+  auto [f, err] = create(name);
+  REQUIRE(err == nil);
+  auto _ = defer([&name]() { ::unlink(name.c_str()); });
+  f.write(bytes::to_bytes(text));
+  f.seek(0, io::seek_start);
+
+  // File to pipe, larger than the pipe buffer
+  auto [r, w, err1] = pipe();
+  REQUIRE(err1 == nil);
+  auto got = bytes::buffer{};
+  auto t = std::thread{[&r = r, &got]() {
+    io::copy(got, r);
+  }};
+  auto [n, err2] = io::copy(w, f);
+  CHECK(n == static_cast<int64_t>(text.size()));
+  CHECK(err2 == nil);
+  w.close();
+  t.join();
+  CHECK(got.str() == text);
+
+  // Pipe to file, with a limit
+  auto [r1, w1, err3] = pipe();
+  REQUIRE(err3 == nil);
+  auto t1 = std::thread{[&w1 = w1, &text]() {
+    w1.write(bytes::to_bytes(text));
+    w1.close();
+  }};
+  auto name1 = temp_name();
+  auto [g, err4] = create(name1);
+  REQUIRE(err4 == nil);
+  auto _1 = defer([&name1]() { ::unlink(name1.c_str()); });
+  std::tie(n, err2) = io::copy_n(g, r1, 10);
+  CHECK(n == 10);
+  CHECK(err2 == nil);
+  std::tie(n, err2) = io::copy(g, r1);
+  t1.join();
+  CHECK(n == static_cast<int64_t>(text.size()) - 10);
+  CHECK(err2 == nil);
+
+  // A destination in append mode falls back to read and write
+  auto [h, err5] = open_file(name1, o_wronly|o_append, 0);
+  REQUIRE(err5 == nil);
+  f.seek(0, io::seek_start);
+  auto lr = io::limited_reader{f, 3};
+  std::tie(n, err2) = io::copy(h, lr);
+  CHECK(n == 3);
+  CHECK(err2 == nil);
+
+  g.seek(0, io::seek_start);
+  auto all = bytes::buffer{};
+  io::copy(all, g);
+  CHECK(all.str() == text + text.substr(0, 3));
+}
+
+TEST_CASE("Mmap file", "[os]") {
+  auto text = std::string{};
+  for (int i = 0; i < 1000; ++i) {
+    text += std::to_string(i) + "\n";
+  }
+  auto name = temp_name();
+  auto [f, err] = create(name);
+  REQUIRE(err == nil);
+  auto _ = defer([&name]() { ::unlink(name.c_str()); });
+  f.write(bytes::to_bytes(text));
+
+  auto [m, err1] = open_mmap_file(name);
+  REQUIRE(err1 == nil);
+  CHECK(m.name() == name);
+  CHECK(m.size() == static_cast<int64_t>(text.size()));
+  CHECK(bytes::to_string(m.bytes()) == text);
+  CHECK(m.at(0) == '0');
+  for (auto a : {advice::sequential, advice::random, advice::will_need, advice::huge_page, advice::normal}) {
+    CHECK(m.advise(a) == nil);
+  }
+
+  auto buf = std::vector<uint8_t>(4);
+  auto [n, err2] = m.read(buf);
+  CHECK(n == 4);
+  CHECK(err2 == nil);
+  CHECK(bytes::to_string(buf, n) == "0\n1\n");
+  std::tie(n, err2) = m.read_at(buf, static_cast<int64_t>(text.size()) - 2);
+  CHECK(n == 2);
+  CHECK(err2 == io::eof);
+  auto [off, err3] = m.seek(-4, io::seek_end);
+  CHECK(off == static_cast<int64_t>(text.size()) - 4);
+  CHECK(err3 == nil);
+  auto out = bytes::buffer{};
+  auto [nw, err4] = m.write_to(out);
+  CHECK(nw == 4);
+  CHECK(err4 == nil);
+  CHECK(out.str() == "999\n");
+  std::tie(n, err2) = m.read(buf);
+  CHECK(n == 0);
+  CHECK(err2 == io::eof);
+
+  // Scanning lines through io::Reader
+  m.seek(0, io::seek_start);
+  auto s = bufio::scanner{m, &bufio::scan_lines};
+  auto lines = 0;
+  while (s.scan()) {
+    CHECK(s.text() == std::to_string(lines));
+    ++lines;
+  }
+  CHECK(lines == 1000);
+
+  // Moving transfers the mapping
+  auto m1 = std::move(m);
+  CHECK(m.bytes().empty());
+  CHECK(m1.size() == static_cast<int64_t>(text.size()));
+  CHECK(m1.close() == nil);
+  CHECK(m1.bytes().empty());
+}
+
+TEST_CASE("Mmap empty file", "[os]") {
+  auto name = temp_name();
+  auto [f, err] = create(name);
+  REQUIRE(err == nil);
+  auto _ = defer([&name]() { ::unlink(name.c_str()); });
+  auto [m, err1] = open_mmap_file(name);
+  REQUIRE(err1 == nil);
+  CHECK(m.size() == 0);
+  auto buf = std::vector<uint8_t>(4);
+  auto [n, err2] = m.read(buf);
+  CHECK(n == 0);
+  CHECK(err2 == io::eof);
+
+  auto [m1, err3] = open_mmap_file("/tmp");
+  CHECK(err3 == std::errc::invalid_argument);
+  auto [m2, err4] = open_mmap_file(name + "-missing");
+  CHECK(err4 == std::errc::no_such_file_or_directory);
+}
+
+TEST_CASE("Read directory", "[os]") {
+  auto dir = temp_dir();
+  auto _ = defer([&dir]() { std::filesystem::remove_all(dir); });
+  touch(dir + "/b");
+  touch(dir + "/a");
+  REQUIRE(::mkdir((dir + "/c").c_str(), 0755) == 0);
+  REQUIRE(::symlink("a", (dir + "/l").c_str()) == 0);
+  auto [f, err] = open_file(dir + "/a", o_wronly, 0);
+  REQUIRE(err == nil);
+  f.write(bytes::to_bytes(std::string_view{"hello"}));
+
+  auto [entries, err1] = read_dir(dir);
+  REQUIRE(err1 == nil);
+  REQUIRE(entries.size() == 4);
+  CHECK(entries[0].name() == "a");
+  CHECK(entries[0].type() == 0);
+  CHECK(entries[0].path() == dir + "/a");
+  CHECK(entries[1].name() == "b");
+  CHECK(entries[2].name() == "c");
+  CHECK(entries[2].is_dir());
+  CHECK(entries[2].type() == mode_dir);
+  CHECK(entries[3].name() == "l");
+  CHECK(entries[3].type() == mode_symlink);
+
+  // Stats lazily, without following links
+  auto [info, err2] = entries[0].info();
+  CHECK(err2 == nil);
+  CHECK(info.name == "a");
+  CHECK(info.size == 5);
+  std::tie(info, err2) = entries[3].info();
+  CHECK(err2 == nil);
+  CHECK(info.mode.type() == mode_symlink);
+  ::unlink((dir + "/b").c_str());
+  std::tie(info, err2) = entries[1].info();
+  CHECK(err2 == std::errc::no_such_file_or_directory);
+
+  std::tie(entries, err1) = read_dir(dir + "/a");
+  CHECK(entries.empty());
+  CHECK(err1 == std::errc::not_a_directory);
+  std::tie(entries, err1) = read_dir(dir + "/missing");
+  CHECK(err1 == std::errc::no_such_file_or_directory);
+}
+
+TEST_CASE("Walk directory", "[os]") {
+  auto dir = temp_dir();
+  auto _ = defer([&dir]() { std::filesystem::remove_all(dir); });
+  touch(dir + "/b");
+  touch(dir + "/a");
+  REQUIRE(::mkdir((dir + "/c").c_str(), 0755) == 0);
+  touch(dir + "/c/d");
+  REQUIRE(::mkdir((dir + "/c/e").c_str(), 0755) == 0);
+  touch(dir + "/c/e/f");
+  REQUIRE(::symlink("c", (dir + "/l").c_str()) == 0);
+  auto all = std::vector<std::string>{
+    dir, dir + "/a", dir + "/b", dir + "/c", dir + "/c/d", dir + "/c/e", dir + "/c/e/f", dir + "/l",
+  };
+
+  for (int threads : {1, 4}) {
+    auto mu = std::mutex{};
+    auto got = std::vector<std::string>{};
+    auto collect = [&](std::string const& path, std::error_code result) {
+      return [&, path, result](std::string const& p, dir_entry const& d, std::error_code err) {
+        CHECK(err == nil);
+        auto lock = std::lock_guard{mu};
+        got.push_back(p);
+        CHECK(d.path() == p);
+        return p == path ? result : nil;
+      };
+    };
+    auto sorted = [&got]() {
+      std::sort(got.begin(), got.end());
+      return got;
+    };
+
+    // Visits every file, lexically with one thread
+    CHECK(walk_dir(dir, collect("", nil), threads) == nil);
+    if (threads == 1) {
+      CHECK(got == all);
+    }
+    CHECK(sorted() == all);
+
+    // Skipping a directory
+    got.clear();
+    CHECK(walk_dir(dir, collect(dir + "/c", io::fs::skip_dir), threads) == nil);
+    CHECK(sorted() == std::vector<std::string>{dir, dir + "/a", dir + "/b", dir + "/c", dir + "/l"});
+
+    // Skipping everything
+    got.clear();
+    CHECK(walk_dir(dir, collect(dir, io::fs::skip_all), threads) == nil);
+    CHECK(got == std::vector<std::string>{dir});
+
+    // Other errors stop the walk
+    got.clear();
+    CHECK(walk_dir(dir, collect(dir + "/c/e", std::make_error_code(std::errc::io_error)), threads) == std::errc::io_error);
+    CHECK(std::find(got.begin(), got.end(), dir + "/c/e/f") == got.end());
+  }
+
+  // Errors are reported to the walk function
+  auto calls = 0;
+  auto err = walk_dir(dir + "/missing", [&calls](std::string const&, dir_entry const&, std::error_code err) {
+    ++calls;
+    return err;
+  });
+  CHECK(err == std::errc::no_such_file_or_directory);
+  CHECK(calls == 1);
+}
+
+TEST_CASE("Sync and truncate", "[os]") {
+  auto name = temp_name();
+  auto [f, err] = create(name);
+  REQUIRE(err == nil);
+  auto _ = defer([&name]() { ::unlink(name.c_str()); });
+  f.write(bytes::to_bytes(std::string_view{"hello, world"}));
+  CHECK(f.sync() == nil);
+  CHECK(f.truncate(5) == nil);
+  auto [info, err1] = f.stat();
+  CHECK(info.size == 5);
+  CHECK(f.truncate(-1) == std::errc::invalid_argument);
+}
+
+TEST_CASE("Direct writer", "[os]") {
+  auto name = temp_name();
+  auto [f, err] = open_file(name, o_rdwr|o_create|o_direct, 0644);
+  REQUIRE(err == nil);
+  auto _ = defer([&name]() { ::unlink(name.c_str()); });
+  auto want = std::string{};
+
+  {
+    // Unaligned records, flushed part way through a block
+    auto w = direct_writer{f, 1};
+    CHECK(w.size() == direct_alignment);
+    for (int i = 0; i < 1000; ++i) {
+      auto record = std::to_string(i) + "\n";
+      auto [n, err1] = w.write_string(record);
+      CHECK(n == static_cast<long>(record.size()));
+      CHECK(err1 == nil);
+      want += record;
+      if (i % 300 == 0) {
+        CHECK(w.flush() == nil);
+        CHECK(f.stat().first.size == static_cast<int64_t>(want.size()));
+      }
+    }
+    CHECK(w.write_byte('!') == nil);
+    want += "!";
+    CHECK(w.sync() == nil);
+    CHECK(w.buffered() == static_cast<long>(want.size() % direct_alignment));
+  }
+
+  // Appends after the partial last block of an existing file
+  {
+    auto w = direct_writer{f};
+    CHECK(w.size() == direct_writer::default_size);
+    CHECK(w.buffered() == static_cast<long>(want.size() % direct_alignment));
+    auto block = std::string(3 * direct_alignment, 'x');
+    w.write_string(block);
+    want += block;
+  }
+
+  auto [g, err2] = open(name);
+  REQUIRE(err2 == nil);
+  auto got = bytes::buffer{};
+  io::copy(got, g);
+  CHECK(got.str() == want);
+
+  // Buffered reads and writes of o_direct files must be aligned
+  auto buf = std::vector<uint8_t>(10);
+  auto [n, err3] = f.read_at(buf, 0);
+  CHECK(err3 == std::errc::invalid_argument);
+
+  auto [h, err4] = open_file(name, o_wronly|o_append, 0);
+  REQUIRE(err4 == nil);
+  auto w = direct_writer{h};
+  auto [n1, err5] = w.write_string("x");
+  CHECK(err5 != nil);
+}
+
+TEST_CASE("File advise and readahead", "[os]") {
+  auto name = temp_name();
+  auto [f, err] = create(name);
+  REQUIRE(err == nil);
+  auto _ = defer([&name]() { ::unlink(name.c_str()); });
+  f.write(bytes::to_bytes(std::string(1 << 20, 'x')));
+  for (auto a : {advice::sequential, advice::random, advice::will_need, advice::dont_need, advice::huge_page, advice::normal}) {
+    CHECK(f.advise(a) == nil);
+  }
+  CHECK(f.advise(advice::will_need, 4096, 8192) == nil);
+  CHECK(f.advise(advice::normal, 0, -1) == std::errc::invalid_argument);
+  CHECK(f.readahead(0, 1 << 20) == nil);
+
+  auto [r, w, err1] = pipe();
+  REQUIRE(err1 == nil);
+  CHECK(r.readahead(0, 4096) == std::errc::invalid_argument);
+  CHECK(r.advise(advice::sequential) == std::errc::invalid_seek);
+}
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+TEST_CASE("File benchmarks", "[!benchmark]") {
+  constexpr int64_t size = 64 << 20;
+  auto name = temp_name();
+  auto [f, err] = create(name);
+  REQUIRE(err == nil);
+  auto _ = defer([&name]() { ::unlink(name.c_str()); });
+  auto buf = std::vector<uint8_t>(1 << 20, 'x');
+
+  BENCHMARK("Sequential 1 MiB writes (64 MiB)") {
+    f.seek(0, io::seek_start);
+    for (int64_t off = 0; off < size; off += buf.size()) {
+      f.write(buf);
+    }
+  };
+
+  BENCHMARK("Sequential 1 MiB reads (64 MiB)") {
+    f.seek(0, io::seek_start);
+    for (;;) {
+      auto [n, err1] = f.read(buf);
+      if (err1) {
+        break;
+      }
+    }
+  };
+
+  auto gen = std::mt19937{1};
+  auto dist = std::uniform_int_distribution<int64_t>{0, size/4096 - 1};
+  auto page = std::vector<uint8_t>(4096);
+  BENCHMARK("Random 4 KiB read_at") {
+    return f.read_at(page, dist(gen)*4096);
+  };
+}
+
+TEST_CASE("Copy file benchmarks", "[!benchmark]") {
+  constexpr int64_t size = 1 << 30;
+  auto name = temp_name();
+  auto [src, err] = create(name);
+  REQUIRE(err == nil);
+  auto _ = defer([&name]() { ::unlink(name.c_str()); });
+  auto buf = std::vector<uint8_t>(1 << 20, 'x');
+  for (int64_t off = 0; off < size; off += buf.size()) {
+    src.write(buf);
+  }
+  auto name1 = temp_name();
+  auto [dst, err1] = create(name1);
+  REQUIRE(err1 == nil);
+  auto _1 = defer([&name1]() { ::unlink(name1.c_str()); });
+
+  // Hide read_from and write_to so io::copy uses its 32 KiB buffer.
+  struct reader_only {
+    file& f;
+    std::pair<long, std::error_code> read(std::span<uint8_t> b) { return f.read(b); }
+  };
+  struct writer_only {
+    file& f;
+    std::pair<long, std::error_code> write(std::span<uint8_t const> b) { return f.write(b); }
+  };
+
+  // A sample copies the whole file once, the files are rewound before
+  // measuring.
+  auto rewind = [&]() {
+    src.seek(0, io::seek_start);
+    dst.seek(0, io::seek_start);
+  };
+  BENCHMARK_ADVANCED("32 KiB buffer")(Catch::Benchmark::Chronometer meter) {
+    rewind();
+    auto n = int64_t{0};
+    auto err2 = std::error_code{};
+    meter.measure([&]() {
+      auto r = reader_only{src};
+      auto w = writer_only{dst};
+      std::tie(n, err2) = io::copy(w, r);
+      return n;
+    });
+    CHECK(n == size);
+    CHECK(err2 == nil);
+  };
+  BENCHMARK_ADVANCED("zero-copy")(Catch::Benchmark::Chronometer meter) {
+    rewind();
+    auto n = int64_t{0};
+    auto err2 = std::error_code{};
+    meter.measure([&]() {
+      std::tie(n, err2) = io::copy(dst, src);
+      return n;
+    });
+    CHECK(n == size);
+    CHECK(err2 == nil);
+  };
+}
+
+TEST_CASE("Mmap benchmarks", "[!benchmark]") {
+  constexpr int64_t size = 256 << 20;
+  auto name = temp_name();
+  auto [f, err] = create(name);
+  REQUIRE(err == nil);
+  auto _ = defer([&name]() { ::unlink(name.c_str()); });
+  auto line = std::string(99, 'x') + "\n";
+  auto chunk = std::string{};
+  while (chunk.size() < (1 << 20)) {
+    chunk += line;
+  }
+  for (int64_t off = 0; off < size; off += chunk.size()) {
+    f.write(bytes::to_bytes(chunk));
+  }
+  auto [m, err1] = open_mmap_file(name);
+  REQUIRE(err1 == nil);
+  m.advise(advice::will_need);
+
+  auto gen = std::mt19937{1};
+  auto dist = std::uniform_int_distribution<int64_t>{0, m.size()/4096 - 1};
+  auto page = std::vector<uint8_t>(4096);
+  BENCHMARK("Random 4 KiB read_at (file)") {
+    return f.read_at(page, dist(gen)*4096);
+  };
+  BENCHMARK("Random 4 KiB read_at (mmap)") {
+    return m.read_at(page, dist(gen)*4096);
+  };
+
+  BENCHMARK("Count lines with bufio::scanner (file)") {
+    f.seek(0, io::seek_start);
+    auto s = bufio::scanner{f, &bufio::scan_lines};
+    auto n = 0;
+    while (s.scan()) {
+      ++n;
+    }
+    return n;
+  };
+  BENCHMARK("Count lines over the mapping (mmap)") {
+    auto data = m.bytes();
+    return std::count(data.begin(), data.end(), uint8_t{'\n'});
+  };
+}
+
+TEST_CASE("Directory benchmarks", "[!benchmark]") {
+  // 100 directories of 200 files
+  auto dir = temp_dir();
+  auto _ = defer([&dir]() { std::filesystem::remove_all(dir); });
+  for (int i = 0; i < 100; ++i) {
+    auto sub = dir + "/" + std::to_string(i);
+    REQUIRE(::mkdir(sub.c_str(), 0755) == 0);
+    for (int j = 0; j < 200; ++j) {
+      touch(sub + "/" + std::to_string(j));
+    }
+  }
+
+  BENCHMARK("Walk 20k files (1 thread)") {
+    auto n = std::atomic<long>{0};
+    walk_dir(dir, [&n](std::string const&, dir_entry const&, std::error_code) {
+      ++n;
+      return nil;
+    });
+    return n.load();
+  };
+  BENCHMARK("Walk 20k files (4 threads)") {
+    auto n = std::atomic<long>{0};
+    walk_dir(dir, [&n](std::string const&, dir_entry const&, std::error_code) {
+      ++n;
+      return nil;
+    }, 4);
+    return n.load();
+  };
+  BENCHMARK("Walk 20k files with stat per entry (1 thread)") {
+    auto size = int64_t{0};
+    walk_dir(dir, [&size](std::string const&, dir_entry const& d, std::error_code) {
+      auto [info, err] = d.info();
+      size += info.size;
+      return err;
+    });
+    return size;
+  };
+}
+
+TEST_CASE("Direct writer benchmarks", "[!benchmark]") {
+  constexpr long record_size = 4096;
+  constexpr long records = 256;
+  auto record = std::string(record_size - 1, 'x') + "\n";
+
+  for (long per_sync : {1, 16}) {
+    auto suffix = " (" + std::to_string(per_sync) + " records per sync)";
+    BENCHMARK_ADVANCED("Append 1 MiB with fsync, page cache" + suffix)(Catch::Benchmark::Chronometer meter) {
+      auto name = temp_name();
+      auto [f, err] = create(name);
+      REQUIRE(err == nil);
+      auto _ = defer([&name]() { ::unlink(name.c_str()); });
+      meter.measure([&]() {
+        auto w = bufio::writer{f, direct_writer::default_size};
+        for (long i = 0; i < records; ++i) {
+          w.write_string(record);
+          if ((i + 1) % per_sync == 0) {
+            w.flush();
+            f.sync();
+          }
+        }
+      });
+    };
+    BENCHMARK_ADVANCED("Append 1 MiB with fsync, o_direct" + suffix)(Catch::Benchmark::Chronometer meter) {
+      auto name = temp_name();
+      auto [f, err] = open_file(name, o_rdwr|o_create|o_trunc|o_direct, 0644);
+      REQUIRE(err == nil);
+      auto _ = defer([&name]() { ::unlink(name.c_str()); });
+      meter.measure([&]() {
+        auto w = direct_writer{f};
+        for (long i = 0; i < records; ++i) {
+          w.write_string(record);
+          if ((i + 1) % per_sync == 0) {
+            w.sync();
+          }
+        }
+      });
+    };
+  }
+}
+
+TEST_CASE("Readahead benchmarks", "[!benchmark]") {
+  constexpr int64_t size = 256 << 20;
+  auto name = temp_name();
+  auto [f, err] = create(name);
+  REQUIRE(err == nil);
+  auto _ = defer([&name]() { ::unlink(name.c_str()); });
+  auto chunk = std::vector<uint8_t>(1 << 20, 'x');
+  for (int64_t off = 0; off < size; off += chunk.size()) {
+    f.write(chunk);
+  }
+  REQUIRE(f.sync() == nil);
+
+  // Scans the file from a cold page cache through a bufio::reader,
+  // optionally reading ahead
+  auto scan = [&](Catch::Benchmark::Chronometer meter, long window) {
+    meter.measure([&]() {
+      f.advise(advice::dont_need);
+      f.seek(0, io::seek_start);
+      auto r = bufio::reader{f, 64 << 10};
+      r.set_readahead(window);
+      auto buf = std::vector<uint8_t>(4096);
+      int64_t total = 0;
+      for (;;) {
+        auto [n, err] = r.read(buf);
+        total += n;
+        if (err) {
+          break;
+        }
+      }
+      return total;
+    });
+  };
+  BENCHMARK_ADVANCED("Cold scan 256 MiB")(Catch::Benchmark::Chronometer meter) {
+    scan(meter, 0);
+  };
+  for (long window : {1 << 20, 8 << 20}) {
+    BENCHMARK_ADVANCED("Cold scan 256 MiB (" + std::to_string(window >> 20) + " MiB readahead)")(Catch::Benchmark::Chronometer meter) {
+      scan(meter, window);
+    };
+  }
+}
+
+TEST_CASE("Vectored write benchmarks", "[!benchmark]") {
+  auto [f, err] = open_file("/dev/null", o_wronly, 0);
+  REQUIRE(err == nil);
+  auto header = std::vector<uint8_t>(64, 'h');
+  auto body = std::vector<uint8_t>(4096, 'b');
+  auto joined = std::vector<uint8_t>{};
+
+  BENCHMARK("Header and body with two writes") {
+    f.write(header);
+    return f.write(body);
+  };
+
+  BENCHMARK("Header and body copied into one write") {
+    joined.assign(header.begin(), header.end());
+    joined.insert(joined.end(), body.begin(), body.end());
+    return f.write(joined);
+  };
+
+  BENCHMARK("Header and body with writev") {
+    auto v = std::array<std::span<uint8_t const>, 2>{header, body};
+    return f.writev(v);
+  };
+}
+
+#endif  // defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
 }  // namespace bongo::os
@@ -0,0 +1,94 @@
+// Copyright The Go Authors.
+
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include "bongo/bongo.h"
+#include "bongo/os/stat_unix.h"
+#include "bongo/os/types.h"
+
+namespace bongo::os {
+namespace {
+
+std::string_view basename(std::string_view name) {
+  long i = name.size() - 1;
+  // Remove trailing slashes
+  for (; i > 0 && name[i] == '/'; --i) {
+    name = name.substr(0, i);
+  }
+  // Remove leading directory name
+  for (--i; i >= 0; --i) {
+    if (name[i] == '/') {
+      name = name.substr(i+1);
+      break;
+    }
+  }
+  return name;
+}
+
+std::chrono::system_clock::time_point to_duration(time_t t) {
+  return std::chrono::system_clock::time_point{std::chrono::seconds{t}};
+}
+
+}  // namespace
+
+std::pair<file_info, std::error_code> stat(std::string const& name) {
+  struct ::stat s;
+  if (::stat(name.c_str(), &s) == -1) {
+    return {file_info{}, std::error_code{errno, std::system_category()}};
+  }
+  return {file_info_from_stat(name, s), nil};
+}
+
+std::pair<file_info, std::error_code> lstat(std::string const& name) {
+  struct ::stat s;
+  if (::lstat(name.c_str(), &s) == -1) {
+    return {file_info{}, std::error_code{errno, std::system_category()}};
+  }
+  return {file_info_from_stat(name, s), nil};
+}
+
+file_info file_info_from_stat(std::string_view name, struct ::stat const& s) {
+  file_mode mode = s.st_mode & 0777;
+  switch (s.st_mode & S_IFMT) {
+  case S_IFBLK:
+    mode |= mode_device;
+    break;
+  case S_IFCHR:
+    mode |= mode_device | mode_char_device;
+    break;
+  case S_IFDIR:
+    mode |= mode_dir;
+    break;
+  case S_IFIFO:
+    mode |= mode_named_pipe;
+    break;
+  case S_IFLNK:
+    mode |= mode_symlink;
+    break;
+  case S_IFREG:
+  default:
+    break;
+  case S_IFSOCK:
+    mode |= mode_socket;
+    break;
+  }
+  if ((s.st_mode&S_ISGID) != 0) {
+    mode |= mode_setgid;
+  }
+  if ((s.st_mode&S_ISUID) != 0) {
+    mode |= mode_setuid;
+  }
+  if ((s.st_mode&S_ISVTX) != 0) {
+    mode |= mode_sticky;
+  }
+  return file_info{std::string{basename(name)}, s.st_size, mode, to_duration(s.st_mtime)};
+}
+
+}  // namespace bongo::os
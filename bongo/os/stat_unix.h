@@ -0,0 +1,27 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <sys/stat.h>
+
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <bongo/os/types.h>
+
+namespace bongo::os {
+
+// Returns a file_info describing the named file. If the file is a symbolic
+// link, stat follows it and lstat describes the link itself.
+//
+// - https://golang.org/pkg/os/#Stat
+// - https://golang.org/pkg/os/#Lstat
+std::pair<file_info, std::error_code> stat(std::string const& name);
+std::pair<file_info, std::error_code> lstat(std::string const& name);
+
+// Converts the result of stat(2) on the file at path name.
+file_info file_info_from_stat(std::string_view name, struct ::stat const& s);
+
+}  // namespace bongo::os
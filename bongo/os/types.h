@@ -45,6 +45,18 @@ constexpr static long o_create = O_CREAT;   // Create a new file if no exists.
 constexpr static long o_excl   = O_EXCL;    // Used with o_create, file must not exist.
 constexpr static long o_sync   = O_SYNC;    // Open for synchronous I/O.
 constexpr static long o_trunc  = O_TRUNC;   // Truncate regular writable file when opened.
+constexpr static long o_direct = O_DIRECT;  // Bypass the page cache, I/O must be aligned.
+
+// Access pattern hints for a file or a memory-mapped file, see
+// posix_fadvise(2) and madvise(2).
+enum class advice {
+  normal,      // no special treatment
+  sequential,  // read ahead aggressively, pages may be freed soon after use
+  random,      // do not read ahead
+  will_need,   // start reading the data in now
+  dont_need,   // the pages are not needed soon
+  huge_page,   // back a mapping with transparent huge pages if possible
+};
 
 struct file_info {
   std::string name;
@@ -0,0 +1,16 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace bongo::runtime {
+
+// Monotonic clock reading in nanoseconds.
+inline int64_t nanotime() noexcept {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace bongo::runtime
@@ -0,0 +1,421 @@
+// Copyright The Go Authors.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bongo/runtime/netpoll.h"
+#include "bongo/runtime/netpoll_epoll.h"
+
+namespace bongo::runtime {
+namespace {
+
+// Events and timers carry the descriptor address together with the low bits
+// of its sequence number.
+constexpr static int tag_bits = 16;
+static_assert(sizeof(uintptr_t) == 8, "netpoll tags require 64-bit pointers");
+
+uint64_t make_tag(poll_desc* pd, uintptr_t seq) noexcept {
+  return (reinterpret_cast<uint64_t>(pd) << tag_bits) | (seq & ((1 << tag_bits) - 1));
+}
+
+// A thread parked in netpollblock.
+struct waiter {
+  std::atomic<uint32_t> woke = 0;
+};
+
+void ready(waiter* w) {
+  if (w != nullptr) {
+    w->woke.store(1);
+    w->woke.notify_one();
+  }
+}
+
+struct timer {
+  int64_t when;
+  poll_desc* pd;
+  uintptr_t seq;
+  int mode;
+
+  bool operator>(timer const& other) const noexcept { return when > other.when; }
+};
+
+// The process-wide poller: one epoll instance plus one thread that waits on
+// it and fires deadline timers.
+struct poller {
+  netpoll np;
+
+  std::mutex timers_lock;
+  std::vector<timer> timers;  // min-heap ordered by when
+
+  std::mutex cache_lock;
+  poll_desc* first = nullptr;  // free descriptors
+
+  poller() {
+    std::thread{[this]() { run(); }}.detach();
+  }
+
+  [[noreturn]] void run();
+  void add_timer(timer t);
+  void fire(timer const& t);
+  void ready_event(uint64_t tag, int mode, bool everr);
+
+  poll_desc* alloc();
+  void free(poll_desc* pd);
+};
+
+poller& get_poller() {
+  // Intentionally leaked, the poller thread runs for the life of the process.
+  static auto* p = new poller;
+  return *p;
+}
+
+int check_err(poll_desc* pd, int mode) noexcept {
+  if (pd->closing.load()) {
+    return poll_err_closing;
+  }
+  if ((mode == 'r' && pd->rd.load() < 0) || (mode == 'w' && pd->wd.load() < 0)) {
+    return poll_err_timeout;
+  }
+  // Report an event scanning error only on a read event. An error on a write
+  // event will be captured in a subsequent write call that is able to report
+  // a more specific error.
+  if (mode == 'r' && pd->everr.load()) {
+    return poll_err_not_pollable;
+  }
+  return poll_no_error;
+}
+
+// Returns true if I/O is ready, or false if timed out or closed. If waitio
+// is true wait only for completed I/O and ignore errors. Concurrent calls in
+// the same mode are not allowed.
+bool netpollblock(poll_desc* pd, int mode, bool waitio) {
+  auto& gpp = mode == 'r' ? pd->rg : pd->wg;
+  // Set the state to pd_wait.
+  for (;;) {
+    auto old = pd_ready;
+    // Consume notification if already ready.
+    if (gpp.compare_exchange_strong(old, pd_nil)) {
+      return true;
+    }
+    old = pd_nil;
+    if (gpp.compare_exchange_strong(old, pd_wait)) {
+      break;
+    }
+    if (old != pd_ready && old != pd_nil) {
+      throw std::logic_error{"runtime: double wait"};
+    }
+  }
+  // Need to recheck error states after setting the state to pd_wait. This is
+  // necessary because poll_unblock, poll_set_deadline and deadline timers set
+  // the error state and then unblock, so we either observe the error here or
+  // the unblock resets pd_wait and the waiter is not parked.
+  if (waitio || check_err(pd, mode) == poll_no_error) {
+    auto w = waiter{};
+    auto old = pd_wait;
+    if (gpp.compare_exchange_strong(old, reinterpret_cast<uintptr_t>(&w))) {
+      while (w.woke.load() == 0) {
+        w.woke.wait(0);
+      }
+    }
+  }
+  // Be careful to not lose concurrent pd_ready notification.
+  auto old = gpp.exchange(pd_nil);
+  if (old > pd_wait) {
+    throw std::logic_error{"runtime: corrupted polldesc"};
+  }
+  return old == pd_ready;
+}
+
+// Moves the state to pd_ready if ioready, or to pd_nil otherwise, returning
+// the waiter that should be readied, if any.
+waiter* netpollunblock(poll_desc* pd, int mode, bool ioready) {
+  auto& gpp = mode == 'r' ? pd->rg : pd->wg;
+  auto next = ioready ? pd_ready : pd_nil;
+  for (;;) {
+    auto old = gpp.load();
+    if (old == pd_ready) {
+      return nullptr;
+    }
+    if (old == pd_nil && !ioready) {
+      // Only set pd_ready for ioready. The runtime sets pd_nil when a
+      // deadline expires or the descriptor is closed.
+      return nullptr;
+    }
+    if (gpp.compare_exchange_strong(old, next)) {
+      if (old == pd_nil || old == pd_wait) {
+        return nullptr;
+      }
+      return reinterpret_cast<waiter*>(old);
+    }
+  }
+}
+
+void poller::run() {
+  std::vector<timer> expired;
+  auto ready = std::function{[this](uint64_t tag, int mode, bool everr) {
+    ready_event(tag, mode, everr);
+  }};
+  for (;;) {
+    int64_t delay = -1;
+    {
+      auto lock = std::lock_guard{timers_lock};
+      auto now = nanotime();
+      while (!timers.empty() && timers.front().when <= now) {
+        std::pop_heap(timers.begin(), timers.end(), std::greater<>{});
+        expired.push_back(timers.back());
+        timers.pop_back();
+      }
+      if (!timers.empty()) {
+        delay = timers.front().when - now;
+      }
+    }
+    if (!expired.empty()) {
+      for (auto const& t : expired) {
+        fire(t);
+      }
+      expired.clear();
+      // Firing may have rearmed timers, so recompute the delay.
+      continue;
+    }
+    np.wait(delay, ready);
+  }
+}
+
+void poller::add_timer(timer t) {
+  bool earliest;
+  {
+    auto lock = std::lock_guard{timers_lock};
+    timers.push_back(t);
+    std::push_heap(timers.begin(), timers.end(), std::greater<>{});
+    earliest = timers.front().pd == t.pd && timers.front().when == t.when;
+  }
+  if (earliest) {
+    np.wake();
+  }
+}
+
+void poller::fire(timer const& t) {
+  auto pd = t.pd;
+  waiter* w = nullptr;
+  {
+    auto lock = std::lock_guard{pd->lock};
+    if (pd->fdseq.load() != t.seq) {
+      // The descriptor was reused, ignore stale timers.
+      return;
+    }
+    auto& pending = t.mode == 'r' ? pd->rt : pd->wt;
+    if (pending != t.when) {
+      // Superseded by an earlier timer.
+      return;
+    }
+    pending = 0;
+    auto& deadline = t.mode == 'r' ? pd->rd : pd->wd;
+    auto d = deadline.load();
+    if (d <= 0) {
+      // Deadline was cleared or has already expired.
+      return;
+    }
+    if (d > nanotime()) {
+      // Deadline was extended, rearm for the new time.
+      pending = d;
+      add_timer({d, pd, t.seq, t.mode});
+      return;
+    }
+    deadline.store(-1);
+    w = netpollunblock(pd, t.mode, false);
+  }
+  ready(w);
+}
+
+void poller::ready_event(uint64_t tag, int mode, bool everr) {
+  auto pd = reinterpret_cast<poll_desc*>(tag >> tag_bits);
+  // The descriptor may have been closed and reused since the event was
+  // queued, in which case the event belongs to the previous user.
+  if ((pd->fdseq.load() & ((1 << tag_bits) - 1)) != (tag & ((1 << tag_bits) - 1))) {
+    return;
+  }
+  if (everr) {
+    pd->everr.store(true);
+  }
+  waiter* rw = nullptr;
+  waiter* ww = nullptr;
+  if (mode == 'r' || mode == 'r'+'w') {
+    rw = netpollunblock(pd, 'r', true);
+  }
+  if (mode == 'w' || mode == 'r'+'w') {
+    ww = netpollunblock(pd, 'w', true);
+  }
+  ready(rw);
+  ready(ww);
+}
+
+poll_desc* poller::alloc() {
+  auto lock = std::lock_guard{cache_lock};
+  if (first == nullptr) {
+    // Allocate descriptors in blocks, they are never freed.
+    constexpr static int block = 64;
+    auto pds = new poll_desc[block];
+    for (int i = 0; i < block; ++i) {
+      pds[i].link = first;
+      first = &pds[i];
+    }
+  }
+  auto pd = first;
+  first = pd->link;
+  return pd;
+}
+
+void poller::free(poll_desc* pd) {
+  // Increment the sequence so stale events and timers for the descriptor
+  // are ignored once it is reused.
+  {
+    auto lock = std::lock_guard{pd->lock};
+    pd->fdseq.store(pd->fdseq.load() + 1);
+    pd->rt = 0;
+    pd->wt = 0;
+  }
+  auto lock = std::lock_guard{cache_lock};
+  pd->link = first;
+  first = pd;
+}
+
+}  // namespace
+
+std::pair<poll_desc*, int> poll_open(uintptr_t fd) {
+  auto& p = get_poller();
+  auto pd = p.alloc();
+  uintptr_t seq;
+  {
+    auto lock = std::lock_guard{pd->lock};
+    auto wg = pd->wg.load();
+    if (wg != pd_nil && wg != pd_ready) {
+      throw std::logic_error{"runtime: blocked write on free polldesc"};
+    }
+    auto rg = pd->rg.load();
+    if (rg != pd_nil && rg != pd_ready) {
+      throw std::logic_error{"runtime: blocked read on free polldesc"};
+    }
+    pd->fd = fd;
+    seq = pd->fdseq.load();
+    pd->closing.store(false);
+    pd->everr.store(false);
+    pd->rg.store(pd_nil);
+    pd->rd.store(0);
+    pd->wg.store(pd_nil);
+    pd->wd.store(0);
+  }
+  if (auto errno_ = p.np.open(fd, make_tag(pd, seq)); errno_ != 0) {
+    p.free(pd);
+    return {nullptr, errno_};
+  }
+  return {pd, 0};
+}
+
+void poll_close(poll_desc* pd) {
+  if (!pd->closing.load()) {
+    throw std::logic_error{"runtime: close polldesc w/o unblock"};
+  }
+  auto wg = pd->wg.load();
+  if (wg != pd_nil && wg != pd_ready) {
+    throw std::logic_error{"runtime: blocked write on closing polldesc"};
+  }
+  auto rg = pd->rg.load();
+  if (rg != pd_nil && rg != pd_ready) {
+    throw std::logic_error{"runtime: blocked read on closing polldesc"};
+  }
+  auto& p = get_poller();
+  p.np.close(pd->fd);
+  p.free(pd);
+}
+
+int poll_reset(poll_desc* pd, int mode) {
+  if (auto err = check_err(pd, mode); err != poll_no_error) {
+    return err;
+  }
+  if (mode == 'r') {
+    pd->rg.store(pd_nil);
+  } else if (mode == 'w') {
+    pd->wg.store(pd_nil);
+  }
+  return poll_no_error;
+}
+
+int poll_wait(poll_desc* pd, int mode) {
+  if (auto err = check_err(pd, mode); err != poll_no_error) {
+    return err;
+  }
+  while (!netpollblock(pd, mode, false)) {
+    if (auto err = check_err(pd, mode); err != poll_no_error) {
+      return err;
+    }
+    // Can happen if timeout has fired and unblocked us, but before we had a
+    // chance to run, timeout has been reset. Pretend it has not happened and
+    // retry.
+  }
+  return poll_no_error;
+}
+
+void poll_set_deadline(poll_desc* pd, int64_t d, int mode) {
+  auto& p = get_poller();
+  waiter* rw = nullptr;
+  waiter* ww = nullptr;
+  {
+    auto lock = std::lock_guard{pd->lock};
+    if (pd->closing.load()) {
+      return;
+    }
+    if (d > 0 && d <= nanotime()) {
+      d = -1;
+    }
+    auto seq = pd->fdseq.load();
+    if (mode == 'r' || mode == 'r'+'w') {
+      pd->rd.store(d);
+      // A pending timer that fires before the new deadline rearms itself,
+      // so only an earlier deadline needs a new timer.
+      if (d > 0 && (pd->rt == 0 || d < pd->rt)) {
+        pd->rt = d;
+        p.add_timer({d, pd, seq, 'r'});
+      }
+      if (d < 0) {
+        rw = netpollunblock(pd, 'r', false);
+      }
+    }
+    if (mode == 'w' || mode == 'r'+'w') {
+      pd->wd.store(d);
+      if (d > 0 && (pd->wt == 0 || d < pd->wt)) {
+        pd->wt = d;
+        p.add_timer({d, pd, seq, 'w'});
+      }
+      if (d < 0) {
+        ww = netpollunblock(pd, 'w', false);
+      }
+    }
+  }
+  ready(rw);
+  ready(ww);
+}
+
+void poll_unblock(poll_desc* pd) {
+  waiter* rw = nullptr;
+  waiter* ww = nullptr;
+  {
+    auto lock = std::lock_guard{pd->lock};
+    if (pd->closing.load()) {
+      throw std::logic_error{"runtime: unblock on closing polldesc"};
+    }
+    pd->closing.store(true);
+    rw = netpollunblock(pd, 'r', false);
+    ww = netpollunblock(pd, 'w', false);
+  }
+  ready(rw);
+  ready(ww);
+}
+
+}  // namespace bongo::runtime
@@ -0,0 +1,63 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+#include <bongo/runtime/nanotime.h>
+
+namespace bongo::runtime {
+
+// Error codes returned by the poll functions.
+constexpr static int poll_no_error = 0;          // no error
+constexpr static int poll_err_closing = 1;       // descriptor is closed
+constexpr static int poll_err_timeout = 2;       // I/O timeout
+constexpr static int poll_err_not_pollable = 3;  // general error polling descriptor
+
+// States of poll_desc::rg and poll_desc::wg. Any other value is a pointer to
+// the waiter parked on the descriptor.
+constexpr static uintptr_t pd_nil = 0;    // no notification pending
+constexpr static uintptr_t pd_ready = 1;  // I/O readiness notification is pending
+constexpr static uintptr_t pd_wait = 2;   // a thread is about to park
+
+/**
+ * Runtime state for a single pollable file descriptor.
+ *
+ * Descriptors are allocated from a cache and never freed, so the poller can
+ * safely dereference a descriptor named by a stale event or deadline. The
+ * fdseq counter is bumped each time a descriptor is reused so those stale
+ * notifications can be recognized and dropped.
+ *
+ * Deadlines are absolute values of nanotime(). A deadline of zero means no
+ * deadline is set and a negative deadline has already expired.
+ *
+ * - https://github.com/golang/go/blob/master/src/runtime/netpoll.go
+ */
+struct poll_desc {
+  poll_desc* link = nullptr;  // in poll cache, protected by the cache lock
+
+  std::mutex lock;  // protects the following fields
+  uintptr_t fd = 0;
+  int64_t rt = 0;  // pending read deadline timer, or 0
+  int64_t wt = 0;  // pending write deadline timer, or 0
+
+  std::atomic<uintptr_t> fdseq = 0;  // protects from stale events and timers
+  std::atomic_bool closing = false;
+  std::atomic_bool everr = false;    // marks event scanning error happened
+  std::atomic<uintptr_t> rg = pd_nil;  // pd_ready, pd_wait, waiter or pd_nil
+  std::atomic<uintptr_t> wg = pd_nil;  // pd_ready, pd_wait, waiter or pd_nil
+  std::atomic<int64_t> rd = 0;  // read deadline
+  std::atomic<int64_t> wd = 0;  // write deadline
+};
+
+std::pair<poll_desc*, int> poll_open(uintptr_t fd);
+void poll_close(poll_desc* pd);
+int poll_reset(poll_desc* pd, int mode);
+int poll_wait(poll_desc* pd, int mode);
+void poll_set_deadline(poll_desc* pd, int64_t d, int mode);
+void poll_unblock(poll_desc* pd);
+
+}  // namespace bongo::runtime
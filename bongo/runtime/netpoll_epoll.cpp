@@ -0,0 +1,118 @@
+// Copyright The Go Authors.
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "bongo/runtime/netpoll_epoll.h"
+
+namespace bongo::runtime {
+
+netpoll::netpoll() {
+  epfd_ = ::epoll_create1(EPOLL_CLOEXEC);
+  if (epfd_ == -1) {
+    throw std::runtime_error{"runtime: epoll_create failed with " + std::to_string(errno)};
+  }
+  break_fd_ = ::eventfd(0, EFD_CLOEXEC|EFD_NONBLOCK);
+  if (break_fd_ == -1) {
+    throw std::runtime_error{"runtime: eventfd failed with " + std::to_string(errno)};
+  }
+  auto ev = epoll_event{};
+  ev.events = EPOLLIN;
+  ev.data.u64 = 0;
+  if (::epoll_ctl(epfd_, EPOLL_CTL_ADD, break_fd_, &ev) == -1) {
+    throw std::runtime_error{"runtime: epoll_ctl failed with " + std::to_string(errno)};
+  }
+}
+
+netpoll::~netpoll() {
+  ::close(break_fd_);
+  ::close(epfd_);
+}
+
+int netpoll::open(uintptr_t fd, uint64_t tag) {
+  auto ev = epoll_event{};
+  ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+  ev.data.u64 = tag;
+  if (::epoll_ctl(epfd_, EPOLL_CTL_ADD, static_cast<int>(fd), &ev) == -1) {
+    return errno;
+  }
+  return 0;
+}
+
+int netpoll::close(uintptr_t fd) {
+  auto ev = epoll_event{};
+  if (::epoll_ctl(epfd_, EPOLL_CTL_DEL, static_cast<int>(fd), &ev) == -1) {
+    return errno;
+  }
+  return 0;
+}
+
+void netpoll::wake() {
+  uint64_t one = 1;
+  for (;;) {
+    auto n = ::write(break_fd_, &one, sizeof one);
+    if (n == sizeof one || errno == EAGAIN) {
+      // EAGAIN means the counter is saturated, a wakeup is pending anyway.
+      return;
+    }
+    if (errno != EINTR) {
+      throw std::runtime_error{"runtime: netpoll wake failed with " + std::to_string(errno)};
+    }
+  }
+}
+
+void netpoll::wait(int64_t delay, ready_func const& ready) {
+  int waitms;
+  if (delay < 0) {
+    waitms = -1;
+  } else if (delay == 0) {
+    waitms = 0;
+  } else if (delay < 1000000) {
+    waitms = 1;
+  } else if (delay < 1000000000000) {
+    // Round up so we do not wake before the deadline.
+    waitms = static_cast<int>((delay + 999999) / 1000000);
+  } else {
+    // An arbitrary cap on how long to wait for a timer.
+    // 1e9 ms == ~11.5 days.
+    waitms = 1000000000;
+  }
+  epoll_event events[128];
+  auto n = ::epoll_wait(epfd_, events, 128, waitms);
+  if (n < 0) {
+    if (errno != EINTR) {
+      throw std::runtime_error{"runtime: epoll_wait failed with " + std::to_string(errno)};
+    }
+    return;
+  }
+  for (int i = 0; i < n; ++i) {
+    auto& ev = events[i];
+    if (ev.events == 0) {
+      continue;
+    }
+    if (ev.data.u64 == 0) {
+      // The break event. Drain it.
+      uint64_t v;
+      [[maybe_unused]] auto r = ::read(break_fd_, &v, sizeof v);
+      continue;
+    }
+    int mode = 0;
+    if ((ev.events & (EPOLLIN|EPOLLRDHUP|EPOLLHUP|EPOLLERR)) != 0) {
+      mode += 'r';
+    }
+    if ((ev.events & (EPOLLOUT|EPOLLHUP|EPOLLERR)) != 0) {
+      mode += 'w';
+    }
+    if (mode != 0) {
+      ready(ev.data.u64, mode, ev.events == EPOLLERR);
+    }
+  }
+}
+
+}  // namespace bongo::runtime
@@ -4,30 +4,46 @@
 
 #include <sys/epoll.h>
 
+#include <cstdint>
+#include <functional>
+
 namespace bongo::runtime {
 
+/**
+ * The epoll instance behind the network poller.
+ *
+ * Descriptors are registered edge-triggered for both reading and writing
+ * with an opaque tag that is passed back with each event.
+ *
+ * - https://github.com/golang/go/blob/master/src/runtime/netpoll_epoll.go
+ */
 class netpoll {
   int epfd_ = -1;
+  int break_fd_ = -1;
 
  public:
-  netpoll() {
-    epfd_ = epoll_create1(EPOLL_CLOEXEC);
-    if (epfd_ == -1) {
-      epfd_ = epoll_create(1024);
-      if (epfd_ == -1) {
-        throw std::runtime_error{"runtime: epoll_create failed with " + std::to_string(-epfd_)};
-      }
-    }
-  }
-
-  ~netpoll() {
-    ::close(epfd_);
-  }
-
-  long close(uintptr_t fd) {
-    auto ev = epoll_event{};
-    return -epoll_ctl(epfd_, EPOLL_CTL_DEL, static_cast<int>(fd), &ev);
-  }
+  // Called for each ready descriptor with its tag, a mode of 'r', 'w' or
+  // 'r'+'w' and whether the event reported an error.
+  using ready_func = std::function<void(uint64_t tag, int mode, bool everr)>;
+
+  netpoll();
+  ~netpoll();
+  netpoll(netpoll const& other) = delete;
+  netpoll& operator=(netpoll const& other) = delete;
+
+  // Registers fd. Returns zero or an errno value.
+  int open(uintptr_t fd, uint64_t tag);
+
+  // Unregisters fd. Returns zero or an errno value.
+  int close(uintptr_t fd);
+
+  // Interrupts a concurrent call to wait.
+  void wake();
+
+  // Checks for ready descriptors. If delay < 0 it blocks indefinitely, if
+  // delay == 0 it does not block, otherwise it blocks for up to delay
+  // nanoseconds.
+  void wait(int64_t delay, ready_func const& ready);
 };
 
 }  // namespace bongo::runtime
@@ -0,0 +1,281 @@
+// Copyright The Go Authors.
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "bongo/runtime/sema.h"
+
+namespace bongo::runtime {
+
+// A thread blocked in semacquire or notify_list_wait.
+struct sudog {
+  std::atomic<uint32_t> ready = 0;
+  bool ticket = false;     // semaphore handed off to this waiter
+  uint32_t notify_ticket;  // notify_list ticket
+  sudog* next = nullptr;
+};
+
+namespace {
+
+constexpr static int active_spin = 4;
+constexpr static int active_spin_cnt = 30;
+constexpr static uintptr_t sem_tab_size = 251;
+
+struct wait_queue {
+  sudog* head = nullptr;
+  sudog* tail = nullptr;
+};
+
+struct alignas(64) sema_root {
+  std::mutex lock;
+  std::atomic<uint32_t> nwait = 0;
+  std::unordered_map<void const*, wait_queue> queues;
+
+  void queue(void const* addr, sudog* s, bool lifo) {
+    auto& q = queues[addr];
+    if (q.head == nullptr) {
+      q.head = q.tail = s;
+    } else if (lifo) {
+      s->next = q.head;
+      q.head = s;
+    } else {
+      q.tail->next = s;
+      q.tail = s;
+    }
+  }
+
+  sudog* dequeue(void const* addr) {
+    auto it = queues.find(addr);
+    if (it == queues.end()) {
+      return nullptr;
+    }
+    auto s = it->second.head;
+    it->second.head = s->next;
+    if (it->second.head == nullptr) {
+      queues.erase(it);
+    }
+    s->next = nullptr;
+    return s;
+  }
+};
+
+sema_root sem_table[sem_tab_size];
+
+sema_root& root_for(void const* addr) {
+  return sem_table[(reinterpret_cast<uintptr_t>(addr) >> 3) % sem_tab_size];
+}
+
+bool can_semacquire(std::atomic<uint32_t>* addr) {
+  auto v = addr->load();
+  for (;;) {
+    if (v == 0) {
+      return false;
+    }
+    if (addr->compare_exchange_weak(v, v-1)) {
+      return true;
+    }
+  }
+}
+
+void park(sudog& s) {
+  while (s.ready.load() == 0) {
+    s.ready.wait(0);
+  }
+}
+
+void ready(sudog* s) {
+  s->ready.store(1);
+  s->ready.notify_one();
+}
+
+// Reports whether a < b, considering a and b running counts that may
+// overflow the 32-bit range, and that their "unwrapped" difference is
+// always less than 2^31.
+bool less(uint32_t a, uint32_t b) noexcept {
+  return static_cast<int32_t>(a-b) < 0;
+}
+
+}  // namespace
+
+void semacquire(std::atomic<uint32_t>* addr, bool lifo) {
+  // Easy case.
+  if (can_semacquire(addr)) {
+    return;
+  }
+
+  // Harder case:
+  //   increment waiter count
+  //   try can_semacquire one more time, return if succeeded
+  //   enqueue itself as a waiter
+  //   sleep
+  //   (waiter descriptor is dequeued by signaler)
+  auto& root = root_for(addr);
+  for (;;) {
+    sudog s;
+    std::unique_lock lock{root.lock};
+    // Add ourselves to nwait to disable "easy case" in semrelease.
+    root.nwait.fetch_add(1);
+    // Check can_semacquire to avoid missed wakeup.
+    if (can_semacquire(addr)) {
+      root.nwait.fetch_sub(1);
+      return;
+    }
+    // Any semrelease after the can_semacquire knows we're waiting (we set
+    // nwait above), so go to sleep.
+    root.queue(addr, &s, lifo);
+    lock.unlock();
+    park(s);
+    if (s.ticket || can_semacquire(addr)) {
+      return;
+    }
+  }
+}
+
+void semrelease(std::atomic<uint32_t>* addr, bool handoff) {
+  auto& root = root_for(addr);
+  addr->fetch_add(1);
+
+  // Easy case: no waiters? This check must happen after the fetch_add, to
+  // avoid a missed wakeup (see loop in semacquire).
+  if (root.nwait.load() == 0) {
+    return;
+  }
+
+  // Harder case: search for a waiter and wake it.
+  std::unique_lock lock{root.lock};
+  if (root.nwait.load() == 0) {
+    // The count is already consumed by another thread, so no need to wake
+    // up another thread.
+    return;
+  }
+  auto s = root.dequeue(addr);
+  if (s != nullptr) {
+    root.nwait.fetch_sub(1);
+  }
+  lock.unlock();
+  if (s != nullptr) {
+    if (handoff && can_semacquire(addr)) {
+      s->ticket = true;
+    }
+    ready(s);
+    if (handoff) {
+      // Direct handoff: give the woken waiter a chance to run before we
+      // compete with it for the semaphore again.
+      std::this_thread::yield();
+    }
+  }
+}
+
+uint32_t notify_list_add(notify_list* l) noexcept {
+  // This may be called concurrently, for example, when called from
+  // cond::wait while holding a rw_mutex in read mode.
+  return l->wait.fetch_add(1);
+}
+
+void notify_list_wait(notify_list* l, uint32_t t) {
+  std::unique_lock lock{l->lock};
+  // Return right away if this ticket has already been notified.
+  if (less(t, l->notify.load())) {
+    return;
+  }
+  // Enqueue itself.
+  sudog s;
+  s.notify_ticket = t;
+  if (l->tail == nullptr) {
+    l->head = &s;
+  } else {
+    l->tail->next = &s;
+  }
+  l->tail = &s;
+  lock.unlock();
+  park(s);
+}
+
+void notify_list_notify_all(notify_list* l) {
+  // Fast-path: if there are no new waiters since the last notification we
+  // don't need to acquire the lock.
+  if (l->wait.load() == l->notify.load()) {
+    return;
+  }
+  // Pull the list out into a local variable, waiters will be readied
+  // outside the lock.
+  std::unique_lock lock{l->lock};
+  auto s = l->head;
+  l->head = nullptr;
+  l->tail = nullptr;
+  // Update the next ticket to be notified. We can set it to the current
+  // value of wait because any previous waiters are already in the list or
+  // will notice that they have already been notified when trying to add
+  // themselves to the list.
+  l->notify.store(l->wait.load());
+  lock.unlock();
+  // Go through the local list and ready all waiters.
+  while (s != nullptr) {
+    auto next = s->next;
+    s->next = nullptr;
+    ready(s);
+    s = next;
+  }
+}
+
+void notify_list_notify_one(notify_list* l) {
+  // Fast-path: if there are no new waiters since the last notification we
+  // don't need to acquire the lock at all.
+  if (l->wait.load() == l->notify.load()) {
+    return;
+  }
+  std::unique_lock lock{l->lock};
+  // Re-check under the lock if we need to do anything.
+  auto t = l->notify.load();
+  if (t == l->wait.load()) {
+    return;
+  }
+  // Update the next notify ticket number.
+  l->notify.store(t+1);
+  // Try to find the thread that needs to be notified. If it hasn't made it
+  // to the list yet we won't find it, but it won't park itself once it
+  // sees the new notify number.
+  for (sudog *p = nullptr, *s = l->head; s != nullptr; p = s, s = s->next) {
+    if (s->notify_ticket == t) {
+      auto n = s->next;
+      if (p != nullptr) {
+        p->next = n;
+      } else {
+        l->head = n;
+      }
+      if (n == nullptr) {
+        l->tail = p;
+      }
+      lock.unlock();
+      s->next = nullptr;
+      ready(s);
+      return;
+    }
+  }
+}
+
+bool can_spin(int iter) noexcept {
+  static auto const ncpu = std::thread::hardware_concurrency();
+  return iter < active_spin && ncpu > 1;
+}
+
+void do_spin() noexcept {
+  procyield(active_spin_cnt);
+}
+
+void procyield(int cycles) noexcept {
+  for (int i = 0; i < cycles; ++i) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+  }
+}
+
+}  // namespace bongo::runtime
@@ -0,0 +1,71 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace bongo::runtime {
+
+/**
+ * Semaphore implementation used by the sync package.
+ *
+ * A semaphore is a counter at addr. semacquire waits until *addr > 0 and
+ * then decrements it. semrelease increments *addr and wakes a waiter.
+ * Waiters are kept in a global table keyed by address, so a semaphore is
+ * just a uint32_t and costs nothing until it is contended.
+ *
+ * If lifo is true the waiter is queued at the head of the wait queue. If
+ * handoff is true semrelease passes the count directly to the first
+ * waiter, bypassing any threads that are trying to acquire it.
+ *
+ * - https://github.com/golang/go/blob/master/src/runtime/sema.go
+ */
+void semacquire(std::atomic<uint32_t>* addr, bool lifo = false);
+void semrelease(std::atomic<uint32_t>* addr, bool handoff = false);
+
+struct sudog;
+
+/**
+ * A ticket-based notification list used to implement sync::cond.
+ *
+ * wait is the ticket number of the next waiter. It is atomically
+ * incremented outside the lock. notify is the ticket number of the next
+ * waiter to be notified. Waiters are kept in a list protected by lock.
+ */
+struct notify_list {
+  std::atomic<uint32_t> wait = 0;
+  std::atomic<uint32_t> notify = 0;
+  std::mutex lock;
+  sudog* head = nullptr;
+  sudog* tail = nullptr;
+};
+
+// Adds the caller to a notify list such that it can receive
+// notifications. The caller must eventually call notify_list_wait to wait
+// for such a notification, passing the returned ticket number.
+uint32_t notify_list_add(notify_list* l) noexcept;
+
+// Waits for a notification. If one has been sent since notify_list_add
+// was called, it returns immediately. Otherwise, it blocks.
+void notify_list_wait(notify_list* l, uint32_t t);
+
+// Notifies all entries in the list.
+void notify_list_notify_all(notify_list* l);
+
+// Notifies one entry in the list.
+void notify_list_notify_one(notify_list* l);
+
+// Reports whether spinning makes sense at the given iteration of a spin
+// loop. Spinning is only useful on a multicore machine and only for a few
+// iterations.
+bool can_spin(int iter) noexcept;
+
+// Spins for a short while, executing a pause instruction.
+void do_spin() noexcept;
+
+// Executes cycles pause instructions.
+void procyield(int cycles) noexcept;
+
+}  // namespace bongo::runtime
@@ -0,0 +1,374 @@
+// Copyright The Go Authors.
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <mutex>
+#include <semaphore>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bongo/bongo.h"
+#include "bongo/runtime/uring.h"
+
+namespace bongo::runtime {
+namespace {
+
+#if defined(BONGO_WITH_IO_URING)
+constexpr static bool uring_default = true;
+#else
+constexpr static bool uring_default = false;
+#endif
+
+// Number of submission queue entries, which also bounds the number of
+// operations in flight so the completion queue can never overflow.
+constexpr static unsigned ring_entries = 256;
+
+// Maximum size of a single read or write.
+constexpr static size_t max_rw = 1 << 30;
+
+int io_uring_setup(unsigned entries, struct ::io_uring_params* p) noexcept {
+  return static_cast<int>(::syscall(__NR_io_uring_setup, entries, p));
+}
+
+int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) noexcept {
+  return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int io_uring_register(int fd, unsigned opcode, void const* arg, unsigned nr_args) noexcept {
+  return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+template <typename T>
+T* at(void* base, uint32_t off) noexcept {
+  return reinterpret_cast<T*>(static_cast<char*>(base) + off);
+}
+
+// Result of an operation, filled in by whichever thread reaps it.
+struct completion {
+  int32_t res = 0;
+  bool parked = false;  // owner is waiting on done, protected by cq_lock_
+  std::atomic<uint32_t> done = 0;
+};
+
+class ring {
+  int fd_;
+
+  unsigned* sq_tail_;
+  unsigned sq_mask_;
+  unsigned* sq_array_;
+  struct ::io_uring_sqe* sqes_;
+
+  unsigned* cq_head_;
+  unsigned* cq_tail_;
+  unsigned cq_mask_;
+  struct ::io_uring_cqe* cqes_;
+
+  std::counting_semaphore<ring_entries> inflight_{ring_entries};
+
+  std::mutex cq_lock_;  // protects the completion queue
+  std::atomic<uint32_t> waiting_ = 0;  // parked submitters
+
+  std::mutex sq_lock_;  // protects the submission queue and the following
+  unsigned pending_ = 0;  // entries queued but not yet submitted
+  bool submitting_ = false;
+
+  // Buffers registered with the kernel, see uring_register_buffers.
+  std::vector<std::span<uint8_t>> fixed_;
+
+  ring(int fd, struct ::io_uring_params const& p, void* sq, void* cq, void* sqes)
+      : fd_{fd}
+      , sq_tail_{at<unsigned>(sq, p.sq_off.tail)}
+      , sq_mask_{*at<unsigned>(sq, p.sq_off.ring_mask)}
+      , sq_array_{at<unsigned>(sq, p.sq_off.array)}
+      , sqes_{static_cast<struct ::io_uring_sqe*>(sqes)}
+      , cq_head_{at<unsigned>(cq, p.cq_off.head)}
+      , cq_tail_{at<unsigned>(cq, p.cq_off.tail)}
+      , cq_mask_{*at<unsigned>(cq, p.cq_off.ring_mask)}
+      , cqes_{at<struct ::io_uring_cqe>(cq, p.cq_off.cqes)} {}
+
+ public:
+  // Returns nullptr if io_uring is not available.
+  static ring* create();
+
+  template <typename Fn>
+  std::pair<long, std::error_code> submit(Fn prep);
+
+  // Returns the index of the registered buffer containing p, or -1.
+  int fixed_index(void const* p, size_t n) const noexcept;
+  std::error_code register_buffers(std::span<std::span<uint8_t> const> bufs);
+  std::error_code unregister_buffers();
+
+ private:
+  void reap_locked();
+  [[noreturn]] void reap();
+};
+
+ring* ring::create() {
+  auto p = ::io_uring_params{};
+  auto fd = io_uring_setup(ring_entries, &p);
+  if (fd == -1) {
+    return nullptr;
+  }
+  // IORING_OP_READ and IORING_OP_WRITE arrived with this feature (5.6).
+  if ((p.features & IORING_FEAT_RW_CUR_POS) == 0 || p.sq_entries < ring_entries) {
+    ::close(fd);
+    return nullptr;
+  }
+  auto sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+  auto cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct ::io_uring_cqe);
+  auto single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single) {
+    sq_size = cq_size = std::max(sq_size, cq_size);
+  }
+  auto sq = ::mmap(nullptr, sq_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  if (sq == MAP_FAILED) {
+    ::close(fd);
+    return nullptr;
+  }
+  auto cq = sq;
+  if (!single) {
+    cq = ::mmap(nullptr, cq_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    if (cq == MAP_FAILED) {
+      ::munmap(sq, sq_size);
+      ::close(fd);
+      return nullptr;
+    }
+  }
+  auto sqes_size = p.sq_entries * sizeof(struct ::io_uring_sqe);
+  auto sqes = ::mmap(nullptr, sqes_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, fd, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    if (!single) {
+      ::munmap(cq, cq_size);
+    }
+    ::munmap(sq, sq_size);
+    ::close(fd);
+    return nullptr;
+  }
+  auto r = new ring{fd, p, sq, cq, sqes};
+  std::thread{[r]() { r->reap(); }}.detach();
+  return r;
+}
+
+template <typename Fn>
+std::pair<long, std::error_code> ring::submit(Fn prep) {
+  inflight_.acquire();
+  auto c = completion{};
+  {
+    auto lock = std::unique_lock{sq_lock_};
+    auto tail = std::atomic_ref{*sq_tail_}.load(std::memory_order_relaxed);
+    auto idx = tail & sq_mask_;
+    auto& sqe = sqes_[idx];
+    sqe = {};
+    prep(sqe);
+    sqe.user_data = reinterpret_cast<uint64_t>(&c);
+    sq_array_[idx] = idx;
+    std::atomic_ref{*sq_tail_}.store(tail + 1, std::memory_order_release);
+    ++pending_;
+    // Whoever finds no submission in progress submits every queued entry,
+    // including those queued by other threads while it is in the kernel.
+    if (!submitting_) {
+      submitting_ = true;
+      while (pending_ > 0) {
+        auto n = pending_;
+        lock.unlock();
+        auto r = io_uring_enter(fd_, n, 0, 0);
+        auto e = errno;
+        lock.lock();
+        if (r == -1) {
+          if (e == EINTR || e == EAGAIN || e == EBUSY) {
+            std::this_thread::yield();
+            continue;
+          }
+          submitting_ = false;
+          throw std::runtime_error{"runtime: io_uring_enter failed with " + std::to_string(e)};
+        }
+        pending_ -= static_cast<unsigned>(r);
+      }
+      submitting_ = false;
+    }
+  }
+  // Reads served from the page cache usually complete during submission,
+  // so check before parking and waking the completion thread.
+  {
+    auto lock = std::lock_guard{cq_lock_};
+    reap_locked();
+    if (c.done.load() == 0) {
+      c.parked = true;
+      waiting_.fetch_add(1);
+    }
+  }
+  if (c.parked) {
+    waiting_.notify_one();
+    while (c.done.load() == 0) {
+      c.done.wait(0);
+    }
+  }
+  inflight_.release();
+  if (c.res < 0) {
+    return {-1, std::error_code{-c.res, std::system_category()}};
+  }
+  return {c.res, nil};
+}
+
+void ring::reap_locked() {
+  auto head = std::atomic_ref{*cq_head_}.load(std::memory_order_relaxed);
+  auto tail = std::atomic_ref{*cq_tail_}.load(std::memory_order_acquire);
+  for (; head != tail; ++head) {
+    auto& cqe = cqes_[head & cq_mask_];
+    auto c = reinterpret_cast<completion*>(cqe.user_data);
+    c->res = cqe.res;
+    if (c->parked) {
+      waiting_.fetch_sub(1);
+      c->done.store(1);
+      c->done.notify_one();
+    } else {
+      c->done.store(1);
+    }
+  }
+  std::atomic_ref{*cq_head_}.store(head, std::memory_order_release);
+}
+
+void ring::reap() {
+  for (;;) {
+    // Only wait in the kernel while a parked submitter has an operation
+    // outstanding, otherwise every completion would wake this thread.
+    for (auto n = waiting_.load(); n == 0; n = waiting_.load()) {
+      waiting_.wait(0);
+    }
+    if (io_uring_enter(fd_, 0, 1, IORING_ENTER_GETEVENTS) == -1) {
+      if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+        throw std::runtime_error{"runtime: io_uring_enter failed with " + std::to_string(errno)};
+      }
+    }
+    auto lock = std::lock_guard{cq_lock_};
+    reap_locked();
+  }
+}
+
+int ring::fixed_index(void const* p, size_t n) const noexcept {
+  auto b = static_cast<uint8_t const*>(p);
+  for (size_t i = 0; i < fixed_.size(); ++i) {
+    if (b >= fixed_[i].data() && b + n <= fixed_[i].data() + fixed_[i].size()) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+std::error_code ring::register_buffers(std::span<std::span<uint8_t> const> bufs) {
+  if (auto err = unregister_buffers(); err) {
+    return err;
+  }
+  auto iovecs = std::vector<struct ::iovec>{};
+  for (auto b : bufs) {
+    iovecs.push_back({b.data(), b.size()});
+  }
+  if (io_uring_register(fd_, IORING_REGISTER_BUFFERS, iovecs.data(), static_cast<unsigned>(iovecs.size())) == -1) {
+    return std::error_code{errno, std::system_category()};
+  }
+  fixed_.assign(bufs.begin(), bufs.end());
+  return nil;
+}
+
+std::error_code ring::unregister_buffers() {
+  if (fixed_.empty()) {
+    return nil;
+  }
+  if (io_uring_register(fd_, IORING_UNREGISTER_BUFFERS, nullptr, 0) == -1) {
+    return std::error_code{errno, std::system_category()};
+  }
+  fixed_.clear();
+  return nil;
+}
+
+ring* get_ring() {
+  // Intentionally leaked, the completion thread runs for the life of the
+  // process.
+  static auto* r = ring::create();
+  return r;
+}
+
+std::atomic_bool enabled = uring_default;
+
+}  // namespace
+
+bool uring_enabled() noexcept {
+  return enabled.load(std::memory_order_relaxed) && get_ring() != nullptr;
+}
+
+void set_uring_enabled(bool enabled_) noexcept {
+  enabled.store(enabled_);
+}
+
+std::pair<long, std::error_code> uring_pread(int fd, std::span<uint8_t> p, int64_t off) {
+  auto r = get_ring();
+  if (r == nullptr) {
+    return {-1, std::make_error_code(std::errc::function_not_supported)};
+  }
+  if (p.size() > max_rw) {
+    p = p.subspan(0, max_rw);
+  }
+  return r->submit([&](struct ::io_uring_sqe& sqe) {
+    auto idx = r->fixed_index(p.data(), p.size());
+    sqe.opcode = idx == -1 ? IORING_OP_READ : IORING_OP_READ_FIXED;
+    sqe.fd = fd;
+    sqe.off = static_cast<uint64_t>(off);
+    sqe.addr = reinterpret_cast<uint64_t>(p.data());
+    sqe.len = static_cast<uint32_t>(p.size());
+    if (idx != -1) {
+      sqe.buf_index = static_cast<uint16_t>(idx);
+    }
+  });
+}
+
+std::pair<long, std::error_code> uring_pwrite(int fd, std::span<uint8_t const> p, int64_t off) {
+  auto r = get_ring();
+  if (r == nullptr) {
+    return {-1, std::make_error_code(std::errc::function_not_supported)};
+  }
+  if (p.size() > max_rw) {
+    p = p.subspan(0, max_rw);
+  }
+  return r->submit([&](struct ::io_uring_sqe& sqe) {
+    auto idx = r->fixed_index(p.data(), p.size());
+    sqe.opcode = idx == -1 ? IORING_OP_WRITE : IORING_OP_WRITE_FIXED;
+    sqe.fd = fd;
+    sqe.off = static_cast<uint64_t>(off);
+    sqe.addr = reinterpret_cast<uint64_t>(p.data());
+    sqe.len = static_cast<uint32_t>(p.size());
+    if (idx != -1) {
+      sqe.buf_index = static_cast<uint16_t>(idx);
+    }
+  });
+}
+
+std::error_code uring_register_buffers(std::span<std::span<uint8_t> const> bufs) {
+  auto r = get_ring();
+  if (r == nullptr) {
+    return std::make_error_code(std::errc::function_not_supported);
+  }
+  return r->register_buffers(bufs);
+}
+
+std::error_code uring_unregister_buffers() {
+  auto r = get_ring();
+  if (r == nullptr) {
+    return std::make_error_code(std::errc::function_not_supported);
+  }
+  return r->unregister_buffers();
+}
+
+}  // namespace bongo::runtime
@@ -0,0 +1,43 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <system_error>
+#include <utility>
+
+namespace bongo::runtime {
+
+/**
+ * Positional file I/O through a shared io_uring instance.
+ *
+ * Operations submitted concurrently by different threads are batched into a
+ * single io_uring_enter call, and a completion thread wakes each submitter
+ * when its operation finishes. The calling thread still blocks for the
+ * result, so this does not change the blocking behavior of poll::fd.
+ *
+ * The ring is created on first use. If the kernel does not support io_uring
+ * or it is blocked (by seccomp, for example) uring_enabled returns false and
+ * callers fall back to plain system calls.
+ */
+
+// Reports whether I/O should be routed through io_uring. This is true if
+// the ring could be created and it has not been disabled with
+// set_uring_enabled. The default is set at build time by WITH_IO_URING.
+bool uring_enabled() noexcept;
+void set_uring_enabled(bool enabled) noexcept;
+
+// Like pread(2) and pwrite(2). An offset of -1 uses the current file
+// position.
+std::pair<long, std::error_code> uring_pread(int fd, std::span<uint8_t> p, int64_t off);
+std::pair<long, std::error_code> uring_pwrite(int fd, std::span<uint8_t const> p, int64_t off);
+
+// Registers buffers with the kernel so reads and writes into them skip the
+// per-operation page pinning. I/O on any part of a registered buffer uses
+// the fixed buffer variant automatically. Replaces any previously
+// registered buffers, and must not be called concurrently with I/O.
+std::error_code uring_register_buffers(std::span<std::span<uint8_t> const> bufs);
+std::error_code uring_unregister_buffers();
+
+}  // namespace bongo::runtime
@@ -2,4 +2,10 @@
 
 #pragma once
 
+#include <bongo/sync/cond.h>
+#include <bongo/sync/map.h>
+#include <bongo/sync/mutex.h>
+#include <bongo/sync/once.h>
+#include <bongo/sync/pool.h>
+#include <bongo/sync/rw_mutex.h>
 #include <bongo/sync/wait_group.h>
@@ -0,0 +1,6 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <bongo/sync/atomic/pointer.h>
+#include <bongo/sync/atomic/value.h>
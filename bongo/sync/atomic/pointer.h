@@ -0,0 +1,41 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <atomic>
+
+namespace bongo::sync::atomic {
+
+/**
+ * An atomic pointer of type T*. The pointer is not owned; use value to
+ * publish objects that need safe reclamation.
+ *
+ * - https://golang.org/pkg/sync/atomic/#Pointer
+ */
+template <typename T>
+class pointer {
+  std::atomic<T*> v_ = nullptr;
+
+ public:
+  pointer() = default;
+  explicit pointer(T* p)
+      : v_{p} {}
+  pointer(pointer const& other) = delete;
+  pointer& operator=(pointer const& other) = delete;
+
+  // Atomically loads and returns the value stored in the pointer.
+  T* load() const noexcept { return v_.load(std::memory_order_acquire); }
+
+  // Atomically stores p into the pointer.
+  void store(T* p) noexcept { v_.store(p, std::memory_order_release); }
+
+  // Atomically stores p into the pointer and returns the previous value.
+  T* swap(T* p) noexcept { return v_.exchange(p, std::memory_order_acq_rel); }
+
+  // Executes the compare-and-swap operation for the pointer.
+  bool compare_and_swap(T* old, T* p) noexcept {
+    return v_.compare_exchange_strong(old, p, std::memory_order_acq_rel);
+  }
+};
+
+}  // namespace bongo::sync::atomic
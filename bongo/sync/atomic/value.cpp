@@ -0,0 +1,62 @@
+// Copyright The Go Authors.
+
+#include <sched.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "bongo/runtime/sema.h"
+#include "bongo/sync/atomic/value.h"
+
+namespace bongo::sync::atomic::detail {
+
+using namespace std::chrono_literals;
+
+epoch::epoch()
+    : size_{std::max(1u, std::thread::hardware_concurrency())}
+    , shards_{std::make_unique<shard[]>(size_)} {}
+
+std::atomic<int64_t>* epoch::enter() noexcept {
+  auto cpu = ::sched_getcpu();
+  auto& s = shards_[static_cast<size_t>(cpu < 0 ? 0 : cpu) % size_];
+  auto c = &s.readers[epoch_.load() & 1];
+  c->fetch_add(1);
+  return c;
+}
+
+void epoch::wait_readers(uint32_t idx) {
+  for (int iter = 0;; ++iter) {
+    int64_t n = 0;
+    for (size_t i = 0; i < size_; ++i) {
+      n += shards_[i].readers[idx].load();
+    }
+    if (n == 0) {
+      return;
+    }
+    if (runtime::can_spin(iter)) {
+      runtime::do_spin();
+    } else if (iter < 100) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(50us);
+    }
+  }
+}
+
+void epoch::synchronize() {
+  std::unique_lock lock{mutex_};
+  // A reader may have loaded the epoch just before a flip and incremented
+  // its counter just after, so flip twice and wait for both counters to
+  // drain.
+  for (int i = 0; i < 2; ++i) {
+    auto e = epoch_.fetch_xor(1);
+    wait_readers(e & 1);
+  }
+}
+
+}  // namespace bongo::sync::atomic::detail
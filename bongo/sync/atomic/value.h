@@ -0,0 +1,161 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include <bongo/sync/mutex.h>
+
+namespace bongo::sync::atomic {
+namespace detail {
+
+/**
+ * Read-copy-update grace period tracking.
+ *
+ * Readers increment a counter for the current epoch on a per-CPU shard,
+ * so concurrent readers do not share a cache line. synchronize flips the
+ * epoch twice and waits for the readers of each epoch to drain, after
+ * which no reader can still observe a pointer unpublished before the call.
+ */
+class epoch {
+  struct alignas(64) shard {
+    std::atomic<int64_t> readers[2] = {0, 0};
+  };
+
+  std::atomic<uint32_t> epoch_ = 0;
+  size_t size_;
+  std::unique_ptr<shard[]> shards_;
+  std::mutex mutex_;  // serializes synchronize
+
+  void wait_readers(uint32_t idx);
+
+ public:
+  epoch();
+  epoch(epoch const& other) = delete;
+  epoch& operator=(epoch const& other) = delete;
+
+  // Enters a read-side critical section. The returned counter must be
+  // passed to exit.
+  std::atomic<int64_t>* enter() noexcept;
+
+  // Leaves a read-side critical section.
+  static void exit(std::atomic<int64_t>* c) noexcept { c->fetch_sub(1); }
+
+  // Waits for all read-side critical sections that were entered before
+  // the call to exit.
+  void synchronize();
+};
+
+}  // namespace detail
+
+/**
+ * Provides atomic loads and stores of an immutable value.
+ *
+ * Reads never block and do not write to memory shared with other readers,
+ * which makes a value suitable for publishing configuration that is read
+ * far more often than it is replaced. Replacing the value waits until no
+ * reader can still be using the old one, then destroys it.
+ *
+ * - https://golang.org/pkg/sync/atomic/#Value
+ */
+template <typename T>
+class value {
+  std::atomic<T const*> v_ = nullptr;
+  mutable detail::epoch epoch_;
+  mutex w_;  // serializes writers
+
+  // Publishes p and returns the previous value once no reader can observe
+  // it any longer.
+  std::unique_ptr<T const> publish(T const* p) {
+    auto old = v_.exchange(p);
+    epoch_.synchronize();
+    return std::unique_ptr<T const>{old};
+  }
+
+ public:
+  // A read-side reference to the current value. The value cannot be
+  // destroyed while the reader exists, so readers should be short-lived
+  // and must not call store, swap or compare_and_swap on the same value.
+  class reader {
+    T const* p_;
+    std::atomic<int64_t>* c_;
+
+   public:
+    reader(T const* p, std::atomic<int64_t>* c)
+        : p_{p}, c_{c} {}
+    reader(reader&& other) noexcept
+        : p_{std::exchange(other.p_, nullptr)}, c_{std::exchange(other.c_, nullptr)} {}
+    reader(reader const& other) = delete;
+    reader& operator=(reader const& other) = delete;
+    reader& operator=(reader&& other) = delete;
+    ~reader() {
+      if (c_ != nullptr) {
+        detail::epoch::exit(c_);
+      }
+    }
+
+    T const* get() const noexcept { return p_; }
+    T const& operator*() const noexcept { return *p_; }
+    T const* operator->() const noexcept { return p_; }
+    explicit operator bool() const noexcept { return p_ != nullptr; }
+  };
+
+  value() = default;
+  explicit value(T v)
+      : v_{new T(std::move(v))} {}
+  value(value const& other) = delete;
+  value& operator=(value const& other) = delete;
+  ~value() { delete v_.load(); }
+
+  // Returns a reference to the value set by the most recent store. The
+  // reference is empty if there has been no call to store for this value.
+  reader read() const noexcept {
+    auto c = epoch_.enter();
+    return reader{v_.load(), c};
+  }
+
+  // Returns a copy of the value set by the most recent store, or nullopt
+  // if there has been no call to store for this value.
+  std::optional<T> load() const {
+    if (auto r = read(); r) {
+      return *r;
+    }
+    return std::nullopt;
+  }
+
+  // Sets the value to v.
+  void store(T v) {
+    auto p = new T(std::move(v));
+    std::unique_lock lock{w_};
+    publish(p);
+  }
+
+  // Stores v into the value and returns the previous value, or nullopt if
+  // the value was empty.
+  std::optional<T> swap(T v) {
+    auto p = new T(std::move(v));
+    std::unique_lock lock{w_};
+    if (auto old = publish(p); old) {
+      return *old;
+    }
+    return std::nullopt;
+  }
+
+  // Executes the compare-and-swap operation for the value.
+  bool compare_and_swap(T const& old, T v) {
+    std::unique_lock lock{w_};
+    auto cur = v_.load();
+    if (cur == nullptr || !(*cur == old)) {
+      return false;
+    }
+    publish(new T(std::move(v)));
+    return true;
+  }
+};
+
+}  // namespace bongo::sync::atomic
@@ -0,0 +1,152 @@
+// Copyright The Go Authors.
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "bongo/sync.h"
+#include "bongo/sync/atomic.h"
+
+namespace bongo::sync::atomic {
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Value", "[sync]") {
+  auto v = value<long>{};
+  CHECK(v.load() == std::nullopt);
+  CHECK_FALSE(v.read());
+  v.store(42);
+  CHECK(v.load() == 42);
+  v.store(84);
+  CHECK(*v.read() == 84);
+  CHECK(v.swap(1) == 84);
+  CHECK_FALSE(v.compare_and_swap(84, 2));
+  CHECK(v.compare_and_swap(1, 2));
+  CHECK(v.load() == 2);
+
+  auto empty = value<std::string>{};
+  CHECK(empty.swap("a") == std::nullopt);
+  CHECK_FALSE(value<std::string>{}.compare_and_swap("", "b"));
+}
+
+// A configuration whose fields must always be read consistently.
+struct config {
+  long a;
+  long b;
+  std::atomic<long>* live;
+
+  config(long n, std::atomic<long>* l)
+      : a{n}, b{n}, live{l} { live->fetch_add(1); }
+  config(config const& other)
+      : a{other.a}, b{other.b}, live{other.live} { live->fetch_add(1); }
+  ~config() { live->fetch_sub(1); }
+};
+
+TEST_CASE("Value concurrent reads", "[sync]") {
+  auto live = std::atomic<long>{0};
+  {
+    auto v = value<config>{config{0, &live}};
+    auto stop = std::atomic_bool{false};
+    std::vector<std::thread> readers;
+    for (long i = 0; i < 8; ++i) {
+      readers.emplace_back([&]() {
+        while (!stop.load()) {
+          auto r = v.read();
+          auto a = r->a;
+          std::this_thread::yield();
+          if (r->b != a) {
+            FAIL_CHECK("torn read: " << a << " " << r->b);
+            break;
+          }
+        }
+      });
+    }
+    for (long i = 1; i <= 200; ++i) {
+      v.store(config{i, &live});
+    }
+    stop.store(true);
+    for (auto& t : readers) {
+      t.join();
+    }
+    CHECK(v.load()->a == 200);
+    // Replaced values have been destroyed.
+    CHECK(live.load() == 1);
+  }
+  CHECK(live.load() == 0);
+}
+
+TEST_CASE("Pointer", "[sync]") {
+  long x = 1, y = 2;
+  auto p = pointer<long>{};
+  CHECK(p.load() == nullptr);
+  p.store(&x);
+  CHECK(p.load() == &x);
+  CHECK(p.swap(&y) == &x);
+  CHECK_FALSE(p.compare_and_swap(&x, &x));
+  CHECK(p.compare_and_swap(&y, &x));
+  CHECK(*p.load() == 1);
+}
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+template <typename Fn>
+void benchmark_readers(Catch::Benchmark::Chronometer& meter, long nthreads, Fn&& fn) {
+  constexpr long nreads = 10000;
+  meter.measure([&]() {
+    std::vector<std::thread> threads;
+    for (long t = 0; t < nthreads; ++t) {
+      threads.emplace_back([&]() {
+        for (long i = 0; i < nreads; ++i) {
+          fn();
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+  });
+}
+
+TEST_CASE("Value benchmarks", "[!benchmark]") {
+  struct cfg {
+    long a = 1;
+    long b = 2;
+  };
+
+  for (long nthreads : {1, 4, 16}) {
+    auto suffix = " (" + std::to_string(nthreads) + " threads)";
+
+    BENCHMARK_ADVANCED("Value read" + suffix)(Catch::Benchmark::Chronometer meter) {
+      auto v = value<cfg>{cfg{}};
+      auto sum = std::atomic<long>{0};
+      benchmark_readers(meter, nthreads, [&]() {
+        auto r = v.read();
+        sum.fetch_add(r->a, std::memory_order_relaxed);
+      });
+    };
+
+    BENCHMARK_ADVANCED("Mutex and shared_ptr read" + suffix)(Catch::Benchmark::Chronometer meter) {
+      auto m = std::mutex{};
+      auto v = std::make_shared<cfg const>();
+      auto sum = std::atomic<long>{0};
+      benchmark_readers(meter, nthreads, [&]() {
+        std::shared_ptr<cfg const> r;
+        {
+          std::unique_lock lock{m};
+          r = v;
+        }
+        sum.fetch_add(r->a, std::memory_order_relaxed);
+      });
+    };
+  }
+}
+
+#endif  // defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+}  // namespace bongo::sync::atomic
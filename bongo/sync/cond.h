@@ -0,0 +1,73 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <bongo/runtime/sema.h>
+#include <bongo/sync/mutex.h>
+
+namespace bongo::sync {
+
+/**
+ * A condition variable, a rendezvous point for threads waiting for or
+ * announcing the occurrence of an event.
+ *
+ * Each cond has an associated lock L, which must be held when changing the
+ * condition and when calling wait. L may be any type with lock and unlock
+ * methods, for example sync::mutex, sync::rw_mutex or std::mutex.
+ *
+ * Unlike std::condition_variable a woken waiter does not reacquire any
+ * internal lock, and signal and broadcast are a single atomic load when
+ * there are no waiters.
+ *
+ * - https://golang.org/pkg/sync/#Cond
+ */
+template <typename L = mutex>
+class cond {
+  L& l_;
+  runtime::notify_list notify_;
+
+ public:
+  explicit cond(L& l)
+      : l_{l} {}
+  cond(cond const& other) = delete;
+  cond& operator=(cond const& other) = delete;
+
+  // The lock held while observing or changing the condition.
+  L& locker() const noexcept { return l_; }
+
+  // Atomically unlocks the lock and suspends execution of the calling
+  // thread. After later resuming execution, wait locks the lock before
+  // returning. wait cannot return unless awoken by broadcast or signal.
+  //
+  // Because the lock is not held when wait first resumes, the caller
+  // typically cannot assume that the condition is true when wait returns.
+  // Instead, the caller should wait in a loop.
+  void wait() {
+    auto t = runtime::notify_list_add(&notify_);
+    l_.unlock();
+    runtime::notify_list_wait(&notify_, t);
+    l_.lock();
+  }
+
+  // Waits in a loop until pred returns true.
+  template <typename Predicate>
+  void wait(Predicate pred) {
+    while (!pred()) {
+      wait();
+    }
+  }
+
+  // Wakes one thread waiting on the cond, if there is any. It is allowed
+  // but not required for the caller to hold the lock during the call.
+  void signal() {
+    runtime::notify_list_notify_one(&notify_);
+  }
+
+  // Wakes all threads waiting on the cond. It is allowed but not required
+  // for the caller to hold the lock during the call.
+  void broadcast() {
+    runtime::notify_list_notify_all(&notify_);
+  }
+};
+
+}  // namespace bongo::sync
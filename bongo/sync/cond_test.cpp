@@ -0,0 +1,227 @@
+// Copyright The Go Authors.
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "bongo/bongo.h"
+#include "bongo/sync.h"
+
+namespace bongo::sync {
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Cond signal", "[sync]") {
+  auto m = mutex{};
+  auto c = cond{m};
+  constexpr long n = 2;
+  auto running = chan<bool>{n};
+  auto awake = chan<bool>{n};
+  std::vector<std::thread> threads;
+  for (long i = 0; i < n; ++i) {
+    threads.emplace_back([&]() {
+      m.lock();
+      running << true;
+      c.wait();
+      awake << true;
+      m.unlock();
+    });
+  }
+  bool v;
+  for (long i = 0; i < n; ++i) {
+    v << running;  // Wait for everyone to run.
+  }
+  std::optional<bool> a;
+  for (long n1 = n; n1 > 0; --n1) {
+    switch (select(
+      recv_select_case(awake, a),
+      default_select_case()
+    )) {
+    case 0:
+      FAIL_CHECK("thread not asleep");
+      break;
+    default:
+      break;
+    }
+    m.lock();
+    c.signal();
+    m.unlock();
+    v << awake;  // Will deadlock if no thread wakes up
+    switch (select(
+      recv_select_case(awake, a),
+      default_select_case()
+    )) {
+    case 0:
+      FAIL_CHECK("too many threads awake");
+      break;
+    default:
+      break;
+    }
+  }
+  c.signal();
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+TEST_CASE("Cond broadcast", "[sync]") {
+  auto m = std::mutex{};
+  auto c = cond{m};
+  constexpr long n = 20;
+  auto running = chan<long>{n};
+  auto awake = chan<long>{n};
+  auto exit = std::atomic_bool{false};
+  std::vector<std::thread> threads;
+  for (long i = 0; i < n; ++i) {
+    threads.emplace_back([&, i]() {
+      m.lock();
+      while (!exit.load()) {
+        running << i;
+        c.wait();
+        awake << i;
+      }
+      m.unlock();
+    });
+  }
+  long v;
+  for (long i = 0; i < 10; ++i) {
+    for (long j = 0; j < n; ++j) {
+      v << running;  // Wait for everyone to run.
+    }
+    if (i == 9) {
+      m.lock();
+      exit.store(true);
+      m.unlock();
+    }
+    m.lock();
+    c.broadcast();
+    m.unlock();
+    std::vector<bool> seen(n);
+    for (long j = 0; j < n; ++j) {
+      v << awake;
+      CHECK_FALSE(seen[v]);
+      seen[v] = true;
+    }
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+TEST_CASE("Cond wait with predicate", "[sync]") {
+  auto m = rw_mutex{};
+  auto c = cond{m};
+  long n = 0;
+  auto t = std::thread{[&]() {
+    for (long i = 0; i < 10; ++i) {
+      m.lock();
+      ++n;
+      m.unlock();
+      c.signal();
+    }
+  }};
+  m.lock();
+  c.wait([&]() { return n == 10; });
+  m.unlock();
+  t.join();
+  CHECK(n == 10);
+}
+
+TEST_CASE("Cond signal stealing", "[sync]") {
+  for (long iters = 0; iters < 1000; ++iters) {
+    auto m = mutex{};
+    auto c = cond{m};
+
+    // Start a waiter.
+    auto ch = chan<std::monostate>{};
+    auto t1 = std::thread{[&]() {
+      m.lock();
+      ch << std::monostate{};
+      c.wait();
+      m.unlock();
+      ch << std::monostate{};
+    }};
+    std::optional<std::monostate> v;
+    v << ch;
+    m.lock();
+    m.unlock();
+
+    // We know that the waiter is in the cond.wait() call because we
+    // synchronized with it, then acquired/released the mutex it was
+    // holding when we synchronized.
+    //
+    // Start two threads that will race: one will broadcast on the cond
+    // var, the other will wait on it.
+    //
+    // The new waiter may or may not get notified, but the first one has
+    // to be notified.
+    auto done = std::atomic_bool{false};
+    auto t2 = std::thread{[&]() { c.broadcast(); }};
+    auto t3 = std::thread{[&]() {
+      m.lock();
+      while (!done.load()) {
+        c.wait();
+      }
+      m.unlock();
+    }};
+
+    // Check that the first waiter does get signaled.
+    v << ch;
+
+    // Release the second waiter in case it didn't get the broadcast.
+    m.lock();
+    done.store(true);
+    m.unlock();
+    c.broadcast();
+    t1.join();
+    t2.join();
+    t3.join();
+  }
+}
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+TEST_CASE("Cond benchmarks", "[!benchmark]") {
+  BENCHMARK_ADVANCED("Signal without waiters")(Catch::Benchmark::Chronometer meter) {
+    auto m = mutex{};
+    auto c = cond{m};
+    meter.measure([&]() {
+      c.signal();
+    });
+  };
+
+  BENCHMARK_ADVANCED("Ping-pong")(Catch::Benchmark::Chronometer meter) {
+    constexpr long n = 1000;
+    auto m = mutex{};
+    auto c = cond{m};
+    meter.measure([&]() {
+      long turn = 0;
+      auto t = std::thread{[&]() {
+        m.lock();
+        for (long i = 0; i < n; ++i) {
+          c.wait([&]() { return turn%2 == 1; });
+          ++turn;
+          c.signal();
+        }
+        m.unlock();
+      }};
+      m.lock();
+      for (long i = 0; i < n; ++i) {
+        c.wait([&]() { return turn%2 == 0; });
+        ++turn;
+        c.signal();
+      }
+      m.unlock();
+      t.join();
+    });
+  };
+}
+
+#endif  // defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+}  // namespace bongo::sync
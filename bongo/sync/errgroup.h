@@ -0,0 +1,5 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <bongo/sync/errgroup/errgroup.h>
@@ -0,0 +1,112 @@
+// Copyright The Go Authors.
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <variant>
+
+#include "bongo/bongo.h"
+#include "bongo/context/context.h"
+#include "bongo/sync/errgroup/errgroup.h"
+
+namespace bongo::sync::errgroup {
+
+group::~group() {
+  wg_.wait();
+  if (cancel_) {
+    cancel_();
+  }
+}
+
+void group::done() {
+  if (sem_) {
+    std::optional<std::monostate> v;
+    v << *sem_;
+  }
+  wg_.done();
+}
+
+std::error_code group::wait() {
+  wg_.wait();
+  if (cancel_) {
+    cancel_();
+  }
+  if (exception_) {
+    std::rethrow_exception(exception_);
+  }
+  return err_;
+}
+
+void group::go(std::function<std::error_code()> fn) {
+  if (sem_) {
+    *sem_ << std::monostate{};
+  }
+  run(std::move(fn));
+}
+
+bool group::try_go(std::function<std::error_code()> fn) {
+  if (sem_) {
+    switch (select(
+      send_select_case(*sem_, std::monostate{}),
+      default_select_case()
+    )) {
+    case 0:
+      break;
+    default:
+      return false;
+    }
+  }
+  run(std::move(fn));
+  return true;
+}
+
+void group::run(std::function<std::error_code()> fn) {
+  wg_.add(1);
+  try {
+    std::thread{[this, fn = std::move(fn)]() {
+      auto d = runtime::defer([this]() { done(); });
+      std::error_code err;
+      std::exception_ptr p;
+      try {
+        err = fn();
+      } catch (...) {
+        p = std::current_exception();
+      }
+      if (err || p) {
+        err_once_.call([&]() {
+          err_ = err;
+          exception_ = p;
+          if (cancel_) {
+            cancel_();
+          }
+        });
+      }
+    }}.detach();
+  } catch (...) {
+    done();
+    throw;
+  }
+}
+
+void group::set_limit(long n) {
+  if (n < 0) {
+    sem_.reset();
+    return;
+  }
+  if (sem_ && sem_->len() != 0) {
+    throw std::logic_error{"errgroup: modify limit while threads are active"};
+  }
+  sem_ = std::make_unique<chan<std::monostate>>(static_cast<size_t>(n));
+}
+
+std::pair<std::unique_ptr<group>, context::context_type> with_context(context::context_type ctx) {
+  auto [c, cancel] = context::with_cancel(std::move(ctx));
+  return {std::make_unique<group>(std::move(cancel)), std::move(c)};
+}
+
+}  // namespace bongo::sync::errgroup
@@ -0,0 +1,83 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <system_error>
+#include <utility>
+#include <variant>
+
+#include <bongo/bongo.h>
+#include <bongo/context/context.h>
+#include <bongo/sync/once.h>
+#include <bongo/sync/wait_group.h>
+
+namespace bongo::sync::errgroup {
+
+/**
+ * A collection of threads working on subtasks that are part of the same
+ * overall task.
+ *
+ * A group must not be destroyed while tasks are running; the destructor
+ * waits for them.
+ *
+ * - https://pkg.go.dev/golang.org/x/sync/errgroup#Group
+ */
+class group {
+  context::cancel_func cancel_;
+  wait_group wg_;
+  std::unique_ptr<chan<std::monostate>> sem_;
+  once err_once_;
+  std::error_code err_;
+  std::exception_ptr exception_;
+
+  void done();
+  void run(std::function<std::error_code()> fn);
+
+ public:
+  group() = default;
+  explicit group(context::cancel_func cancel)
+      : cancel_{std::move(cancel)} {}
+  group(group const& other) = delete;
+  group& operator=(group const& other) = delete;
+  ~group();
+
+  // Blocks until all function calls from the go method have returned, then
+  // returns the first non-nil error (if any) from them. If a function threw
+  // an exception, the first exception is rethrown instead.
+  std::error_code wait();
+
+  // Calls the given function in a new thread. It blocks until the new
+  // thread can be added without the number of active threads in the group
+  // exceeding the configured limit.
+  //
+  // The first call to return a non-nil error cancels the group's context,
+  // if the group was created by calling with_context. The error will be
+  // returned by wait.
+  void go(std::function<std::error_code()> fn);
+
+  // Calls the given function in a new thread only if the number of active
+  // threads in the group is currently below the configured limit. The
+  // return value reports whether the thread was started.
+  bool try_go(std::function<std::error_code()> fn);
+
+  // Limits the number of active threads in this group to at most n. A
+  // negative value indicates no limit. A limit of zero will prevent any
+  // new threads from being added.
+  //
+  // Any subsequent call to the go method will block until it can add an
+  // active thread without exceeding the configured limit. The limit must
+  // not be modified while any threads in the group are active.
+  void set_limit(long n);
+};
+
+// Returns a new group and an associated context derived from ctx.
+//
+// The derived context is canceled the first time a function passed to go
+// returns a non-nil error or the first time wait returns, whichever occurs
+// first.
+std::pair<std::unique_ptr<group>, context::context_type> with_context(context::context_type ctx);
+
+}  // namespace bongo::sync::errgroup
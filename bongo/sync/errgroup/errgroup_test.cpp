@@ -0,0 +1,134 @@
+// Copyright The Go Authors.
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "bongo/bongo.h"
+#include "bongo/context.h"
+#include "bongo/sync/errgroup.h"
+
+namespace bongo::sync::errgroup {
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Zero group", "[sync]") {
+  auto err1 = std::make_error_code(std::errc::io_error);
+  std::vector<std::pair<std::vector<std::error_code>, std::error_code>> tests = {
+    {{}, nil},
+    {{nil}, nil},
+    {{err1}, err1},
+    {{err1, nil}, err1},
+    {{nil, err1}, err1},
+  };
+  for (auto& [errs, want] : tests) {
+    auto g = group{};
+    std::error_code first = nil;
+    for (auto err : errs) {
+      g.go([err]() { return err; });
+      // Each call completes before the next is started, so the first
+      // error is deterministic.
+      if (first == nil) {
+        first = g.wait();
+      } else {
+        g.wait();
+      }
+    }
+    CHECK(g.wait() == want);
+    CHECK(first == want);
+  }
+}
+
+TEST_CASE("Group with context", "[sync]") {
+  auto err = std::make_error_code(std::errc::io_error);
+  auto [g, ctx] = with_context(context::background());
+  for (long i = 0; i < 4; ++i) {
+    g->go([i, err, ctx = ctx]() -> std::error_code {
+      if (i == 0) {
+        return err;
+      }
+      // The failing task cancels the others.
+      std::optional<std::monostate> d;
+      select(recv_select_case(ctx->done(), d));
+      return ctx->err();
+    });
+  }
+  CHECK(g->wait() == err);
+  CHECK(ctx->err() == context::error::canceled);
+}
+
+TEST_CASE("Group wait cancels context", "[sync]") {
+  auto [g, ctx] = with_context(context::background());
+  g->go([]() -> std::error_code { return nil; });
+  CHECK(g->wait() == nil);
+  CHECK(ctx->err() == context::error::canceled);
+}
+
+TEST_CASE("Group exception", "[sync]") {
+  auto g = group{};
+  g.go([]() -> std::error_code { throw std::runtime_error{"boom"}; });
+  CHECK_THROWS_AS(g.wait(), std::runtime_error);
+}
+
+TEST_CASE("Group limit", "[sync]") {
+  for (long limit : {1, 2, 4, 16}) {
+    auto g = group{};
+    g.set_limit(limit);
+    auto active = std::atomic<long>{0};
+    auto max_active = std::atomic<long>{0};
+    for (long i = 0; i < 64; ++i) {
+      g.go([&]() -> std::error_code {
+        auto n = active.fetch_add(1) + 1;
+        auto m = max_active.load();
+        while (n > m && !max_active.compare_exchange_weak(m, n)) {}
+        std::this_thread::sleep_for(100us);
+        active.fetch_sub(1);
+        return nil;
+      });
+    }
+    CHECK(g.wait() == nil);
+    CHECK(max_active.load() <= limit);
+  }
+}
+
+TEST_CASE("Group try go", "[sync]") {
+  auto g = group{};
+  auto n = 42;
+  auto ch = chan<std::monostate>{};
+  auto fn = [&]() -> std::error_code {
+    ch << std::monostate{};
+    return nil;
+  };
+  std::optional<std::monostate> v;
+
+  for (long i = 0; i < n; ++i) {
+    CHECK(g.try_go(fn));
+  }
+  // Drain the group.
+  for (long i = 0; i < n; ++i) {
+    v << ch;
+  }
+  CHECK(g.wait() == nil);
+
+  g.set_limit(n);
+  for (long i = 0; i < n; ++i) {
+    CHECK(g.try_go(fn));
+  }
+  // Reach the limit.
+  CHECK_FALSE(g.try_go(fn));
+  // Drain the group.
+  for (long i = 0; i < n; ++i) {
+    v << ch;
+  }
+  CHECK(g.wait() == nil);
+
+  g.set_limit(0);
+  CHECK_FALSE(g.try_go(fn));
+}
+
+}  // namespace bongo::sync::errgroup
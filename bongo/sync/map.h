@@ -0,0 +1,190 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <bongo/sync/rw_mutex.h>
+
+namespace bongo::sync {
+
+/**
+ * A map that is safe for concurrent use by multiple threads.
+ *
+ * The map is optimized for read-mostly workloads, such as caches and
+ * registries that are written once and read many times, and for workloads
+ * where threads read and write disjoint sets of keys. Keys are striped
+ * over a fixed number of shards, each guarded by a rw_mutex, so readers
+ * take a single uncontended atomic increment on their shard and writers
+ * only block readers of the same shard.
+ *
+ * Unlike Go, values are returned by copy. Store shared_ptr values to share
+ * large objects.
+ *
+ * - https://golang.org/pkg/sync/#Map
+ */
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class map {
+  constexpr static size_t shard_count = 64;
+
+  struct alignas(64) shard {
+    mutable rw_mutex mutex;
+    std::unordered_map<K, V, Hash, KeyEqual> m;
+  };
+
+  std::array<shard, shard_count> shards_;
+
+  shard& shard_for(K const& key) {
+    return shards_[index(key)];
+  }
+
+  shard const& shard_for(K const& key) const {
+    return shards_[index(key)];
+  }
+
+  static size_t index(K const& key) {
+    // Mix the hash so that the shard is not chosen by the low bits of an
+    // identity hash.
+    auto h = static_cast<uint64_t>(Hash{}(key)) * 0x9e3779b97f4a7c15ull;
+    return static_cast<size_t>(h >> 32) % shard_count;
+  }
+
+ public:
+  map() = default;
+  map(map const& other) = delete;
+  map& operator=(map const& other) = delete;
+
+  // Returns the value stored in the map for a key, or nullopt if no value
+  // is present.
+  std::optional<V> load(K const& key) const {
+    auto& s = shard_for(key);
+    std::shared_lock lock{s.mutex};
+    if (auto it = s.m.find(key); it != s.m.end()) {
+      return it->second;
+    }
+    return std::nullopt;
+  }
+
+  // Sets the value for a key.
+  void store(K const& key, V value) {
+    swap(key, std::move(value));
+  }
+
+  // Returns the existing value for the key if present. Otherwise, it stores
+  // and returns the given value. The loaded result is true if the value
+  // was loaded, false if stored.
+  std::pair<V, bool> load_or_store(K const& key, V value) {
+    auto& s = shard_for(key);
+    {
+      std::shared_lock lock{s.mutex};
+      if (auto it = s.m.find(key); it != s.m.end()) {
+        return {it->second, true};
+      }
+    }
+    std::unique_lock lock{s.mutex};
+    auto [it, inserted] = s.m.try_emplace(key, std::move(value));
+    return {it->second, !inserted};
+  }
+
+  // Deletes the value for a key, returning the previous value if any.
+  std::optional<V> load_and_delete(K const& key) {
+    auto& s = shard_for(key);
+    std::unique_lock lock{s.mutex};
+    auto it = s.m.find(key);
+    if (it == s.m.end()) {
+      return std::nullopt;
+    }
+    auto value = std::move(it->second);
+    s.m.erase(it);
+    return value;
+  }
+
+  // Deletes the value for a key.
+  void erase(K const& key) {
+    auto& s = shard_for(key);
+    std::unique_lock lock{s.mutex};
+    s.m.erase(key);
+  }
+
+  // Swaps the value for a key and returns the previous value if any.
+  std::optional<V> swap(K const& key, V value) {
+    auto& s = shard_for(key);
+    std::unique_lock lock{s.mutex};
+    auto [it, inserted] = s.m.try_emplace(key, std::move(value));
+    if (inserted) {
+      return std::nullopt;
+    }
+    std::swap(it->second, value);
+    return value;
+  }
+
+  // Swaps the old and new values for key if the value stored in the map is
+  // equal to old.
+  bool compare_and_swap(K const& key, V const& old, V value) {
+    auto& s = shard_for(key);
+    std::unique_lock lock{s.mutex};
+    auto it = s.m.find(key);
+    if (it == s.m.end() || !(it->second == old)) {
+      return false;
+    }
+    it->second = std::move(value);
+    return true;
+  }
+
+  // Deletes the entry for key if its value is equal to old. If there is no
+  // current value for key in the map, compare_and_delete returns false.
+  bool compare_and_delete(K const& key, V const& old) {
+    auto& s = shard_for(key);
+    std::unique_lock lock{s.mutex};
+    auto it = s.m.find(key);
+    if (it == s.m.end() || !(it->second == old)) {
+      return false;
+    }
+    s.m.erase(it);
+    return true;
+  }
+
+  // Calls fn sequentially for each key and value present in the map. If fn
+  // returns false, range stops the iteration.
+  //
+  // Range does not correspond to any consistent snapshot of the map's
+  // contents: no key will be visited more than once, but if the value for
+  // any key is stored or deleted concurrently, range may reflect any
+  // mapping for that key from any point during the range call. No lock is
+  // held while fn is called, so fn may call any method on the map.
+  template <typename Fn>
+  void range(Fn&& fn) const {
+    std::vector<std::pair<K, V>> entries;
+    for (auto& s : shards_) {
+      entries.clear();
+      {
+        std::shared_lock lock{s.mutex};
+        entries.assign(s.m.begin(), s.m.end());
+      }
+      for (auto& [k, v] : entries) {
+        if (!fn(k, v)) {
+          return;
+        }
+      }
+    }
+  }
+
+  // Deletes all the entries.
+  void clear() {
+    for (auto& s : shards_) {
+      std::unique_lock lock{s.mutex};
+      s.m.clear();
+    }
+  }
+};
+
+}  // namespace bongo::sync
@@ -0,0 +1,215 @@
+// Copyright The Go Authors.
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "bongo/sync.h"
+
+namespace bongo::sync {
+
+TEST_CASE("Map", "[sync]") {
+  auto m = map<std::string, long>{};
+  CHECK(m.load("a") == std::nullopt);
+  m.store("a", 1);
+  CHECK(m.load("a") == 1);
+  m.store("a", 2);
+  CHECK(m.load("a") == 2);
+
+  SECTION("Load or store") {
+    CHECK(m.load_or_store("a", 3) == std::pair{2l, true});
+    CHECK(m.load_or_store("b", 3) == std::pair{3l, false});
+    CHECK(m.load("b") == 3);
+  }
+
+  SECTION("Delete") {
+    m.erase("a");
+    CHECK(m.load("a") == std::nullopt);
+    m.erase("a");
+    m.store("a", 4);
+    CHECK(m.load_and_delete("a") == 4);
+    CHECK(m.load_and_delete("a") == std::nullopt);
+  }
+
+  SECTION("Swap") {
+    CHECK(m.swap("a", 5) == 2);
+    CHECK(m.swap("b", 6) == std::nullopt);
+    CHECK(m.load("a") == 5);
+    CHECK(m.load("b") == 6);
+  }
+
+  SECTION("Compare and swap") {
+    CHECK_FALSE(m.compare_and_swap("a", 1, 7));
+    CHECK(m.compare_and_swap("a", 2, 7));
+    CHECK(m.load("a") == 7);
+    CHECK_FALSE(m.compare_and_swap("x", 0, 1));
+    CHECK(m.load("x") == std::nullopt);
+  }
+
+  SECTION("Compare and delete") {
+    CHECK_FALSE(m.compare_and_delete("a", 1));
+    CHECK(m.compare_and_delete("a", 2));
+    CHECK(m.load("a") == std::nullopt);
+    CHECK_FALSE(m.compare_and_delete("a", 2));
+  }
+}
+
+TEST_CASE("Map range nested call", "[sync]") {
+  auto m = map<long, std::string>{};
+  for (long i = 0; i < 100; ++i) {
+    m.store(i, std::to_string(i));
+  }
+  long n = 0;
+  m.range([&](long const& k, std::string const& v) {
+    CHECK(std::to_string(k % 1000) == v);
+    // Nested calls may modify the map while ranging.
+    if (k < 1000) {
+      m.store(k+1000, v);
+      m.erase(k);
+      ++n;
+    }
+    return true;
+  });
+  CHECK(n == 100);
+  CHECK(m.load(0) == std::nullopt);
+  CHECK(m.load(1000) == "0");
+
+  n = 0;
+  m.range([&](long const&, std::string const&) {
+    return ++n < 10;
+  });
+  CHECK(n == 10);
+
+  m.clear();
+  n = 0;
+  m.range([&](long const&, std::string const&) { return ++n, true; });
+  CHECK(n == 0);
+}
+
+TEST_CASE("Map concurrent range", "[sync]") {
+  constexpr long map_size = 1 << 10;
+  auto m = map<long, long>{};
+  for (long n = 1; n <= map_size; ++n) {
+    m.store(n, n);
+  }
+  auto stop = std::atomic_bool{false};
+  std::vector<std::thread> threads;
+  for (long g = 1; g <= 4; ++g) {
+    threads.emplace_back([&, g]() {
+      for (long i = 0; !stop.load(); ++i) {
+        for (long n = 1; n < map_size; ++n) {
+          if ((n*i*g) % 3 == 0) {
+            m.store(n, n*i*g);
+          } else {
+            m.load(n);
+          }
+        }
+      }
+    });
+  }
+  for (long j = 0; j < 16; ++j) {
+    long seen = 0;
+    m.range([&](long const& k, long const& v) {
+      if (v % k != 0) {
+        FAIL_CHECK("while storing multiples of " << k << ", range saw value " << v);
+      }
+      ++seen;
+      return true;
+    });
+    CHECK(seen == map_size);
+  }
+  stop.store(true);
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+// A map guarded by a single mutex, for comparison.
+template <typename Mutex>
+class locked_map {
+  mutable Mutex mutex_;
+  std::unordered_map<long, long> m_;
+
+  auto lock_for_read() const {
+    if constexpr (std::is_same_v<Mutex, std::shared_mutex>) {
+      return std::shared_lock{mutex_};
+    } else {
+      return std::unique_lock{mutex_};
+    }
+  }
+
+ public:
+  std::optional<long> load(long key) const {
+    auto lock = lock_for_read();
+    if (auto it = m_.find(key); it != m_.end()) {
+      return it->second;
+    }
+    return std::nullopt;
+  }
+
+  void store(long key, long value) {
+    std::unique_lock lock{mutex_};
+    m_[key] = value;
+  }
+};
+
+// Each thread performs a fixed number of operations on a shared map, of
+// which 1% are stores.
+template <typename Map>
+void benchmark_read_mostly(Catch::Benchmark::Chronometer& meter, long nthreads) {
+  constexpr long nkeys = 1024;
+  constexpr long nops = 10000;
+  auto m = Map{};
+  for (long i = 0; i < nkeys; ++i) {
+    m.store(i, i);
+  }
+  meter.measure([&]() {
+    std::vector<std::thread> threads;
+    for (long t = 0; t < nthreads; ++t) {
+      threads.emplace_back([&, t]() {
+        for (long i = 0; i < nops; ++i) {
+          auto key = (i*7919 + t) % nkeys;
+          if (i%100 == 0) {
+            m.store(key, i);
+          } else {
+            m.load(key);
+          }
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+  });
+}
+
+TEST_CASE("Map benchmarks", "[!benchmark]") {
+  for (long nthreads : {1, 4, 16, 64}) {
+    auto suffix = " (" + std::to_string(nthreads) + " threads)";
+
+    BENCHMARK_ADVANCED("99% load sync::map" + suffix)(Catch::Benchmark::Chronometer meter) {
+      benchmark_read_mostly<map<long, long>>(meter, nthreads);
+    };
+
+    BENCHMARK_ADVANCED("99% load std::mutex" + suffix)(Catch::Benchmark::Chronometer meter) {
+      benchmark_read_mostly<locked_map<std::mutex>>(meter, nthreads);
+    };
+
+    BENCHMARK_ADVANCED("99% load std::shared_mutex" + suffix)(Catch::Benchmark::Chronometer meter) {
+      benchmark_read_mostly<locked_map<std::shared_mutex>>(meter, nthreads);
+    };
+  }
+}
+
+#endif  // defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+}  // namespace bongo::sync
@@ -0,0 +1,196 @@
+// Copyright The Go Authors.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+
+#include "bongo/runtime/nanotime.h"
+#include "bongo/runtime/sema.h"
+#include "bongo/sync/mutex.h"
+
+namespace bongo::sync {
+namespace {
+
+constexpr static int32_t mutex_locked = 1;  // mutex is locked
+constexpr static int32_t mutex_woken = 1 << 1;
+constexpr static int32_t mutex_starving = 1 << 2;
+constexpr static int32_t mutex_waiter_shift = 3;
+
+// Mutex fairness.
+//
+// Mutex can be in 2 modes of operations: normal and starvation. In normal
+// mode waiters are queued in FIFO order, but a woken up waiter does not own
+// the mutex and competes with new arriving threads over the ownership. New
+// arriving threads have an advantage -- they are already running on CPU and
+// there can be lots of them, so a woken up waiter has good chances of
+// losing. In such case it is queued at front of the wait queue. If a waiter
+// fails to acquire the mutex for more than 1ms, it switches mutex to the
+// starvation mode.
+//
+// In starvation mode ownership of the mutex is directly handed off from the
+// unlocking thread to the waiter at the front of the queue. New arriving
+// threads don't try to acquire the mutex even if it appears to be unlocked,
+// and don't try to spin. Instead they queue themselves at the tail of the
+// wait queue.
+//
+// If a waiter receives ownership of the mutex and sees that either (1) it
+// is the last waiter in the queue, or (2) it waited for less than 1 ms, it
+// switches mutex back to normal operation mode.
+constexpr static int64_t starvation_threshold_ns = 1000000;
+
+}  // namespace
+
+void mutex::lock() {
+  // Fast path: grab unlocked mutex.
+  int32_t old = 0;
+  if (state_.compare_exchange_strong(old, mutex_locked)) {
+    return;
+  }
+  // Slow path (outlined so that the fast path can be inlined).
+  lock_slow();
+}
+
+bool mutex::try_lock() {
+  auto old = state_.load();
+  if ((old & (mutex_locked|mutex_starving)) != 0) {
+    return false;
+  }
+  // There may be a thread waiting for the mutex, but we are running now and
+  // can try to grab the mutex before that thread wakes up.
+  return state_.compare_exchange_strong(old, old|mutex_locked);
+}
+
+void mutex::lock_slow() {
+  int64_t wait_start_time = 0;
+  auto starving = false;
+  auto awoke = false;
+  auto iter = 0;
+  auto old = state_.load();
+  for (;;) {
+    // Don't spin in starvation mode, ownership is handed off to waiters so
+    // we won't be able to acquire the mutex anyway.
+    if ((old & (mutex_locked|mutex_starving)) == mutex_locked && runtime::can_spin(iter)) {
+      // Active spinning makes sense. Try to set mutex_woken flag to inform
+      // unlock to not wake other blocked threads.
+      if (!awoke && (old & mutex_woken) == 0 && (old >> mutex_waiter_shift) != 0 &&
+          state_.compare_exchange_strong(old, old|mutex_woken)) {
+        awoke = true;
+      }
+      runtime::do_spin();
+      iter++;
+      old = state_.load();
+      continue;
+    }
+    auto new_state = old;
+    // Don't try to acquire starving mutex, new arriving threads must queue.
+    if ((old & mutex_starving) == 0) {
+      new_state |= mutex_locked;
+    }
+    if ((old & (mutex_locked|mutex_starving)) != 0) {
+      new_state += 1 << mutex_waiter_shift;
+    }
+    // The current thread switches mutex to starvation mode. But if the
+    // mutex is currently unlocked, don't do the switch. Unlock expects that
+    // starving mutex has waiters, which will not be true in this case.
+    if (starving && (old & mutex_locked) != 0) {
+      new_state |= mutex_starving;
+    }
+    if (awoke) {
+      // The thread has been woken from sleep, so we need to reset the flag
+      // in either case.
+      if ((new_state & mutex_woken) == 0) {
+        throw std::logic_error{"inconsistent mutex state"};
+      }
+      new_state &= ~mutex_woken;
+    }
+    if (state_.compare_exchange_strong(old, new_state)) {
+      if ((old & (mutex_locked|mutex_starving)) == 0) {
+        break;  // locked the mutex with CAS
+      }
+      // If we were already waiting before, queue at the front of the queue.
+      auto queue_lifo = wait_start_time != 0;
+      if (wait_start_time == 0) {
+        wait_start_time = runtime::nanotime();
+      }
+      runtime::semacquire(&sema_, queue_lifo);
+      starving = starving || runtime::nanotime() - wait_start_time > starvation_threshold_ns;
+      old = state_.load();
+      if ((old & mutex_starving) != 0) {
+        // If this thread was woken and mutex is in starvation mode,
+        // ownership was handed off to us but mutex is in somewhat
+        // inconsistent state: mutex_locked is not set and we are still
+        // accounted as waiter. Fix that.
+        if ((old & (mutex_locked|mutex_woken)) != 0 || (old >> mutex_waiter_shift) == 0) {
+          throw std::logic_error{"inconsistent mutex state"};
+        }
+        int32_t delta = mutex_locked - (1 << mutex_waiter_shift);
+        if (!starving || (old >> mutex_waiter_shift) == 1) {
+          // Exit starvation mode. Critical to do it here and consider wait
+          // time. Starvation mode is so inefficient, that two threads can
+          // go lock-step infinitely once they switch mutex to starvation
+          // mode.
+          delta -= mutex_starving;
+        }
+        state_.fetch_add(delta);
+        break;
+      }
+      awoke = true;
+      iter = 0;
+    }
+  }
+  if (wait_start_time != 0) {
+    contentions_.fetch_add(1, std::memory_order_relaxed);
+    wait_time_.fetch_add(runtime::nanotime() - wait_start_time, std::memory_order_relaxed);
+  }
+}
+
+void mutex::unlock() {
+  // Fast path: drop lock bit.
+  auto new_state = state_.fetch_sub(mutex_locked) - mutex_locked;
+  if (new_state != 0) {
+    // Outlined slow path to allow inlining the fast path.
+    unlock_slow(new_state);
+  }
+}
+
+void mutex::unlock_slow(int32_t new_state) {
+  if (((new_state + mutex_locked) & mutex_locked) == 0) {
+    throw std::logic_error{"unlock of unlocked mutex"};
+  }
+  if ((new_state & mutex_starving) == 0) {
+    auto old = new_state;
+    for (;;) {
+      // If there are no waiters or a thread has already been woken or
+      // grabbed the lock, no need to wake anyone. In starvation mode
+      // ownership is directly handed off from unlocking thread to the next
+      // waiter. We are not part of this chain, since we did not observe
+      // mutex_starving when we unlocked the mutex above. So get off the
+      // way.
+      if ((old >> mutex_waiter_shift) == 0 || (old & (mutex_locked|mutex_woken|mutex_starving)) != 0) {
+        return;
+      }
+      // Grab the right to wake someone.
+      new_state = (old - (1 << mutex_waiter_shift)) | mutex_woken;
+      if (state_.compare_exchange_strong(old, new_state)) {
+        runtime::semrelease(&sema_, false);
+        return;
+      }
+    }
+  } else {
+    // Starving mode: handoff mutex ownership to the next waiter. Note:
+    // mutex_locked is not set, the waiter will set it after wakeup. But
+    // mutex is still considered locked if mutex_starving is set, so new
+    // coming threads won't acquire it.
+    runtime::semrelease(&sema_, true);
+  }
+}
+
+contention_stats mutex::stats() const noexcept {
+  return {
+    contentions_.load(std::memory_order_relaxed),
+    std::chrono::nanoseconds{wait_time_.load(std::memory_order_relaxed)},
+  };
+}
+
+}  // namespace bongo::sync
@@ -0,0 +1,56 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace bongo::sync {
+
+// Contention statistics for a mutex. A contention is counted each time a
+// lock operation has to block, and wait_time is the total time spent
+// blocked.
+struct contention_stats {
+  uint64_t contentions = 0;
+  std::chrono::nanoseconds wait_time = {};
+};
+
+/**
+ * A mutual exclusion lock.
+ *
+ * Like Go, the mutex has two modes of operation: normal and starvation. In
+ * normal mode waiters are queued in FIFO order, but a woken up waiter does
+ * not own the mutex and competes with new arriving threads, which may spin
+ * briefly before blocking. If a waiter fails to acquire the mutex for more
+ * than 1ms the mutex switches to starvation mode, where ownership is handed
+ * off directly from the unlocking thread to the waiter at the front of the
+ * queue. This bounds tail latency under heavy contention.
+ *
+ * A mutex meets the Lockable requirements so it can be used with
+ * std::unique_lock and std::scoped_lock.
+ *
+ * - https://golang.org/pkg/sync/#Mutex
+ */
+class mutex {
+  std::atomic<int32_t> state_ = 0;
+  std::atomic<uint32_t> sema_ = 0;
+  std::atomic<uint64_t> contentions_ = 0;
+  std::atomic<int64_t> wait_time_ = 0;
+
+  void lock_slow();
+  void unlock_slow(int32_t new_state);
+
+ public:
+  mutex() = default;
+  mutex(mutex const& other) = delete;
+  mutex& operator=(mutex const& other) = delete;
+
+  void lock();
+  bool try_lock();
+  void unlock();
+
+  contention_stats stats() const noexcept;
+};
+
+}  // namespace bongo::sync
@@ -0,0 +1,170 @@
+// Copyright The Go Authors.
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "bongo/bongo.h"
+#include "bongo/sync.h"
+
+namespace bongo::sync {
+
+using namespace std::chrono_literals;
+
+void hammer_mutex(mutex& m, long loops, chan<bool>& cdone) {
+  for (long i = 0; i < loops; ++i) {
+    if (i%3 == 0) {
+      if (m.try_lock()) {
+        m.unlock();
+      }
+      continue;
+    }
+    m.lock();
+    m.unlock();
+  }
+  cdone << true;
+}
+
+TEST_CASE("Mutex", "[sync]") {
+  auto m = mutex{};
+  m.lock();
+  CHECK_FALSE(m.try_lock());
+  m.unlock();
+  CHECK(m.try_lock());
+  m.unlock();
+
+  auto c = chan<bool>{};
+  std::vector<std::thread> threads;
+  for (long i = 0; i < 10; ++i) {
+    threads.emplace_back([&]() { hammer_mutex(m, 1000, c); });
+  }
+  bool v;
+  for (long i = 0; i < 10; ++i) {
+    v << c;
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+TEST_CASE("Mutex protects a counter", "[sync]") {
+  auto m = mutex{};
+  long n = 0;
+  std::vector<std::thread> threads;
+  for (long i = 0; i < 8; ++i) {
+    threads.emplace_back([&]() {
+      for (long j = 0; j < 10000; ++j) {
+        auto lock = std::unique_lock{m};
+        ++n;
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  CHECK(n == 80000);
+}
+
+TEST_CASE("Mutex fairness", "[sync]") {
+  auto m = mutex{};
+  auto stop = std::atomic_bool{false};
+  auto t1 = std::thread{[&]() {
+    while (!stop.load()) {
+      m.lock();
+      std::this_thread::sleep_for(100us);
+      m.unlock();
+    }
+  }};
+  auto start = std::chrono::steady_clock::now();
+  auto t2 = std::thread{[&]() {
+    for (long i = 0; i < 10; ++i) {
+      std::this_thread::sleep_for(100us);
+      m.lock();
+      m.unlock();
+    }
+  }};
+  t2.join();
+  CHECK(std::chrono::steady_clock::now() - start < 10s);
+  stop.store(true);
+  t1.join();
+  CHECK(m.stats().contentions > 0);
+}
+
+TEST_CASE("Mutex contention stats", "[sync]") {
+  auto m = mutex{};
+  CHECK(m.stats().contentions == 0);
+  m.lock();
+  auto t = std::thread{[&]() {
+    m.lock();
+    m.unlock();
+  }};
+  std::this_thread::sleep_for(10ms);
+  m.unlock();
+  t.join();
+  auto stats = m.stats();
+  CHECK(stats.contentions == 1);
+  CHECK(stats.wait_time > 0ns);
+}
+
+TEST_CASE("Mutex misuse", "[sync]") {
+  CHECK_THROWS_AS([]() {
+    auto m = mutex{};
+    m.unlock();
+  }(), std::logic_error);
+}
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+template <typename Mutex>
+void benchmark_contended(Catch::Benchmark::Chronometer& meter, size_t nthreads) {
+  constexpr long nlocks = 1000;
+  auto m = Mutex{};
+  meter.measure([&]() {
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < nthreads; ++i) {
+      threads.emplace_back([&]() {
+        for (long j = 0; j < nlocks; ++j) {
+          m.lock();
+          m.unlock();
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+  });
+}
+
+TEST_CASE("Mutex benchmarks", "[!benchmark]") {
+  BENCHMARK_ADVANCED("Uncontended")(Catch::Benchmark::Chronometer meter) {
+    auto m = mutex{};
+    meter.measure([&]() {
+      m.lock();
+      m.unlock();
+    });
+  };
+
+  BENCHMARK_ADVANCED("Uncontended std::mutex")(Catch::Benchmark::Chronometer meter) {
+    auto m = std::mutex{};
+    meter.measure([&]() {
+      m.lock();
+      m.unlock();
+    });
+  };
+
+  BENCHMARK_ADVANCED("Contended (8 threads)")(Catch::Benchmark::Chronometer meter) {
+    benchmark_contended<mutex>(meter, 8);
+  };
+
+  BENCHMARK_ADVANCED("Contended std::mutex (8 threads)")(Catch::Benchmark::Chronometer meter) {
+    benchmark_contended<std::mutex>(meter, 8);
+  };
+}
+
+#endif  // defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+}  // namespace bongo::sync
@@ -0,0 +1,120 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include <bongo/runtime/defer.h>
+#include <bongo/sync/mutex.h>
+
+namespace bongo::sync {
+
+/**
+ * An object that will perform exactly one action.
+ *
+ * Once the action has run, call is a single acquire load, which is cheaper
+ * than std::call_once on the already-done path.
+ *
+ * - https://golang.org/pkg/sync/#Once
+ */
+class once {
+  // Indicates whether the action has been performed. It is first in the
+  // object so the hot path addresses it without an offset.
+  std::atomic<uint32_t> done_ = 0;
+  mutex m_;
+
+  template <typename Fn>
+  void call_slow(Fn&& fn);
+
+ public:
+  once() = default;
+  once(once const& other) = delete;
+  once& operator=(once const& other) = delete;
+
+  // Calls fn if and only if call is being called for the first time for
+  // this instance. No call to call returns until the one call to fn
+  // returns. If fn throws, call considers it to have returned and future
+  // calls of call return without calling fn.
+  template <typename Fn>
+  void call(Fn&& fn) {
+    if (done_.load(std::memory_order_acquire) == 0) {
+      // Outlined slow-path to allow inlining of the fast-path.
+      call_slow(std::forward<Fn>(fn));
+    }
+  }
+};
+
+template <typename Fn>
+void once::call_slow(Fn&& fn) {
+  std::unique_lock lock{m_};
+  if (done_.load(std::memory_order_relaxed) == 0) {
+    auto done = runtime::defer([this]() { done_.store(1, std::memory_order_release); });
+    std::forward<Fn>(fn)();
+  }
+}
+
+// Returns a function that invokes fn only once. The returned function may
+// be called concurrently. If fn throws, the returned function rethrows the
+// same exception on every call.
+template <typename Fn>
+auto once_func(Fn&& fn) {
+  struct state {
+    once o;
+    std::optional<std::decay_t<Fn>> fn;
+    std::exception_ptr p;
+  };
+  auto s = std::make_shared<state>();
+  s->fn.emplace(std::forward<Fn>(fn));
+  return [s]() {
+    s->o.call([&s]() {
+      try {
+        (*s->fn)();
+      } catch (...) {
+        s->p = std::current_exception();
+      }
+      s->fn.reset();
+    });
+    if (s->p) {
+      std::rethrow_exception(s->p);
+    }
+  };
+}
+
+// Returns a function that invokes fn only once and returns the value
+// returned by fn. The returned function may be called concurrently. If fn
+// throws, the returned function rethrows the same exception on every call.
+template <typename Fn>
+auto once_value(Fn&& fn) {
+  using T = std::invoke_result_t<Fn>;
+  struct state {
+    once o;
+    std::optional<std::decay_t<Fn>> fn;
+    std::optional<T> result;
+    std::exception_ptr p;
+  };
+  auto s = std::make_shared<state>();
+  s->fn.emplace(std::forward<Fn>(fn));
+  return [s]() -> T {
+    s->o.call([&s]() {
+      try {
+        s->result.emplace((*s->fn)());
+      } catch (...) {
+        s->p = std::current_exception();
+      }
+      s->fn.reset();
+    });
+    if (s->p) {
+      std::rethrow_exception(s->p);
+    }
+    return *s->result;
+  };
+}
+
+}  // namespace bongo::sync
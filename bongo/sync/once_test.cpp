@@ -0,0 +1,126 @@
+// Copyright The Go Authors.
+
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "bongo/bongo.h"
+#include "bongo/sync.h"
+
+namespace bongo::sync {
+
+struct one {
+  long v = 0;
+
+  void increment() { ++v; }
+};
+
+void run_once(one& o, once& once, chan<bool>& c) {
+  once.call([&o]() { o.increment(); });
+  CHECK(o.v == 1);
+  c << true;
+}
+
+TEST_CASE("Once", "[sync]") {
+  auto o = one{};
+  auto once = sync::once{};
+  auto c = chan<bool>{};
+  std::vector<std::thread> threads;
+  for (long i = 0; i < 10; ++i) {
+    threads.emplace_back([&]() { run_once(o, once, c); });
+  }
+  bool v;
+  for (long i = 0; i < 10; ++i) {
+    v << c;
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  CHECK(o.v == 1);
+}
+
+TEST_CASE("Once throws", "[sync]") {
+  auto once = sync::once{};
+  CHECK_THROWS_AS(once.call([]() { throw std::runtime_error{"failed"}; }), std::runtime_error);
+  once.call([]() { FAIL_CHECK("once called twice"); });
+}
+
+TEST_CASE("Once func", "[sync]") {
+  long calls = 0;
+  auto f = once_func([&calls]() { ++calls; });
+  f();
+  f();
+  auto g = f;
+  g();
+  CHECK(calls == 1);
+
+  auto h = once_func([&calls]() {
+    ++calls;
+    throw std::runtime_error{"x"};
+  });
+  CHECK_THROWS_AS(h(), std::runtime_error);
+  CHECK_THROWS_AS(h(), std::runtime_error);
+  CHECK(calls == 2);
+}
+
+TEST_CASE("Once value", "[sync]") {
+  long calls = 0;
+  auto f = once_value([&calls]() {
+    ++calls;
+    return std::string{"value"};
+  });
+  std::vector<std::thread> threads;
+  for (long i = 0; i < 10; ++i) {
+    threads.emplace_back([&]() { CHECK(f() == "value"); });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  CHECK(calls == 1);
+
+  auto g = once_value([&calls]() -> long {
+    ++calls;
+    throw std::runtime_error{"x"};
+  });
+  CHECK_THROWS_AS(g(), std::runtime_error);
+  CHECK_THROWS_AS(g(), std::runtime_error);
+  CHECK(calls == 2);
+}
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+TEST_CASE("Once benchmarks", "[!benchmark]") {
+  BENCHMARK_ADVANCED("Once")(Catch::Benchmark::Chronometer meter) {
+    auto once = sync::once{};
+    auto f = []() {};
+    once.call(f);
+    meter.measure([&]() {
+      once.call(f);
+    });
+  };
+
+  BENCHMARK_ADVANCED("std::call_once")(Catch::Benchmark::Chronometer meter) {
+    auto flag = std::once_flag{};
+    auto f = []() {};
+    std::call_once(flag, f);
+    meter.measure([&]() {
+      std::call_once(flag, f);
+    });
+  };
+
+  BENCHMARK_ADVANCED("Once value")(Catch::Benchmark::Chronometer meter) {
+    auto f = once_value([]() { return 42l; });
+    f();
+    meter.measure([&]() {
+      return f();
+    });
+  };
+}
+
+#endif  // defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+}  // namespace bongo::sync
@@ -0,0 +1,210 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <sched.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <bongo/sync/mutex.h>
+
+namespace bongo::sync {
+
+/**
+ * A set of temporary objects that may be individually saved and retrieved.
+ *
+ * Any item stored in the pool may be destroyed at any time without
+ * notification. A pool is safe for use by multiple threads simultaneously.
+ * Its purpose is to cache allocated but unused items for later reuse,
+ * relieving pressure on the allocator.
+ *
+ * Like Go, each CPU has a private slot and a shared list so that get and
+ * put are usually uncontended. Go drops pooled items across garbage
+ * collections through a victim cache. Here the same two-generation
+ * scheme is driven by time: once per trim interval the current contents
+ * become the victim cache and the previous victims are destroyed. Items
+ * that are not reused within two intervals are released.
+ *
+ * - https://golang.org/pkg/sync/#Pool
+ */
+template <typename T>
+class pool {
+ public:
+  using new_function = std::function<std::unique_ptr<T>()>;
+  using duration = std::chrono::steady_clock::duration;
+
+ private:
+  struct alignas(64) pool_local {
+    std::atomic<T*> private_ = nullptr;  // can be used only by the current CPU
+    mutex mutex_;
+    std::vector<T*> shared_;  // can be used by any CPU
+    std::vector<T*> victim_;  // previous generation of private and shared
+  };
+
+  new_function new_;
+  duration trim_interval_;
+  size_t size_;
+  std::unique_ptr<pool_local[]> local_;
+  std::atomic<int64_t> last_trim_;
+
+  pool_local& pin() noexcept;
+  std::unique_ptr<T> get_slow(pool_local& l);
+  void maybe_trim();
+
+  static int64_t now() noexcept {
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+  }
+
+ public:
+  constexpr static duration default_trim_interval = std::chrono::seconds{1};
+
+  pool()
+      : pool{nullptr} {}
+  explicit pool(new_function fn, duration trim_interval = default_trim_interval)
+      : new_{std::move(fn)},
+        trim_interval_{trim_interval},
+        size_{std::max(1u, std::thread::hardware_concurrency())},
+        local_{std::make_unique<pool_local[]>(size_)},
+        last_trim_{now()} {}
+
+  pool(pool const& other) = delete;
+  pool& operator=(pool const& other) = delete;
+
+  ~pool() {
+    for (size_t i = 0; i < size_; ++i) {
+      auto& l = local_[i];
+      delete l.private_.load();
+      for (auto x : l.shared_) {
+        delete x;
+      }
+      for (auto x : l.victim_) {
+        delete x;
+      }
+    }
+  }
+
+  // Selects an arbitrary item from the pool, removes it from the pool and
+  // returns it to the caller. If the pool is empty the item returned by the
+  // new function is returned, or nullptr if there is no new function.
+  std::unique_ptr<T> get();
+
+  // Adds x to the pool.
+  void put(std::unique_ptr<T> x);
+
+  // Moves the pool contents to the victim cache, destroying the previous
+  // victims. This is called periodically by get and put.
+  void trim();
+};
+
+template <typename T>
+typename pool<T>::pool_local& pool<T>::pin() noexcept {
+  auto cpu = ::sched_getcpu();
+  return local_[static_cast<size_t>(cpu < 0 ? 0 : cpu) % size_];
+}
+
+template <typename T>
+std::unique_ptr<T> pool<T>::get() {
+  auto& l = pin();
+  auto x = l.private_.exchange(nullptr);
+  if (x == nullptr) {
+    std::unique_lock lock{l.mutex_};
+    if (!l.shared_.empty()) {
+      x = l.shared_.back();
+      l.shared_.pop_back();
+    }
+  }
+  if (x == nullptr) {
+    return get_slow(l);
+  }
+  return std::unique_ptr<T>{x};
+}
+
+template <typename T>
+std::unique_ptr<T> pool<T>::get_slow(pool_local& l) {
+  maybe_trim();
+  // Try to steal one element from other CPUs.
+  auto start = static_cast<size_t>(&l - local_.get());
+  for (size_t i = 1; i < size_; ++i) {
+    auto& other = local_[(start+i) % size_];
+    std::unique_lock lock{other.mutex_};
+    if (!other.shared_.empty()) {
+      auto x = other.shared_.back();
+      other.shared_.pop_back();
+      return std::unique_ptr<T>{x};
+    }
+  }
+  // Try the victim cache. We do this after attempting to steal from all
+  // primary caches because we want objects in the victim cache to age out
+  // if at all possible.
+  for (size_t i = 0; i < size_; ++i) {
+    auto& other = local_[(start+i) % size_];
+    std::unique_lock lock{other.mutex_};
+    if (!other.victim_.empty()) {
+      auto x = other.victim_.back();
+      other.victim_.pop_back();
+      return std::unique_ptr<T>{x};
+    }
+  }
+  if (new_) {
+    return new_();
+  }
+  return nullptr;
+}
+
+template <typename T>
+void pool<T>::put(std::unique_ptr<T> x) {
+  if (x == nullptr) {
+    return;
+  }
+  auto& l = pin();
+  T* expected = nullptr;
+  if (l.private_.compare_exchange_strong(expected, x.get())) {
+    x.release();
+    return;
+  }
+  maybe_trim();
+  std::unique_lock lock{l.mutex_};
+  l.shared_.push_back(x.release());
+}
+
+template <typename T>
+void pool<T>::maybe_trim() {
+  auto last = last_trim_.load(std::memory_order_relaxed);
+  auto t = now();
+  if (t - last < trim_interval_.count()) {
+    return;
+  }
+  if (last_trim_.compare_exchange_strong(last, t)) {
+    trim();
+  }
+}
+
+template <typename T>
+void pool<T>::trim() {
+  for (size_t i = 0; i < size_; ++i) {
+    auto& l = local_[i];
+    std::vector<T*> victims;
+    {
+      std::unique_lock lock{l.mutex_};
+      victims.swap(l.victim_);
+      l.victim_.swap(l.shared_);
+      if (auto x = l.private_.exchange(nullptr); x != nullptr) {
+        l.victim_.push_back(x);
+      }
+    }
+    for (auto x : victims) {
+      delete x;
+    }
+  }
+}
+
+}  // namespace bongo::sync
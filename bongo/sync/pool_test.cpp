@@ -0,0 +1,139 @@
+// Copyright The Go Authors.
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "bongo/sync.h"
+
+namespace bongo::sync {
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Pool", "[sync]") {
+  // Trim explicitly below.
+  auto p = pool<std::string>{nullptr, 1h};
+  CHECK(p.get() == nullptr);
+  p.put(std::make_unique<std::string>("a"));
+  p.put(std::make_unique<std::string>("b"));
+  // Both items are on the current CPU unless the thread migrated, so
+  // either one may come back first.
+  auto g1 = p.get();
+  REQUIRE(g1 != nullptr);
+  auto g2 = p.get();
+  REQUIRE(g2 != nullptr);
+  CHECK(*g1 + *g2 != "");
+  CHECK((*g1 == "a" || *g1 == "b"));
+  CHECK(p.get() == nullptr);
+
+  // Put in a large number of items, so they spill into the shared list.
+  for (long i = 0; i < 100; ++i) {
+    p.put(std::make_unique<std::string>("c"));
+  }
+  // After one trim they move to the victim cache and can still be used.
+  p.trim();
+  auto g = p.get();
+  REQUIRE(g != nullptr);
+  CHECK(*g == "c");
+  // After a second trim they are released.
+  p.trim();
+  CHECK(p.get() == nullptr);
+}
+
+TEST_CASE("Pool new", "[sync]") {
+  long i = 0;
+  auto p = pool<long>{[&i]() {
+    ++i;
+    return std::make_unique<long>(i);
+  }};
+  auto v = p.get();
+  CHECK(*v == 1);
+  v = p.get();
+  CHECK(*v == 2);
+
+  p.put(std::make_unique<long>(42));
+  v = p.get();
+  CHECK(*v == 42);
+
+  v = p.get();
+  CHECK(*v == 3);
+}
+
+TEST_CASE("Pool trims unused items", "[sync]") {
+  auto p = pool<long>{nullptr, 10ms};
+  for (long i = 0; i < 10; ++i) {
+    p.put(std::make_unique<long>(i));
+  }
+  // Each slow path may trim once the interval has passed. Two trims
+  // release everything.
+  std::this_thread::sleep_for(20ms);
+  p.put(std::make_unique<long>(0));
+  p.put(std::make_unique<long>(0));
+  std::this_thread::sleep_for(20ms);
+  p.put(std::make_unique<long>(0));
+  p.put(std::make_unique<long>(0));
+  long n = 0;
+  while (p.get() != nullptr) {
+    ++n;
+  }
+  CHECK(n < 10);
+}
+
+TEST_CASE("Pool stress", "[sync]") {
+  constexpr long n = 10000;
+  auto p = pool<long>{};
+  auto done = std::atomic<long>{0};
+  std::vector<std::thread> threads;
+  for (long i = 0; i < 10; ++i) {
+    threads.emplace_back([&]() {
+      auto v = std::make_unique<long>(0);
+      for (long j = 0; j < n; ++j) {
+        p.put(std::move(v));
+        v = p.get();
+        if (v == nullptr) {
+          v = std::make_unique<long>(0);
+        } else if (*v != 0) {
+          FAIL_CHECK("expected 0, got " << *v);
+          break;
+        }
+      }
+      done.fetch_add(1);
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  CHECK(done.load() == 10);
+}
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+TEST_CASE("Pool benchmarks", "[!benchmark]") {
+  BENCHMARK_ADVANCED("Put/get")(Catch::Benchmark::Chronometer meter) {
+    auto p = pool<long>{[]() { return std::make_unique<long>(0); }};
+    meter.measure([&]() {
+      p.put(p.get());
+    });
+  };
+
+  BENCHMARK_ADVANCED("Overflow")(Catch::Benchmark::Chronometer meter) {
+    auto p = pool<long>{[]() { return std::make_unique<long>(0); }};
+    meter.measure([&]() {
+      for (long i = 0; i < 100; ++i) {
+        p.put(std::make_unique<long>(1));
+      }
+      for (long i = 0; i < 100; ++i) {
+        p.get();
+      }
+    });
+  };
+}
+
+#endif  // defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+}  // namespace bongo::sync
@@ -0,0 +1,110 @@
+// Copyright The Go Authors.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+
+#include "bongo/runtime/nanotime.h"
+#include "bongo/runtime/sema.h"
+#include "bongo/sync/rw_mutex.h"
+
+namespace bongo::sync {
+namespace {
+
+constexpr static int32_t rwmutex_max_readers = 1 << 30;
+
+}  // namespace
+
+void rw_mutex::lock_shared() {
+  if (reader_count_.fetch_add(1) + 1 < 0) {
+    // A writer is pending, wait for it.
+    auto start = runtime::nanotime();
+    runtime::semacquire(&reader_sem_, false);
+    record(start);
+  }
+}
+
+bool rw_mutex::try_lock_shared() {
+  auto c = reader_count_.load();
+  for (;;) {
+    if (c < 0) {
+      return false;
+    }
+    if (reader_count_.compare_exchange_weak(c, c+1)) {
+      return true;
+    }
+  }
+}
+
+void rw_mutex::unlock_shared() {
+  if (auto r = reader_count_.fetch_sub(1) - 1; r < 0) {
+    // Outlined slow-path to allow the fast-path to be inlined.
+    unlock_shared_slow(r);
+  }
+}
+
+void rw_mutex::unlock_shared_slow(int32_t r) {
+  if (r+1 == 0 || r+1 == -rwmutex_max_readers) {
+    throw std::logic_error{"unlock_shared of unlocked rw_mutex"};
+  }
+  // A writer is pending.
+  if (reader_wait_.fetch_sub(1) - 1 == 0) {
+    // The last reader unblocks the writer.
+    runtime::semrelease(&writer_sem_, false);
+  }
+}
+
+void rw_mutex::lock() {
+  // First, resolve competition with other writers.
+  w_.lock();
+  // Announce to readers there is a pending writer.
+  auto r = reader_count_.fetch_sub(rwmutex_max_readers);
+  // Wait for active readers.
+  if (r != 0 && reader_wait_.fetch_add(r) + r != 0) {
+    auto start = runtime::nanotime();
+    runtime::semacquire(&writer_sem_, false);
+    record(start);
+  }
+}
+
+bool rw_mutex::try_lock() {
+  if (!w_.try_lock()) {
+    return false;
+  }
+  int32_t c = 0;
+  if (!reader_count_.compare_exchange_strong(c, -rwmutex_max_readers)) {
+    w_.unlock();
+    return false;
+  }
+  return true;
+}
+
+void rw_mutex::unlock() {
+  // Announce to readers there is no active writer.
+  auto r = reader_count_.fetch_add(rwmutex_max_readers) + rwmutex_max_readers;
+  if (r >= rwmutex_max_readers) {
+    throw std::logic_error{"unlock of unlocked rw_mutex"};
+  }
+  // Unblock blocked readers, if any.
+  for (int32_t i = 0; i < r; ++i) {
+    runtime::semrelease(&reader_sem_, false);
+  }
+  // Allow other writers to proceed.
+  w_.unlock();
+}
+
+void rw_mutex::record(int64_t start) noexcept {
+  contentions_.fetch_add(1, std::memory_order_relaxed);
+  wait_time_.fetch_add(runtime::nanotime() - start, std::memory_order_relaxed);
+}
+
+contention_stats rw_mutex::stats() const noexcept {
+  auto w = w_.stats();
+  return {
+    w.contentions + contentions_.load(std::memory_order_relaxed),
+    w.wait_time + std::chrono::nanoseconds{wait_time_.load(std::memory_order_relaxed)},
+  };
+}
+
+}  // namespace bongo::sync
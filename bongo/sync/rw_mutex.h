@@ -0,0 +1,55 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include <bongo/sync/mutex.h>
+
+namespace bongo::sync {
+
+/**
+ * A reader/writer mutual exclusion lock. The lock can be held by an
+ * arbitrary number of readers or a single writer.
+ *
+ * Acquiring a read lock is a single atomic increment when there is no
+ * writer. If any thread calls lock while the lock is already held by one
+ * or more readers, concurrent calls to lock_shared block until the writer
+ * has acquired (and released) the lock, so writers are not starved.
+ *
+ * A rw_mutex meets the SharedLockable requirements so it can be used with
+ * std::shared_lock.
+ *
+ * - https://golang.org/pkg/sync/#RWMutex
+ */
+class rw_mutex {
+  mutex w_;                                // held if there are pending writers
+  std::atomic<uint32_t> writer_sem_ = 0;  // semaphore for writers to wait for completing readers
+  std::atomic<uint32_t> reader_sem_ = 0;  // semaphore for readers to wait for completing writers
+  std::atomic<int32_t> reader_count_ = 0;  // number of pending readers
+  std::atomic<int32_t> reader_wait_ = 0;   // number of departing readers
+  std::atomic<uint64_t> contentions_ = 0;
+  std::atomic<int64_t> wait_time_ = 0;
+
+  void unlock_shared_slow(int32_t r);
+  void record(int64_t start) noexcept;
+
+ public:
+  rw_mutex() = default;
+  rw_mutex(rw_mutex const& other) = delete;
+  rw_mutex& operator=(rw_mutex const& other) = delete;
+
+  void lock();
+  bool try_lock();
+  void unlock();
+
+  void lock_shared();
+  bool try_lock_shared();
+  void unlock_shared();
+
+  // Reports contention for both readers and writers.
+  contention_stats stats() const noexcept;
+};
+
+}  // namespace bongo::sync
@@ -0,0 +1,215 @@
+// Copyright The Go Authors.
+
+#include <atomic>
+#include <chrono>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "bongo/bongo.h"
+#include "bongo/sync.h"
+
+namespace bongo::sync {
+
+using namespace std::chrono_literals;
+
+void parallel_reader(rw_mutex& m, chan<bool>& clocked, chan<bool>& cunlock, chan<bool>& cdone) {
+  m.lock_shared();
+  clocked << true;
+  bool v;
+  v << cunlock;
+  m.unlock_shared();
+  cdone << true;
+}
+
+void do_parallel_readers(long num) {
+  auto m = rw_mutex{};
+  auto clocked = chan<bool>{};
+  auto cunlock = chan<bool>{};
+  auto cdone = chan<bool>{};
+  std::vector<std::thread> threads;
+  for (long i = 0; i < num; ++i) {
+    threads.emplace_back([&]() { parallel_reader(m, clocked, cunlock, cdone); });
+  }
+  bool v;
+  // Wait for all readers to grab the lock.
+  for (long i = 0; i < num; ++i) {
+    v << clocked;
+  }
+  for (long i = 0; i < num; ++i) {
+    cunlock << true;
+  }
+  // Wait for the readers to finish.
+  for (long i = 0; i < num; ++i) {
+    v << cdone;
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+TEST_CASE("Parallel readers", "[sync]") {
+  do_parallel_readers(1);
+  do_parallel_readers(3);
+  do_parallel_readers(4);
+}
+
+void reader(rw_mutex& m, long num_iterations, std::atomic<int32_t>& activity, chan<bool>& cdone) {
+  for (long i = 0; i < num_iterations; ++i) {
+    m.lock_shared();
+    auto n = activity.fetch_add(1) + 1;
+    if (n < 1 || n >= 10000) {
+      m.unlock_shared();
+      FAIL_CHECK("reader: " << n);
+      break;
+    }
+    activity.fetch_sub(1);
+    m.unlock_shared();
+  }
+  cdone << true;
+}
+
+void writer(rw_mutex& m, long num_iterations, std::atomic<int32_t>& activity, chan<bool>& cdone) {
+  for (long i = 0; i < num_iterations; ++i) {
+    m.lock();
+    auto n = activity.fetch_add(10000) + 10000;
+    if (n != 10000) {
+      m.unlock();
+      FAIL_CHECK("writer: " << n);
+      break;
+    }
+    activity.fetch_sub(10000);
+    m.unlock();
+  }
+  cdone << true;
+}
+
+void hammer_rw_mutex(long num_readers, long num_iterations) {
+  auto activity = std::atomic<int32_t>{0};
+  auto m = rw_mutex{};
+  auto cdone = chan<bool>{};
+  std::vector<std::thread> threads;
+  threads.emplace_back([&]() { writer(m, num_iterations, activity, cdone); });
+  long i = 0;
+  for (; i < num_readers/2; ++i) {
+    threads.emplace_back([&]() { reader(m, num_iterations, activity, cdone); });
+  }
+  threads.emplace_back([&]() { writer(m, num_iterations, activity, cdone); });
+  for (; i < num_readers; ++i) {
+    threads.emplace_back([&]() { reader(m, num_iterations, activity, cdone); });
+  }
+  // Wait for the 2 writers and all readers to finish.
+  bool v;
+  for (long i = 0; i < 2+num_readers; ++i) {
+    v << cdone;
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+TEST_CASE("RW mutex", "[sync]") {
+  auto m = rw_mutex{};
+  m.lock();
+  CHECK_FALSE(m.try_lock());
+  CHECK_FALSE(m.try_lock_shared());
+  m.unlock();
+  CHECK(m.try_lock());
+  m.unlock();
+  CHECK(m.try_lock_shared());
+  CHECK(m.try_lock_shared());
+  CHECK_FALSE(m.try_lock());
+  m.unlock_shared();
+  m.unlock_shared();
+  CHECK(m.try_lock());
+  m.unlock();
+
+  long n = 1000;
+  hammer_rw_mutex(1, n);
+  hammer_rw_mutex(3, n);
+  hammer_rw_mutex(10, n);
+}
+
+TEST_CASE("RW mutex writer preference", "[sync]") {
+  auto m = rw_mutex{};
+  m.lock_shared();
+  auto locked = std::atomic_bool{false};
+  auto w = std::thread{[&]() {
+    m.lock();
+    locked.store(true);
+    m.unlock();
+  }};
+  // Wait until the writer is pending, new readers must then block.
+  while (m.try_lock_shared()) {
+    m.unlock_shared();
+    std::this_thread::yield();
+  }
+  CHECK_FALSE(locked.load());
+  m.unlock_shared();
+  w.join();
+  CHECK(locked.load());
+  CHECK(m.stats().contentions > 0);
+}
+
+TEST_CASE("RW mutex misuse", "[sync]") {
+  CHECK_THROWS_AS([]() {
+    auto m = rw_mutex{};
+    m.unlock();
+  }(), std::logic_error);
+  CHECK_THROWS_AS([]() {
+    auto m = rw_mutex{};
+    m.lock();
+    m.unlock_shared();
+  }(), std::logic_error);
+}
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+template <typename Mutex>
+void benchmark_read_mostly(Catch::Benchmark::Chronometer& meter, size_t nthreads) {
+  constexpr long nops = 1000;
+  auto m = Mutex{};
+  meter.measure([&]() {
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < nthreads; ++i) {
+      threads.emplace_back([&]() {
+        for (long j = 0; j < nops; ++j) {
+          if (j%100 == 0) {
+            m.lock();
+            m.unlock();
+          } else {
+            m.lock_shared();
+            m.unlock_shared();
+          }
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+  });
+}
+
+TEST_CASE("RW mutex benchmarks", "[!benchmark]") {
+  BENCHMARK_ADVANCED("Uncontended read")(Catch::Benchmark::Chronometer meter) {
+    auto m = rw_mutex{};
+    meter.measure([&]() {
+      m.lock_shared();
+      m.unlock_shared();
+    });
+  };
+
+  BENCHMARK_ADVANCED("Read mostly (8 threads)")(Catch::Benchmark::Chronometer meter) {
+    benchmark_read_mostly<rw_mutex>(meter, 8);
+  };
+
+  BENCHMARK_ADVANCED("Read mostly std::shared_mutex (8 threads)")(Catch::Benchmark::Chronometer meter) {
+    benchmark_read_mostly<std::shared_mutex>(meter, 8);
+  };
+}
+
+#endif  // defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+}  // namespace bongo::sync
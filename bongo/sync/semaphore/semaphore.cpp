@@ -0,0 +1,136 @@
+// Copyright The Go Authors.
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+#include <variant>
+
+#include "bongo/bongo.h"
+#include "bongo/context/context.h"
+#include "bongo/sync/semaphore/semaphore.h"
+
+namespace bongo::sync::semaphore {
+
+std::error_code weighted::acquire(context::context_type const& ctx, int64_t n) {
+  auto* done = ctx->done();
+  std::optional<std::monostate> d;
+  std::unique_lock lock{mu_};
+  switch (select(
+    recv_select_case(done, d),
+    default_select_case()
+  )) {
+  case 0:
+    // ctx becoming done has "happened before" acquiring the semaphore,
+    // whether it became done before the call began or while we were
+    // waiting for the mutex. We prefer to fail even if we could acquire
+    // the mutex without blocking.
+    return ctx->err();
+  default:
+    break;
+  }
+
+  if (size_-cur_ >= n && waiters_.empty()) {
+    // Since we hold the mutex, and there are no waiters, nothing can
+    // change the semaphore.
+    cur_ += n;
+    return nil;
+  }
+
+  if (n > size_) {
+    // Don't make other acquire calls block on one that's doomed to fail.
+    lock.unlock();
+    select(recv_select_case(done, d));
+    return ctx->err();
+  }
+
+  auto elem = waiters_.emplace(waiters_.end(), n);
+  // Keep the channel alive, notify_waiters removes the waiter when it
+  // closes the channel.
+  auto ready = elem->ready;
+  lock.unlock();
+
+  switch (select(
+    recv_select_case(done, d),
+    recv_select_case(*ready, d)
+  )) {
+  case 0: {
+    lock.lock();
+    switch (select(
+      recv_select_case(*ready, d),
+      default_select_case()
+    )) {
+    case 0:
+      // Acquired the semaphore after we were canceled. Pretend we didn't
+      // and put the tokens back.
+      cur_ -= n;
+      notify_waiters();
+      break;
+    default: {
+      auto is_front = waiters_.begin() == elem;
+      waiters_.erase(elem);
+      // If we're at the front and there're extra tokens left, notify
+      // other waiters.
+      if (is_front && size_ > cur_) {
+        notify_waiters();
+      }
+      break;
+    }
+    }
+    return ctx->err();
+  }
+  default:
+    // Acquired the semaphore. Check that ctx isn't already done. We check
+    // the done channel instead of calling ctx->err() because we already
+    // have the channel, and ctx->err() takes a lock.
+    switch (select(
+      recv_select_case(done, d),
+      default_select_case()
+    )) {
+    case 0:
+      release(n);
+      return ctx->err();
+    default:
+      break;
+    }
+    return nil;
+  }
+}
+
+bool weighted::try_acquire(int64_t n) {
+  std::unique_lock lock{mu_};
+  auto success = size_-cur_ >= n && waiters_.empty();
+  if (success) {
+    cur_ += n;
+  }
+  return success;
+}
+
+void weighted::release(int64_t n) {
+  std::unique_lock lock{mu_};
+  cur_ -= n;
+  if (cur_ < 0) {
+    throw std::logic_error{"semaphore: released more than held"};
+  }
+  notify_waiters();
+}
+
+void weighted::notify_waiters() {
+  while (!waiters_.empty()) {
+    auto& w = waiters_.front();
+    if (size_-cur_ < w.n) {
+      // Not enough tokens for the next waiter. We could keep going (to try
+      // to find a waiter with a smaller request), but under load that
+      // could cause starvation for large requests; instead, we leave all
+      // remaining waiters blocked.
+      break;
+    }
+    cur_ += w.n;
+    w.ready->close();
+    waiters_.pop_front();
+  }
+}
+
+}  // namespace bongo::sync::semaphore
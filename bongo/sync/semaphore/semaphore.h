@@ -0,0 +1,68 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <system_error>
+#include <variant>
+
+#include <bongo/bongo.h>
+#include <bongo/context/context.h>
+#include <bongo/sync/mutex.h>
+
+namespace bongo::sync::semaphore {
+
+/**
+ * Provides a way to bound concurrent access to a resource. The callers can
+ * request access with a given weight.
+ *
+ * Waiters are served in FIFO order: a large request at the front of the
+ * queue blocks smaller requests behind it, so large requests are not
+ * starved.
+ *
+ * - https://pkg.go.dev/golang.org/x/sync/semaphore#Weighted
+ */
+class weighted {
+  struct waiter {
+    int64_t n;
+    std::shared_ptr<chan<std::monostate>> ready;  // closed when semaphore acquired
+
+    explicit waiter(int64_t n_)
+        : n{n_}
+        , ready{std::make_shared<chan<std::monostate>>()} {}
+  };
+
+  int64_t size_;
+  int64_t cur_ = 0;
+  mutex mu_;
+  std::list<waiter> waiters_;
+
+  void notify_waiters();
+
+ public:
+  // Creates a new weighted semaphore with the given maximum combined weight
+  // for concurrent access.
+  explicit weighted(int64_t n)
+      : size_{n} {}
+  weighted(weighted const& other) = delete;
+  weighted& operator=(weighted const& other) = delete;
+
+  // Acquires the semaphore with a weight of n, blocking until resources
+  // are available or ctx is done. On success, returns nil. On failure,
+  // returns ctx->err() and leaves the semaphore unchanged.
+  //
+  // If ctx is already done, acquire fails even if resources are available.
+  std::error_code acquire(context::context_type const& ctx, int64_t n);
+
+  // Acquires the semaphore with a weight of n without blocking. On
+  // success, returns true. On failure, returns false and leaves the
+  // semaphore unchanged.
+  bool try_acquire(int64_t n);
+
+  // Releases the semaphore with a weight of n.
+  void release(int64_t n);
+};
+
+}  // namespace bongo::sync::semaphore
@@ -0,0 +1,169 @@
+// Copyright The Go Authors.
+
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "bongo/bongo.h"
+#include "bongo/context.h"
+#include "bongo/sync/semaphore.h"
+
+namespace bongo::sync::semaphore {
+
+using namespace std::chrono_literals;
+
+void hammer_weighted(weighted& sem, int64_t n, long loops) {
+  for (long i = 0; i < loops; ++i) {
+    CHECK(sem.acquire(context::background(), n) == nil);
+    std::this_thread::yield();
+    sem.release(n);
+  }
+}
+
+TEST_CASE("Weighted", "[sync]") {
+  constexpr long n = 16;
+  constexpr long loops = 1000;
+  auto sem = weighted{n};
+  std::vector<std::thread> threads;
+  for (long i = 0; i < n; ++i) {
+    threads.emplace_back([&, i]() { hammer_weighted(sem, i+1, loops); });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+TEST_CASE("Weighted try acquire", "[sync]") {
+  auto sem = weighted{2};
+  CHECK(sem.try_acquire(1));
+  CHECK(sem.try_acquire(1));
+  CHECK_FALSE(sem.try_acquire(1));
+  sem.release(2);
+  CHECK(sem.try_acquire(1));
+  CHECK_FALSE(sem.try_acquire(2));
+  sem.release(1);
+}
+
+TEST_CASE("Weighted release too much", "[sync]") {
+  auto sem = weighted{1};
+  CHECK(sem.acquire(context::background(), 1) == nil);
+  CHECK_THROWS_AS(sem.release(2), std::logic_error);
+}
+
+TEST_CASE("Weighted acquire canceled", "[sync]") {
+  auto sem = weighted{2};
+  CHECK(sem.acquire(context::background(), 1) == nil);
+
+  SECTION("Already canceled") {
+    auto [ctx, cancel] = context::with_cancel(context::background());
+    cancel();
+    CHECK(sem.acquire(ctx, 1) == context::error::canceled);
+    CHECK(sem.try_acquire(1));
+  }
+
+  SECTION("Canceled while waiting") {
+    auto [ctx, cancel] = context::with_cancel(context::background());
+    auto t = std::thread{[&]() {
+      std::this_thread::sleep_for(10ms);
+      cancel();
+    }};
+    CHECK(sem.acquire(ctx, 2) == context::error::canceled);
+    t.join();
+    // The canceled waiter must not hold any tokens.
+    CHECK(sem.try_acquire(1));
+  }
+
+  SECTION("Larger than size") {
+    auto [ctx, cancel] = context::with_cancel(context::background());
+    auto t = std::thread{[&]() {
+      std::this_thread::sleep_for(10ms);
+      cancel();
+    }};
+    CHECK(sem.acquire(ctx, 3) == context::error::canceled);
+    t.join();
+  }
+}
+
+// Tests that a canceled large waiter at the front of the queue does not
+// block smaller waiters behind it.
+TEST_CASE("Weighted cancel wakes next waiter", "[sync]") {
+  auto sem = weighted{2};
+  CHECK(sem.acquire(context::background(), 1) == nil);
+
+  auto [ctx, cancel] = context::with_cancel(context::background());
+  auto big = std::thread{[&]() {
+    CHECK(sem.acquire(ctx, 2) == context::error::canceled);
+  }};
+  // Wait until the large waiter is queued: a small try_acquire then fails
+  // even though a token is free.
+  while (sem.try_acquire(1)) {
+    sem.release(1);
+    std::this_thread::yield();
+  }
+  auto small_done = chan<bool>{1};
+  auto small = std::thread{[&]() {
+    CHECK(sem.acquire(context::background(), 1) == nil);
+    small_done << true;
+  }};
+  cancel();
+  big.join();
+  bool v;
+  v << small_done;
+  small.join();
+  sem.release(2);
+}
+
+// Tests that a large acquire does not get starved by a stream of smaller
+// acquires.
+TEST_CASE("Weighted large acquire doesn't starve", "[sync]") {
+  constexpr int64_t n = 8;
+  auto sem = weighted{n};
+  auto running = std::atomic_bool{true};
+  std::vector<std::thread> threads;
+  for (int64_t i = 0; i < n; ++i) {
+    CHECK(sem.acquire(context::background(), 1) == nil);
+    threads.emplace_back([&]() {
+      while (running.load()) {
+        std::this_thread::sleep_for(1ms);
+        sem.release(1);
+        CHECK(sem.acquire(context::background(), 1) == nil);
+      }
+      sem.release(1);
+    });
+  }
+  CHECK(sem.acquire(context::background(), n) == nil);
+  running.store(false);
+  sem.release(n);
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+TEST_CASE("Weighted benchmarks", "[!benchmark]") {
+  BENCHMARK_ADVANCED("Acquire/release")(Catch::Benchmark::Chronometer meter) {
+    auto sem = weighted{1};
+    auto ctx = context::background();
+    meter.measure([&]() {
+      sem.acquire(ctx, 1);
+      sem.release(1);
+    });
+  };
+
+  BENCHMARK_ADVANCED("Try acquire/release")(Catch::Benchmark::Chronometer meter) {
+    auto sem = weighted{1};
+    meter.measure([&]() {
+      sem.try_acquire(1);
+      sem.release(1);
+    });
+  };
+}
+
+#endif  // defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+}  // namespace bongo::sync::semaphore
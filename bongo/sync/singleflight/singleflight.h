@@ -0,0 +1,193 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <bongo/bongo.h>
+#include <bongo/context/context.h>
+#include <bongo/sync/mutex.h>
+#include <bongo/sync/wait_group.h>
+
+namespace bongo::sync::singleflight {
+
+// Holds the results of call, so they can be passed on a channel.
+template <typename T>
+struct result {
+  T val = T{};
+  std::error_code err;
+  bool shared = false;
+  std::exception_ptr exception;  // set if the function threw
+};
+
+/**
+ * Represents a class of work and forms a namespace in which units of work
+ * can be executed with duplicate suppression.
+ *
+ * - https://pkg.go.dev/golang.org/x/sync/singleflight#Group
+ */
+template <typename T>
+class group {
+ public:
+  using function_type = std::function<std::pair<T, std::error_code>()>;
+  using result_type = result<T>;
+  using chan_type = chan<result_type>;
+
+ private:
+  // An in-flight or completed call.
+  struct call_state {
+    wait_group wg;
+
+    // These fields are written once before the wait group is done and are
+    // only read after the wait group is done.
+    T val = T{};
+    std::error_code err;
+    std::exception_ptr exception;
+
+    // These fields are read and written with the group mutex held before
+    // the wait group is done, and are read but not written after the wait
+    // group is done.
+    long dups = 0;
+    std::vector<std::shared_ptr<chan_type>> chans;
+  };
+
+  mutex mu_;  // protects m_
+  std::unordered_map<std::string, std::shared_ptr<call_state>> m_;
+  wait_group threads_;  // calls running on their own thread
+
+  void do_call(std::shared_ptr<call_state> c, std::string const& key, function_type const& fn);
+
+ public:
+  group() = default;
+  group(group const& other) = delete;
+  group& operator=(group const& other) = delete;
+  ~group() { threads_.wait(); }
+
+  // Executes and returns the results of the given function, making sure
+  // that only one execution is in-flight for a given key at a time. If a
+  // duplicate comes in, the duplicate caller waits for the original to
+  // complete and receives the same results. The shared field of the result
+  // indicates whether the value was given to multiple callers. If the
+  // function throws, every caller rethrows the exception.
+  result_type call(std::string const& key, function_type fn);
+
+  // Like call but waits at most until ctx is done. The function runs on a
+  // separate thread so a canceled caller returns ctx->err() immediately
+  // while the execution continues for the other callers.
+  result_type call(context::context_type const& ctx, std::string const& key, function_type fn);
+
+  // Like call but returns a channel that will receive the results when
+  // they are ready. The function runs on a separate thread.
+  std::shared_ptr<chan_type> call_chan(std::string const& key, function_type fn);
+
+  // Tells the group to forget about a key. Future calls for this key will
+  // call the function rather than waiting for an earlier call to complete.
+  void forget(std::string const& key);
+};
+
+template <typename T>
+void group<T>::do_call(std::shared_ptr<call_state> c, std::string const& key, function_type const& fn) {
+  try {
+    std::tie(c->val, c->err) = fn();
+  } catch (...) {
+    c->exception = std::current_exception();
+  }
+
+  std::unique_lock lock{mu_};
+  c->wg.done();
+  if (auto it = m_.find(key); it != m_.end() && it->second == c) {
+    m_.erase(it);
+  }
+  for (auto& ch : c->chans) {
+    *ch << result_type{c->val, c->err, c->dups > 0, c->exception};
+  }
+}
+
+template <typename T>
+typename group<T>::result_type group<T>::call(std::string const& key, function_type fn) {
+  std::unique_lock lock{mu_};
+  if (auto it = m_.find(key); it != m_.end()) {
+    auto c = it->second;
+    c->dups++;
+    lock.unlock();
+    c->wg.wait();
+    if (c->exception) {
+      std::rethrow_exception(c->exception);
+    }
+    return {c->val, c->err, true, nullptr};
+  }
+  auto c = std::make_shared<call_state>();
+  c->wg.add(1);
+  m_.emplace(key, c);
+  lock.unlock();
+
+  do_call(c, key, fn);
+  if (c->exception) {
+    std::rethrow_exception(c->exception);
+  }
+  return {c->val, c->err, c->dups > 0, nullptr};
+}
+
+template <typename T>
+typename group<T>::result_type group<T>::call(context::context_type const& ctx, std::string const& key, function_type fn) {
+  auto ch = call_chan(key, std::move(fn));
+  std::optional<result_type> r;
+  std::optional<std::monostate> d;
+  switch (select(
+    recv_select_case(*ch, r),
+    recv_select_case(ctx->done(), d)
+  )) {
+  case 0:
+    if (r->exception) {
+      std::rethrow_exception(r->exception);
+    }
+    return std::move(*r);
+  default:
+    return {T{}, ctx->err(), false, nullptr};
+  }
+}
+
+template <typename T>
+std::shared_ptr<typename group<T>::chan_type> group<T>::call_chan(std::string const& key, function_type fn) {
+  // Buffered so that the result can be delivered to a caller that has
+  // given up waiting.
+  auto ch = std::make_shared<chan_type>(1);
+  std::unique_lock lock{mu_};
+  if (auto it = m_.find(key); it != m_.end()) {
+    auto c = it->second;
+    c->dups++;
+    c->chans.push_back(ch);
+    return ch;
+  }
+  auto c = std::make_shared<call_state>();
+  c->chans.push_back(ch);
+  c->wg.add(1);
+  m_.emplace(key, c);
+  lock.unlock();
+
+  threads_.add(1);
+  std::thread{[this, c, key, fn = std::move(fn)]() {
+    auto done = runtime::defer([this]() { threads_.done(); });
+    do_call(c, key, fn);
+  }}.detach();
+  return ch;
+}
+
+template <typename T>
+void group<T>::forget(std::string const& key) {
+  std::unique_lock lock{mu_};
+  m_.erase(key);
+}
+
+}  // namespace bongo::sync::singleflight
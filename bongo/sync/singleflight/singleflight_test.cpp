@@ -0,0 +1,165 @@
+// Copyright The Go Authors.
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "bongo/bongo.h"
+#include "bongo/context.h"
+#include "bongo/sync.h"
+#include "bongo/sync/singleflight.h"
+
+namespace bongo::sync::singleflight {
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Singleflight do", "[sync]") {
+  auto g = group<std::string>{};
+  auto r = g.call("key", []() { return std::pair{std::string{"bar"}, std::error_code{}}; });
+  CHECK(r.val == "bar");
+  CHECK(r.err == nil);
+  CHECK_FALSE(r.shared);
+}
+
+TEST_CASE("Singleflight do error", "[sync]") {
+  auto g = group<std::string>{};
+  auto some_err = std::make_error_code(std::errc::io_error);
+  auto r = g.call("key", [&]() { return std::pair{std::string{}, some_err}; });
+  CHECK(r.err == some_err);
+  CHECK(r.val == "");
+}
+
+TEST_CASE("Singleflight do dup suppress", "[sync]") {
+  auto g = group<std::string>{};
+  auto wg1 = wait_group{};
+  auto wg2 = wait_group{};
+  auto c = chan<std::string>{1};
+  auto calls = std::atomic<long>{0};
+  auto fn = [&]() {
+    if (calls.fetch_add(1) + 1 == 1) {
+      // First invocation.
+      wg1.done();
+    }
+    std::optional<std::string> v;
+    v << c;
+    c << *v;  // pump; make available for any future calls
+    std::this_thread::sleep_for(10ms);  // let more threads enter call
+    return std::pair{*v, std::error_code{}};
+  };
+
+  constexpr long n = 10;
+  wg1.add(1);
+  std::vector<std::thread> threads;
+  for (long i = 0; i < n; ++i) {
+    wg1.add(1);
+    wg2.add(1);
+    threads.emplace_back([&]() {
+      wg1.done();
+      auto r = g.call("key", fn);
+      CHECK(r.err == nil);
+      CHECK(r.val == "bar");
+      wg2.done();
+    });
+  }
+  wg1.wait();
+  // At least one thread is in fn now and all of them have at least
+  // reached the line before the call.
+  c << std::string{"bar"};
+  wg2.wait();
+  for (auto& t : threads) {
+    t.join();
+  }
+  CHECK(calls.load() > 0);
+  CHECK(calls.load() < n);
+}
+
+TEST_CASE("Singleflight forget", "[sync]") {
+  auto g = group<long>{};
+  auto first_started = chan<std::monostate>{};
+  auto first_finished = chan<std::monostate>{};
+  auto first = std::thread{[&]() {
+    g.call("key", [&]() {
+      first_started.close();
+      std::optional<std::monostate> v;
+      v << first_finished;
+      return std::pair{1l, std::error_code{}};
+    });
+  }};
+  std::optional<std::monostate> v;
+  v << first_started;
+  g.forget("key");
+
+  // The second call runs a new execution even though the first is still
+  // in flight.
+  auto r = g.call("key", []() { return std::pair{2l, std::error_code{}}; });
+  CHECK(r.val == 2);
+  first_finished.close();
+  first.join();
+
+  // The third call shares the result of a slow in-flight fourth call.
+  auto ch = g.call_chan("key", []() {
+    std::this_thread::sleep_for(10ms);
+    return std::pair{3l, std::error_code{}};
+  });
+  r = g.call("key", []() { return std::pair{4l, std::error_code{}}; });
+  CHECK(r.val == 3);
+  CHECK(r.shared);
+  std::optional<result<long>> rr;
+  rr << *ch;
+  CHECK(rr->val == 3);
+}
+
+TEST_CASE("Singleflight do chan", "[sync]") {
+  auto g = group<std::string>{};
+  auto ch = g.call_chan("key", []() { return std::pair{std::string{"bar"}, std::error_code{}}; });
+  std::optional<result<std::string>> r;
+  r << *ch;
+  CHECK(r->val == "bar");
+  CHECK(r->err == nil);
+  CHECK_FALSE(r->shared);
+}
+
+TEST_CASE("Singleflight exception", "[sync]") {
+  auto g = group<long>{};
+  CHECK_THROWS_AS(g.call("key", []() -> std::pair<long, std::error_code> {
+    throw std::runtime_error{"boom"};
+  }), std::runtime_error);
+  // The key is released after the exception.
+  auto r = g.call("key", []() { return std::pair{1l, std::error_code{}}; });
+  CHECK(r.val == 1);
+}
+
+TEST_CASE("Singleflight context", "[sync]") {
+  auto g = group<long>{};
+  auto release = chan<std::monostate>{};
+  auto fn = [&]() {
+    std::optional<std::monostate> v;
+    v << release;
+    return std::pair{1l, std::error_code{}};
+  };
+
+  auto [ctx, cancel] = context::with_cancel(context::background());
+  auto t = std::thread{[&, cancel = cancel]() {
+    std::this_thread::sleep_for(10ms);
+    cancel();
+  }};
+  auto r = g.call(ctx, "key", fn);
+  CHECK(r.err == context::error::canceled);
+  t.join();
+
+  // The execution keeps running for callers that are still waiting.
+  auto ch = g.call_chan("key", fn);
+  release.close();
+  std::optional<result<long>> rr;
+  rr << *ch;
+  CHECK(rr->val == 1);
+  CHECK(rr->shared);
+}
+
+}  // namespace bongo::sync::singleflight
@@ -1,23 +1,57 @@
 // Copyright The Go Authors.
 
-#include <memory>
-#include <mutex>
+#include <atomic>
+#include <cstdint>
 #include <stdexcept>
 
 #include "bongo/sync/wait_group.h"
 
 namespace bongo::sync {
+namespace {
+
+void semacquire(std::atomic<uint32_t>& sema) {
+  auto v = sema.load();
+  for (;;) {
+    if (v == 0) {
+      sema.wait(0);
+      v = sema.load();
+      continue;
+    }
+    if (sema.compare_exchange_weak(v, v-1)) {
+      return;
+    }
+  }
+}
+
+void semrelease(std::atomic<uint32_t>& sema, uint32_t n) {
+  sema.fetch_add(n);
+  sema.notify_all();
+}
+
+}  // namespace
 
 void wait_group::add(long n) {
-  std::unique_lock lock{mutex_};
-  state_ += n;
-  if (state_ < 0) {
+  auto delta = static_cast<uint64_t>(n) << 32;
+  auto state = state_.fetch_add(delta) + delta;
+  auto v = static_cast<int32_t>(state >> 32);
+  auto w = static_cast<uint32_t>(state);
+  if (v < 0) {
     throw std::logic_error{"negative counter"};
   }
-  if (state_ == 0) {
-    lock.unlock();
-    cond_.notify_all();
+  if (w != 0 && n > 0 && v == n) {
+    throw std::logic_error{"add called concurrently with wait"};
+  }
+  if (v > 0 || w == 0) {
+    return;
+  }
+  // The counter is zero and there are waiters. Nothing else may modify the
+  // state now: add must not race with wait, and wait does not increment the
+  // waiters when it sees a zero counter.
+  if (state_.load() != state) {
+    throw std::logic_error{"add called concurrently with wait"};
   }
+  state_.store(0);
+  semrelease(sema_, w);
 }
 
 void wait_group::done() {
@@ -25,9 +59,18 @@ void wait_group::done() {
 }
 
 void wait_group::wait() {
-  std::unique_lock lock{mutex_};
-  if (state_ > 0) {
-    cond_.wait(lock, [this]() { return state_ == 0; });
+  auto state = state_.load();
+  for (;;) {
+    if ((state >> 32) == 0) {
+      return;
+    }
+    if (state_.compare_exchange_weak(state, state+1)) {
+      semacquire(sema_);
+      if (state_.load() != 0) {
+        throw std::logic_error{"wait group is reused before previous wait has returned"};
+      }
+      return;
+    }
   }
 }
 
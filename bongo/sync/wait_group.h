@@ -2,8 +2,8 @@
 
 #pragma once
 
-#include <condition_variable>
-#include <mutex>
+#include <atomic>
+#include <cstdint>
 
 namespace bongo::sync {
 
@@ -13,15 +13,15 @@ namespace bongo::sync {
  * - https://golang.org/pkg/sync/#WaitGroup
  */
 class wait_group {
-  std::mutex mutex_;
-  std::condition_variable cond_;
-  long state_;
+  // High 32 bits are the counter, low 32 bits are the waiter count.
+  std::atomic<uint64_t> state_;
+  std::atomic<uint32_t> sema_ = 0;
 
  public:
   wait_group()
       : wait_group{0} {}
   wait_group(long n)
-      : state_{n} {}
+      : state_{static_cast<uint64_t>(n) << 32} {}
 
   void add(long n);
   void done();
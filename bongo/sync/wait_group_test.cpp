@@ -1,5 +1,7 @@
 // Copyright The Go Authors.
 
+#include <atomic>
+#include <barrier>
 #include <thread>
 #include <vector>
 
@@ -64,4 +66,63 @@ TEST_CASE("Wait group misuse", "[sync]") {
   }(), std::logic_error);
 }
 
+TEST_CASE("Wait group with initial count", "[sync]") {
+  auto wg = wait_group{4};
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 4; ++i) {
+    threads.emplace_back([&]() { wg.done(); });
+  }
+  wg.wait();
+  for (auto& t : threads) {
+    t.join();
+  }
+  CHECK_THROWS_AS(wg.done(), std::logic_error);
+}
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+TEST_CASE("Wait group benchmarks", "[!benchmark]") {
+  BENCHMARK_ADVANCED("Uncontended add/done")(Catch::Benchmark::Chronometer meter) {
+    auto wg = wait_group{};
+    meter.measure([&]() {
+      wg.add(1);
+      wg.done();
+    });
+  };
+
+  BENCHMARK_ADVANCED("Contended done (64 threads)")(Catch::Benchmark::Chronometer meter) {
+    constexpr size_t nthreads = 64;
+    constexpr long ndone = 1000;
+    auto wg = wait_group{};
+    auto stop = std::atomic_bool{false};
+    auto start = std::barrier{nthreads+1};
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < nthreads; ++i) {
+      threads.emplace_back([&]() {
+        for (;;) {
+          start.arrive_and_wait();
+          if (stop.load()) {
+            return;
+          }
+          for (long j = 0; j < ndone; ++j) {
+            wg.done();
+          }
+        }
+      });
+    }
+    meter.measure([&]() {
+      wg.add(nthreads*ndone);
+      start.arrive_and_wait();
+      wg.wait();
+    });
+    stop.store(true);
+    start.arrive_and_wait();
+    for (auto& t : threads) {
+      t.join();
+    }
+  };
+}
+
+#endif  // defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
 }  // namespace bongo::sync
@@ -3,4 +3,5 @@
 #pragma once
 
 #include <bongo/syscall/exec_unix.h>
+#include <bongo/syscall/syscall_linux.h>
 #include <bongo/syscall/syscall_unix.h>
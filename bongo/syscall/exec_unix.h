@@ -7,7 +7,10 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <cstdint>
+#include <span>
 #include <system_error>
+#include <utility>
 
 #include <bongo/bongo.h>
 
@@ -40,6 +43,30 @@ inline auto close(int fd) noexcept -> std::error_code {
   return nil;
 }
 
+inline auto read(int fd, std::span<uint8_t> p) noexcept -> std::pair<long, std::error_code> {
+  auto r0 = ::read(fd, p.data(), p.size());
+  if (r0 == -1) {
+    return {-1, std::error_code{errno, std::system_category()}};
+  }
+  return {r0, nil};
+}
+
+inline auto write(int fd, std::span<uint8_t const> p) noexcept -> std::pair<long, std::error_code> {
+  auto r0 = ::write(fd, p.data(), p.size());
+  if (r0 == -1) {
+    return {-1, std::error_code{errno, std::system_category()}};
+  }
+  return {r0, nil};
+}
+
+inline auto pipe2(int p[2], int flags) noexcept -> std::error_code {
+  auto r0 = ::pipe2(p, flags);
+  if (r0 == -1) {
+    return std::error_code{errno, std::system_category()};
+  }
+  return nil;
+}
+
 inline auto fstat(int fd, struct ::stat* s) -> std::error_code {
   auto r0 = ::fstat(fd, s);
   if (r0 == -1) {
@@ -48,6 +75,22 @@ inline auto fstat(int fd, struct ::stat* s) -> std::error_code {
   return nil;
 }
 
+inline auto fsync(int fd) noexcept -> std::error_code {
+  auto r0 = ::fsync(fd);
+  if (r0 == -1) {
+    return std::error_code{errno, std::system_category()};
+  }
+  return nil;
+}
+
+inline auto ftruncate(int fd, int64_t size) noexcept -> std::error_code {
+  auto r0 = ::ftruncate(fd, size);
+  if (r0 == -1) {
+    return std::error_code{errno, std::system_category()};
+  }
+  return nil;
+}
+
 inline auto close_on_exec(int fd) noexcept -> std::pair<int, std::error_code> {
   return detail::fcntl(fd, F_SETFD, FD_CLOEXEC);
 }
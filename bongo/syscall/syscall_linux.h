@@ -0,0 +1,166 @@
+// Copyright The Go Authors.
+
+#pragma once
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <span>
+#include <system_error>
+#include <utility>
+
+#include <bongo/bongo.h>
+
+namespace bongo::syscall {
+
+inline auto pread(int fd, std::span<uint8_t> p, int64_t offset) noexcept -> std::pair<long, std::error_code> {
+  auto r0 = ::pread(fd, p.data(), p.size(), offset);
+  if (r0 == -1) {
+    return {-1, std::error_code{errno, std::system_category()}};
+  }
+  return {r0, nil};
+}
+
+inline auto pwrite(int fd, std::span<uint8_t const> p, int64_t offset) noexcept -> std::pair<long, std::error_code> {
+  auto r0 = ::pwrite(fd, p.data(), p.size(), offset);
+  if (r0 == -1) {
+    return {-1, std::error_code{errno, std::system_category()}};
+  }
+  return {r0, nil};
+}
+
+inline auto seek(int fd, int64_t offset, int whence) noexcept -> std::pair<int64_t, std::error_code> {
+  auto r0 = ::lseek(fd, offset, whence);
+  if (r0 == -1) {
+    return {-1, std::error_code{errno, std::system_category()}};
+  }
+  return {r0, nil};
+}
+
+inline auto readv(int fd, std::span<struct ::iovec const> iovs) noexcept -> std::pair<long, std::error_code> {
+  auto r0 = ::readv(fd, iovs.data(), static_cast<int>(iovs.size()));
+  if (r0 == -1) {
+    return {-1, std::error_code{errno, std::system_category()}};
+  }
+  return {r0, nil};
+}
+
+inline auto writev(int fd, std::span<struct ::iovec const> iovs) noexcept -> std::pair<long, std::error_code> {
+  auto r0 = ::writev(fd, iovs.data(), static_cast<int>(iovs.size()));
+  if (r0 == -1) {
+    return {-1, std::error_code{errno, std::system_category()}};
+  }
+  return {r0, nil};
+}
+
+inline auto accept4(int fd, struct ::sockaddr_storage* rsa, int flags) noexcept -> std::pair<int, std::error_code> {
+  auto len = static_cast<::socklen_t>(rsa != nullptr ? sizeof *rsa : 0);
+  auto r0 = ::accept4(fd, reinterpret_cast<struct ::sockaddr*>(rsa), rsa != nullptr ? &len : nullptr, flags);
+  if (r0 == -1) {
+    return {-1, std::error_code{errno, std::system_category()}};
+  }
+  return {r0, nil};
+}
+
+inline auto recvmsg(int fd, struct ::msghdr* msg, int flags) noexcept -> std::pair<long, std::error_code> {
+  auto r0 = ::recvmsg(fd, msg, flags);
+  if (r0 == -1) {
+    return {-1, std::error_code{errno, std::system_category()}};
+  }
+  return {r0, nil};
+}
+
+inline auto sendmsg(int fd, struct ::msghdr const* msg, int flags) noexcept -> std::pair<long, std::error_code> {
+  auto r0 = ::sendmsg(fd, msg, flags);
+  if (r0 == -1) {
+    return {-1, std::error_code{errno, std::system_category()}};
+  }
+  return {r0, nil};
+}
+
+inline auto recvmmsg(int fd, std::span<struct ::mmsghdr> msgs, int flags) noexcept -> std::pair<long, std::error_code> {
+  auto r0 = ::recvmmsg(fd, msgs.data(), static_cast<unsigned>(msgs.size()), flags, nullptr);
+  if (r0 == -1) {
+    return {-1, std::error_code{errno, std::system_category()}};
+  }
+  return {r0, nil};
+}
+
+inline auto sendmmsg(int fd, std::span<struct ::mmsghdr> msgs, int flags) noexcept -> std::pair<long, std::error_code> {
+  auto r0 = ::sendmmsg(fd, msgs.data(), static_cast<unsigned>(msgs.size()), flags);
+  if (r0 == -1) {
+    return {-1, std::error_code{errno, std::system_category()}};
+  }
+  return {r0, nil};
+}
+
+inline auto copy_file_range(int rfd, int wfd, long len) noexcept -> std::pair<long, std::error_code> {
+  auto r0 = ::copy_file_range(rfd, nullptr, wfd, nullptr, len, 0);
+  if (r0 == -1) {
+    return {-1, std::error_code{errno, std::system_category()}};
+  }
+  return {r0, nil};
+}
+
+inline auto sendfile(int outfd, int infd, long count) noexcept -> std::pair<long, std::error_code> {
+  auto r0 = ::sendfile(outfd, infd, nullptr, count);
+  if (r0 == -1) {
+    return {-1, std::error_code{errno, std::system_category()}};
+  }
+  return {r0, nil};
+}
+
+inline auto splice(int rfd, int wfd, long len, unsigned flags) noexcept -> std::pair<long, std::error_code> {
+  auto r0 = ::splice(rfd, nullptr, wfd, nullptr, len, flags);
+  if (r0 == -1) {
+    return {-1, std::error_code{errno, std::system_category()}};
+  }
+  return {r0, nil};
+}
+
+inline auto getdents(int fd, std::span<uint8_t> buf) noexcept -> std::pair<long, std::error_code> {
+  auto r0 = ::getdents64(fd, buf.data(), buf.size());
+  if (r0 == -1) {
+    return {-1, std::error_code{errno, std::system_category()}};
+  }
+  return {r0, nil};
+}
+
+inline auto fadvise(int fd, int64_t offset, int64_t len, int advice) noexcept -> std::error_code {
+  auto r0 = ::posix_fadvise(fd, offset, len, advice);
+  if (r0 != 0) {
+    return std::error_code{r0, std::system_category()};
+  }
+  return nil;
+}
+
+inline auto readahead(int fd, int64_t offset, long count) noexcept -> std::error_code {
+  auto r0 = ::readahead(fd, offset, count);
+  if (r0 == -1) {
+    return std::error_code{errno, std::system_category()};
+  }
+  return nil;
+}
+
+inline auto shutdown(int fd, int how) noexcept -> std::error_code {
+  auto r0 = ::shutdown(fd, how);
+  if (r0 == -1) {
+    return std::error_code{errno, std::system_category()};
+  }
+  return nil;
+}
+
+inline auto setsockopt_int(int fd, int level, int opt, int value) noexcept -> std::error_code {
+  auto r0 = ::setsockopt(fd, level, opt, &value, sizeof value);
+  if (r0 == -1) {
+    return std::error_code{errno, std::system_category()};
+  }
+  return nil;
+}
+
+}  // namespace bongo::syscall
@@ -1,7 +1,7 @@
 /*
- * The [WaitGroup][] type from the [sync][] package is implemented. This is a
- * naive implementation using a mutex and a condition variable. A possible
- * future improvement might use a lockless algorithm.
+ * The [WaitGroup][] type from the [sync][] package is implemented. Like Go,
+ * the counter and the number of waiters share a single atomic word so add and
+ * done are lock-free, and waiters park using atomic wait/notify.
  *
  * This example is somewhat pointless since joining the threads accomplishes
  * the same result, however it illustrates how a wait group might be used, for